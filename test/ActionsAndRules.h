@@ -2,7 +2,7 @@
 #define ACTIONSANDRULES_H
 ///////////////////////////////////////////////////////////////
 // ActionsAndRules.h                                         //
-// Ver 2.0                                                   //
+// Ver 3.2                                                   //
 // Language:    Visual C++ 2012                              //
 // Platform:    Dell E6510, Windows 7                        //
 // Application: CSE687 - OOD, Pr#2, Spring 2013              //
@@ -23,6 +23,12 @@ Parser, SemiExpression, and Tokenizer, are intended to be reusable
 without change.  This module provides a place to put extensions of
 these facilities and is not expected to be reusable. 
 
+Each rule's test, and each action, is a member template on the token
+collection type.  doTest() and doAction() call them with an
+ITokCollection, for the dynamic Parser, and a StaticParser calls them
+with a concrete SemiExp, so the compiler can inline them.  Rules and
+actions used by a StaticParser can all be made from a Repository*.
+
 Public Interface:
 =================
 Toker t(someFile);              // create tokenizer instance
@@ -48,6 +54,43 @@ semiexpression.cpp tokenizer.cpp /link setargv.obj
 
 Maintenance History:
 ====================
+ver 3.2 : 17 Oct 26
+- commented out tests are left as they were, not ported to TokIds
+ver 3.1 : 17 Oct 26
+- deferred rules test the conditions they share with their base rules
+with the bases' isDeclaration(), isCallInFunction() and
+isFunctionDeclaration(), and use the bases' protected p_Repos instead
+of shadowing it
+ver 3.0 : 17 Oct 26
+- PrintInheritance and DeferInheritance find the inherited type with
+InheritanceOpportunity::inheritedTypePos()
+ver 2.9 : 17 Oct 26
+- rules read the scope stack's size() and top() instead of copying
+the stack, and an element's type is a view of a string literal
+ver 2.8 : 17 Oct 26
+- keyword tests classify token ids with tokenKind() instead of
+comparing the token with lists of keyword strings
+ver 2.7 : 17 Oct 26
+- actions add types and relationships through the Repository, which
+may log them in a FileEffects instead of changing the graph
+ver 2.6 : 17 Oct 26
+- added deferred pass 2 rules and actions, which record TypeRefs
+during pass 1 instead of looking types up
+ver 2.5 : 17 Oct 26
+- rule tests and actions are member templates on the collection type,
+called by doTest() and doAction(), and usable by a StaticParser
+ver 2.4 : 17 Oct 26
+- rules and actions look up punctuators and keywords in the
+semi-expression's TokSummary instead of scanning it with find()
+ver 2.3 : 17 Oct 26
+- rules declare the tokens they can't match without as triggers, so
+the parser doesn't test them on semi-expressions that lack those
+ver 2.2 : 16 Oct 26
+- rules search for punctuators and keywords by TokId, comparing
+integers instead of strings
+ver 2.1 : 16 Oct 26
+- keyword tests take StrView tokens, so checking a token against
+the keyword lists no longer copies it into a std::string
 ver 2.0 : 01 Jun 11
 - added processing on way to building strong code analyzer
 ver 1.1 : 17 Jan 09
@@ -70,20 +113,23 @@ ver 1.0 : 12 Jan 06
 #include "ScopeStack.h"
 #include "Tokenizer.h"
 #include "SemiExpression.h"
+#include "TokenKind.h"
 #include "GraphSingleton.h"
 #include "SymbolTable.h"
+#include "TypeRefs.h"
+#include "FileEffects.h"
 
 using namespace GraphLib;
 
-typedef GraphLib::Graph<node, std::string> graph;
-typedef GraphLib::Vertex<node, std::string> vertex;
+typedef GraphLib::Graph<node, RelKind> graph;
+typedef GraphLib::Vertex<node, RelKind> vertex;
 
 ///////////////////////////////////////////////////////////////
 // ScopeStack element is application specific
 
 struct element
 {
-	std::string type;
+	StrView type;              // kind of scope, always a string literal
 	std::string name;
 	size_t lineCount;
 	std::string show()
@@ -102,17 +148,56 @@ struct element
 
 ///////////////////////////////////////////////////////////////
 // Repository instance is used to share resources
-// among all actions.
+// among all actions.  Actions change the graph through it, so
+// a ParserPool worker's Repository can log the changes in a
+// FileEffects, for the pool to apply in file order.
 
 class Repository  // application specific
 {
 	ScopeStack<element> stack;
 	Toker* p_Toker;
 	SymbolTable symb;
+	FileEffects* p_Effects;
 public:
 	Repository(Toker* pToker)
 	{
 		p_Toker = pToker;
+		p_Effects = 0;
+	}
+	void logTo(FileEffects* pEffects)  // 0 changes the graph directly
+	{
+		p_Effects = pEffects;
+	}
+	std::string currentFile()  // graph name of the file being parsed
+	{
+		if(p_Effects)
+			return p_Effects->file();
+		GraphSingleton *s = GraphSingleton::getInstance();
+		return s->reducePathFileToFileNamePrefix(s->getCurrentFilename());
+	}
+	bool isNewType(const TypeName& name)
+	{
+		if(symb.containsType(name))
+			return false;
+		if(p_Effects)
+			p_Effects->assumeNewType(name);
+		return true;
+	}
+	void addType(const TypeName& name)  // defined in the current file
+	{
+		std::string file = currentFile();
+		if(p_Effects)
+			p_Effects->addType(name, file);
+		else
+			GraphSingleton::getInstance()->addTypeToGraph(file);
+		symb.Add(name, "TBD", file);
+	}
+	void addRelationship(const std::string& parent, const std::string& child, const std::string& relationship)
+	{
+		if(p_Effects)
+			p_Effects->addRelationship(parent, child, relationship);
+		else
+			GraphSingleton::getInstance()->addRelationshipToGraph(parent, child, relationship);
 	}
 	SymbolTable& symbolTable()
 	{
@@ -138,16 +223,25 @@ public:
 class BeginningOfScope : public IRule
 {
 public:
-	bool doTest(ITokCollection*& pTc)
+	BeginningOfScope(Repository* = 0)
+	{
+		addTrigger(tok_lbrace);
+	}
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
+		const TokSummary& ts = tc.summary();
 		//std::cout << "\n--BeginningOfScope rule";
-		if(pTc->find("{") < pTc->length())
+		if(ts.first(tok_lbrace) < tc.length())
 		{
-			doActions(pTc);
+			act.act(tc);
 			return false;
 		}
 		return false;
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -161,7 +255,7 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
 
 		element elem;
@@ -170,6 +264,10 @@ public:
 		elem.lineCount = p_Repos->lineCount();
 		p_Repos->scopeStack().push(elem);
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -178,16 +276,25 @@ public:
 class EndOfScope : public IRule
 {
 public:
-	bool doTest(ITokCollection*& pTc)
+	EndOfScope(Repository* = 0)
+	{
+		addTrigger(tok_rbrace);
+	}
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
+		const TokSummary& ts = tc.summary();
 		//std::cout << "\n--EndOfScope rule";
-		if(pTc->find("}") < pTc->length())
+		if(ts.first(tok_rbrace) < tc.length())
 		{
-			doActions(pTc);
+			act.act(tc);
 			return false;
 		}
 		return false;
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -201,12 +308,16 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
 		if(p_Repos->scopeStack().size() == 0)
 			return;
 		element elem = p_Repos->scopeStack().pop();
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -216,67 +327,61 @@ public:
 
 class VarDeclaration : public IRule
 {
+	TokSet specialKeys;   // pre C++11 keywords, braces and #
 
+protected:
 	Repository* p_Repos;
 
-
 public:
 	VarDeclaration(Repository* pRepos)
 	{
 		p_Repos = pRepos;
+		specialKeys = tokensOfKind(tk_keyword) & ~tokensOfKind(tk_cpp11);
+		specialKeys.set(tok_lbrace).set(tok_rbrace).set(tok_hash);
 	}
 
-	bool isSpecialKeyWord(const std::string& tok)
+	template<class TC> bool containsSpecialKeyword(TC& tc)
 	{
-		const static std::string keys[]
-		= { "asm", "auto", "bool", "break", "case", "catch", "char", "class", "const", "const_cast", 
-			"continue", "default", "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", 
-			"export", "extern", "false", "float", "for", "friend", "goto", "if", "inline", "int", "long", 
-			"mutable", "namespace", "new", "operator", "private", "protected", "public", "register", 
-			"reinterpret_cast", "return", "short", "signed", "sizeof", "static", "static_cast", "struct", 
-			"switch", "template", "this", "throw", "true", "try", "typedef", "typeid", "typename", "union", 
-			"unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "}", "{", "#"	};
-		for(int i=0; i<(sizeof(keys) / sizeof(keys[0])); ++i)
-			if(tok == keys[i])
-				return true;
-		return false;
+		return (tc.summary().present() & specialKeys).any();
 	}
 
-	bool containsSpecialKeyword(ITokCollection& tc)
+protected:
+	// a declaration in some scope, whatever its first token names
+
+	template<class TC> bool isDeclaration(TC& tc)
 	{
-		for (int i=0;i<(int)tc.length();i++)
-			if (isSpecialKeyWord(tc[i]))
-				return true;
+		const TokSummary& ts = tc.summary();
+		size_t len = ts.first(tok_lbrace);
+		if (ts.first(tok_lineComment) == tc.length())
+		{
+			if ((tc.length() == len) && (tc.length() > 2) && (!containsSpecialKeyword(tc)))
+			{
+				if (p_Repos->scopeStack().size() > 0)
+					return ts.first(tok_assign) > 1;
+			}
+		}
 		return false;
 	}
 
 public:
 
-	bool doTest(ITokCollection*& pTc)
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
-		ITokCollection& tc = *pTc;
-		size_t len = tc.find("{");
-		if (tc.find("//") == tc.length())
+		if (isDeclaration(tc))
 		{
-			if ((tc.length() == len) && (tc.length() > 2) && (!containsSpecialKeyword(tc)))
+			if ( (p_Repos->symbolTable().containsType(tc[0])) && (tc[1] != "("))
 			{
-				ScopeStack<element> tempStack = p_Repos->scopeStack();
-				if (tempStack.size() > 0)
-				{
-					if (tc.find("=") > 1)
-					{
-						if ( (p_Repos->symbolTable().containsType(tc[0])) && (tc[1] != "("))
-						{
-							//std::cout << "\n--VarDeclaration rule";
-							doActions(pTc);
-							return true;
-						}
-					}
-				}
+				//std::cout << "\n--VarDeclaration rule";
+				act.act(tc);
+				return true;
 			}
 		}
 		return false;	
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -292,23 +397,24 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
-		ScopeStack<element> tempStack = p_Repos->scopeStack();
-		std::string typeName = (*pTc)[0];
+		std::string typeName = tc[0];
 		if (p_Repos->symbolTable().containsType(typeName))
 		{
 			std::cout << "  Rule 3.a: Found var of type: " << typeName << "\n";
 
 			// Add the edge to the graph if the path of the type != the path of the instance
-			GraphSingleton *s;
-			s = GraphSingleton::getInstance();
 
 			std::string child = p_Repos->symbolTable().lookUpFile(typeName,"TBD");
-			std::string parent = s->reducePathFileToFileNamePrefix(s->getCurrentFilename());
-			s->addRelationshipToGraph(parent, child, "variable");
+			std::string parent = p_Repos->currentFile();
+			p_Repos->addRelationship(parent, child, "variable");
 		}
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 
@@ -324,32 +430,42 @@ public:
 	ReturnType(Repository* pRepos)
 	{
 		p_Repos = pRepos;
+		addTrigger(tok_lparen);
+	}
+	// an open paren, and no semicolon: a function declaration
+
+	template<class TC> static bool isFunctionDeclaration(TC& tc)
+	{
+		const TokSummary& ts = tc.summary();
+		if (ts.first(tok_lparen) < tc.length()) // if token collection contains an open paren
+			return ts.first(tok_semicolon) == tc.length(); // and token collection doesn't contain a semicolon
+		return false;
 	}
 
 public:
 
-	bool doTest(ITokCollection*& pTc)
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
-		ITokCollection& tc = *pTc;
-		size_t len = tc.find("(");
-		if (len < tc.length()) // if token collection contains an open paren
+		size_t len = tc.summary().first(tok_lparen);
+		if (isFunctionDeclaration(tc))
 		{
-			if (tc.find(";") == tc.length()) // and token collection doesn't contain a semicolon (is a function declaration)
+			if (len >= 2)
 			{
-				if (len >= 2)
+				if ( p_Repos->symbolTable().containsType(tc[len - 2]) ) // Is the return type in the symbolTable?
 				{
-					if ( p_Repos->symbolTable().containsType(tc[tc.find("(") - 2]) ) // Is the return type in the symbolTable?
-					{
-						//std::cout << "Found a return type from a function declaration in the SymbolTable\n";
-						//std::cout << "\n--VarDeclaration rule";
-						doActions(pTc);
-						return true;
-					}
+					//std::cout << "Found a return type from a function declaration in the SymbolTable\n";
+					//std::cout << "\n--VarDeclaration rule";
+					act.act(tc);
+					return true;
 				}
 			}
 		}
 		return false;	
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -365,24 +481,24 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
-		ScopeStack<element> tempStack = p_Repos->scopeStack();
-		std::string funName = (*pTc)[pTc->find("(") - 1];
+		const TokSummary& ts = tc.summary();
+		std::string funName = tc[ts.first(tok_lparen) - 1];
 		bool foundRetType = false;
-		if (pTc->find("::") < pTc->length()) // Scope resolution operator is present
+		if (ts.first(tok_scope) < tc.length()) // Scope resolution operator is present
 		{
-			if (pTc->find("::") > 1)
+			if (ts.first(tok_scope) > 1)
 			{
-				funName = (*pTc)[pTc->find("::") - 2]; 
+				funName = tc[ts.first(tok_scope) - 2]; 
 				foundRetType = true;
 			}
 		}
-		else if (pTc->find("(") < pTc->length())
+		else if (ts.first(tok_lparen) < tc.length())
 		{
-			if (pTc->find("(") > 1)
+			if (ts.first(tok_lparen) > 1)
 			{
-				funName = (*pTc)[pTc->find("(") - 2]; 
+				funName = tc[ts.first(tok_lparen) - 2]; 
 				foundRetType = true;
 			}
 		}
@@ -393,14 +509,16 @@ public:
 			{
 				std::cout << "  Rule 3.b: return type: " << funName << "\n";
 				// Add the edge to the graph if the path of the type != the path of the instance
-				GraphSingleton *s;
-				s = GraphSingleton::getInstance();
 				std::string child = p_Repos->symbolTable().lookUpFile(funName,"TBD");
-				std::string parent = s->reducePathFileToFileNamePrefix(s->getCurrentFilename());
-				s->addRelationshipToGraph(parent, child, "retType");
+				std::string parent = p_Repos->currentFile();
+				p_Repos->addRelationship(parent, child, "retType");
 			}
 		}
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -414,33 +532,32 @@ public:
 	CallingParam(Repository* pRepos)
 	{
 		p_Repos = pRepos;
+		addTrigger(tok_lparen);
 	}
 
 public:
 
-	bool doTest(ITokCollection*& pTc)
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
-		ITokCollection& tc = *pTc;
-		size_t len = tc.find("(");
-		if (len < tc.length()) // if token collection contains an open paren
+		if (ReturnType::isFunctionDeclaration(tc))
 		{
-			if (tc.find(";") == tc.length()) // and token collection doesn't contain a semicolon (is a function declaration)
+			for (size_t i=tc.summary().first(tok_lparen)+1;i<tc.length();i++)
 			{
-
-				for (size_t i=tc.find("(")+1;i<tc.length();i++)
+				if (p_Repos->symbolTable().containsType(tc[i])) // Look through the token collection for a match in the symbolTable
 				{
-					if (p_Repos->symbolTable().containsType(tc[i])) // Look through the token collection for a match in the symbolTable
-					{
-						std::cout << "Found a calling param from a function declaration in the SymbolTable\n";
-						//std::cout << "\n--VarDeclaration rule";
-						doActions(pTc);
-						return true;
-					}
+					std::cout << "Found a calling param from a function declaration in the SymbolTable\n";
+					//std::cout << "\n--VarDeclaration rule";
+					act.act(tc);
+					return true;
 				}
 			}
 		}
 		return false;	
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -456,24 +573,24 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
-		ScopeStack<element> tempStack = p_Repos->scopeStack();
-		std::string funName = (*pTc)[pTc->find("(") - 1];
+		const TokSummary& ts = tc.summary();
+		std::string funName = tc[ts.first(tok_lparen) - 1];
 		bool foundRetType = false;
 
-		if (pTc->find("(") < pTc->length())
+		if (ts.first(tok_lparen) < tc.length())
 		{
-			if (pTc->find("(") > 1) 
+			if (ts.first(tok_lparen) > 1) 
 			{// look in here for calling parameters
 
-				for (size_t i=pTc->find("(")+1;i<pTc->length();i++)
+				for (size_t i=ts.first(tok_lparen)+1;i<tc.length();i++)
 				{
-					if (p_Repos->symbolTable().containsType((*pTc)[i])) // Look through the token collection for a match in the symbolTable
+					if (p_Repos->symbolTable().containsType(tc[i])) // Look through the token collection for a match in the symbolTable
 					{
 						std::cout << "Found a calling param from a function declaration in the SymbolTable\n";
 						//std::cout << "\n--VarDeclaration rule";
-						funName = (*pTc)[i]; 
+						funName = tc[i]; 
 						foundRetType = true;
 					}
 				}
@@ -486,15 +603,17 @@ public:
 			{
 				std::cout << "  Rule 3.b: calling parameter: " << funName << "\n";
 				// Add the edge to the graph if the path of the type != the path of the instance
-				GraphSingleton *s;
-				s = GraphSingleton::getInstance();
 				std::string child = p_Repos->symbolTable().lookUpFile(funName,"TBD");
-				std::string parent = s->reducePathFileToFileNamePrefix(s->getCurrentFilename());
-				s->addRelationshipToGraph(parent, child, "param");
+				std::string parent = p_Repos->currentFile();
+				p_Repos->addRelationship(parent, child, "param");
 			}
 		}
 
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -503,23 +622,48 @@ public:
 class InheritanceOpportunity : public IRule
 {
 public:
-	bool doTest(ITokCollection*& pTc)
+	InheritanceOpportunity(Repository* = 0)
 	{
-		ITokCollection& tc = *pTc;
-		if(tc[tc.length()-1] == "{")
+		addTrigger(tok_lbrace);
+		addTrigger(tok_class);
+		addTrigger(tok_colon);
+	}
+	template<class TC, class Act> bool test(TC& tc, Act& act)
+	{
+		const TokSummary& ts = tc.summary();
+		if(tc.id(tc.length()-1) == tok_lbrace)
 		{
-			size_t keyPos1 = tc.find("{");
-			size_t keyPos2 = tc.find("class");
-			size_t keyPos3 = tc.find(":");
+			size_t keyPos1 = ts.first(tok_lbrace);
+			size_t keyPos2 = ts.first(tok_class);
+			size_t keyPos3 = ts.first(tok_colon);
 			if ((keyPos1 < tc.length()) && (keyPos2 < tc.length()) && (keyPos3 < tc.length()))
 			{
 				//std::cout << "\n--Inheritance Relationship rule";
-				doActions(pTc);
+				act.act(tc);
 				return true;
 			}
 		}
 		return false;
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
+	// position of the inherited type's name, the token before '{',
+	// or next to the newline there
+
+	template<class TC> static size_t inheritedTypePos(TC& tc)
+	{
+		size_t posInherits = tc.summary().first(tok_lbrace) - 1;
+		if (tc[posInherits] == "\n")
+		{
+			if (tc[posInherits+1] == "}")
+				posInherits++;
+			else
+				posInherits--;
+		}
+		return posInherits;
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -534,38 +678,31 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
-
-		ScopeStack<element> tempStack = p_Repos->scopeStack();
+		const TokSummary& ts = tc.summary();
 
 		if(p_Repos->scopeStack().size() == 0)
 			return;
-		element elem = p_Repos->scopeStack().pop();
-		p_Repos->scopeStack().push(elem);  // leaves the scopeStack uneffected
 
-		ITokCollection& tc = *pTc;
-		size_t posInheritor = tc.find("class") > tc.find("struct") ? tc.find("struct") + 1 : tc.find("class") + 1;
-		size_t posInherits = tc.find("{") - 1; 
-		if (tc[posInherits] == "\n")
-			if (tc[posInherits+1] == "}")
-				posInherits++;
-			else
-				posInherits--;
+		size_t posInheritor = ts.first(tok_class) > ts.first(tok_struct) ? ts.first(tok_struct) + 1 : ts.first(tok_class) + 1;
+		size_t posInherits = InheritanceOpportunity::inheritedTypePos(tc);
 
-		std::string typeName = (*pTc)[0];
+		std::string typeName = tc[0];
 		if (p_Repos->symbolTable().containsType(tc[posInherits]))
 		{
 			std::cout << "  Rule 3.c: Found " << tc[posInheritor] << " inheriting type: " << tc[posInherits] << "\n";
 
 			// Add the edge to the graph if the path of the type != the path of the instance
-			GraphSingleton *s;
-			s = GraphSingleton::getInstance();
 			std::string parent = p_Repos->symbolTable().lookUpFile(tc[posInherits],"TBD");
-			std::string child = s->reducePathFileToFileNamePrefix(s->getCurrentFilename());
-			s->addRelationshipToGraph(parent, child, "inherits");			
+			std::string child = p_Repos->currentFile();
+			p_Repos->addRelationship(parent, child, "inherits");			
 		}
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -573,36 +710,48 @@ public:
 
 class GlobalFuncCall : public IRule
 {
+protected:
 	Repository* p_Repos;
 
+	// a statement with a call, in a function
+
+	template<class TC> bool isCallInFunction(TC& tc)
+	{
+		const TokSummary& ts = tc.summary();
+		if (ts.first(tok_lparen) < tc.length()) // if token collection contains an open paren
+			if (ts.first(tok_semicolon) < tc.length()) // and token collection ends with a semicolon
+				if (p_Repos->scopeStack().size() > 0)
+					return p_Repos->scopeStack().top().type == "function";	// and inside function scope
+		return false;
+	}
+
 public:
 	GlobalFuncCall(Repository* pRepos)
 	{
 		p_Repos = pRepos;
+		addTrigger(tok_lparen);
+		addTrigger(tok_semicolon);
 	}
 
 public:
 
-	bool doTest(ITokCollection*& pTc)
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
-		ITokCollection& tc = *pTc;
-		size_t len = tc.find("(");
-
-		if (len < tc.length()) // if token collection contains an open paren
-			if (tc.find(";") < tc.length()) // and token collection ends with a semicolon
+		if (isCallInFunction(tc))
+		{
+			size_t len = tc.summary().first(tok_lparen);
+			if ( p_Repos->symbolTable().containsType(tc[len-1]) ) // Look for the global variable name
 			{
-				ScopeStack<element> tempStack = p_Repos->scopeStack();
-				if (tempStack.size() > 0)			
-					if (tempStack.pop().type == "function")		// and inside function scope				
-						if ( p_Repos->symbolTable().containsType(tc[len-1]) ) // Look for the global variable name
-						{
-							//std::cout << "\n--VarDeclaration rule";
-							doActions(pTc);
-							return true;
-						}
-
+				//std::cout << "\n--VarDeclaration rule";
+				act.act(tc);
+				return true;
 			}
-			return false;	
+		}
+		return false;	
+	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
 	}
 
 };
@@ -620,21 +769,23 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
-		ScopeStack<element> tempStack = p_Repos->scopeStack();
-		std::string funName = (*pTc)[pTc->find("(") - 1];
+		const TokSummary& ts = tc.summary();
+		std::string funName = tc[ts.first(tok_lparen) - 1];
 		if (p_Repos->symbolTable().containsType(funName))
 		{
 			std::cout << "  Rule 3.d: Found global function call: " << funName << "()\n";
 			// Add the edge to the graph if the path of the type != the path of the instance
-			GraphSingleton *s;
-			s = GraphSingleton::getInstance();
 			std::string child = p_Repos->symbolTable().lookUpFile(funName,"TBD");
-			std::string parent = s->reducePathFileToFileNamePrefix(s->getCurrentFilename());
-			s->addRelationshipToGraph(parent, child, "globalFun");
+			std::string parent = p_Repos->currentFile();
+			p_Repos->addRelationship(parent, child, "globalFun");
 		}
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -643,57 +794,44 @@ public:
 class GlobalVarDeclaration : public IRule
 {
 	Repository* p_Repos;
+	TokSet specialKeys;   // pre C++11 keywords, braces and #
 
 public:
 	GlobalVarDeclaration(Repository* pRepos)
 	{
 		p_Repos = pRepos;
+		specialKeys = tokensOfKind(tk_keyword) & ~tokensOfKind(tk_cpp11);
+		specialKeys.set(tok_lbrace).set(tok_rbrace).set(tok_hash);
 	}
-	bool isSpecialKeyWord(const std::string& tok)
+	template<class TC> bool containsSpecialKeyword(TC& tc)
 	{
-		const static std::string keys[]
-		= { "asm", "auto", "bool", "break", "case", "catch", "char", "class", "const", "const_cast", 
-			"continue", "default", "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", 
-			"export", "extern", "false", "float", "for", "friend", "goto", "if", "inline", "int", "long", 
-			"mutable", "namespace", "new", "operator", "private", "protected", "public", "register", 
-			"reinterpret_cast", "return", "short", "signed", "sizeof", "static", "static_cast", "struct", 
-			"switch", "template", "this", "throw", "true", "try", "typedef", "typeid", "typename", "union", 
-			"unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "}", "{", "#"	};
-		for(int i=0; i<(sizeof(keys) / sizeof(keys[0])); ++i)
-			if(tok == keys[i])
-				return true;
-		return false;
-	}
-
-	bool containsSpecialKeyword(ITokCollection& tc)
-	{
-		for (int i=0;i<(int)tc.length();i++)
-			if (isSpecialKeyWord(tc[i]))
-				return true;
-		return false;
+		return (tc.summary().present() & specialKeys).any();
 	}
 
 public:
 
-	bool doTest(ITokCollection*& pTc)
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
-		ITokCollection& tc = *pTc;
-		size_t len = tc.find("{");
+		const TokSummary& ts = tc.summary();
+		size_t len = ts.first(tok_lbrace);
 		//if (tc.find("//") == tc.length())
 		{
 			if ((tc.length() == len) && (tc.length() > 2) && (!containsSpecialKeyword(tc)))
 			{
-				ScopeStack<element> tempStack = p_Repos->scopeStack();
-				if (tempStack.size() == 0)
+				if (p_Repos->scopeStack().size() == 0)
 				{
 					//std::cout << "\n--VarDeclaration rule";
-					doActions(pTc);
+					act.act(tc);
 					return true;
 				}
 			}
 		}
 		return false;	
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 
 };
 
@@ -710,33 +848,34 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
-		ScopeStack<element> tempStack = p_Repos->scopeStack();
-
-		std::string typeName = (*pTc)[0];
+		const TokSummary& ts = tc.summary();
+		std::string typeName = tc[0];
 		if (p_Repos->symbolTable().containsType(typeName))
 		{
 			std::cout << "  Rule 3.e: Found Globalvar of type: " << typeName;
 			// If not an assignment, should just be 'type var;'
-			if (pTc->find("=") == (*pTc).length())
+			if (ts.first(tok_assign) == tc.length())
 			{
-				std::string varName = (*pTc)[pTc->find(";") - 1];
+				std::string varName = tc[ts.first(tok_semicolon) - 1];
 				std::cout << " and name:" << varName << "\n";
 			}
 			else
 			{
-				std::string varName = (*pTc)[pTc->find("=") - 1];
+				std::string varName = tc[ts.first(tok_assign) - 1];
 				std::cout << " and name:" << varName << "\n";
 			}
 			// Add the edge to the graph if the path of the type != the path of the instance
-			GraphSingleton *s;
-			s = GraphSingleton::getInstance();
 			std::string child = p_Repos->symbolTable().lookUpFile(typeName,"TBD");
-			std::string parent = s->reducePathFileToFileNamePrefix(s->getCurrentFilename());
-			s->addRelationshipToGraph(parent, child, "globalVar");
+			std::string parent = p_Repos->currentFile();
+			p_Repos->addRelationship(parent, child, "globalVar");
 		}
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 
@@ -744,6 +883,268 @@ public:
 //               End of Pass 2 Classes                       //
 ///////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////
+//               Deferred Pass 2 Classes                     //
+///////////////////////////////////////////////////////////////
+// These parse along with pass 1, on its semi-expressions.  The
+// rules make the pass 2 rules' tests that don't need the symbol
+// table, and the actions record a TypeRef where pass 2 looks a
+// name up, so TypeRefs::resolve() can add the edges once the
+// symbol table is complete.
+
+///////////////////////////////////////////////////////////////
+// base of the actions recording TypeRefs
+
+class DeferTypeRef : public IAction
+{
+protected:
+	Repository* p_Repos;
+	TypeRefs* p_Refs;
+
+public:
+	DeferTypeRef(Repository* pRepos, TypeRefs* pRefs)
+	{
+		p_Repos = pRepos;
+		p_Refs = pRefs;
+	}
+protected:
+	void defer(TypeRef& ref)
+	{
+		ref.file = p_Repos->currentFile();
+		p_Refs->add(ref);
+	}
+};
+
+///////////////////////////////////////////////////////////////
+// Rule 3.a. without the type test
+
+class DeferredVarDeclaration : public VarDeclaration
+{
+public:
+	DeferredVarDeclaration(Repository* pRepos) : VarDeclaration(pRepos) {}
+	template<class TC, class Act> bool test(TC& tc, Act& act)
+	{
+		if (isDeclaration(tc) && (tc[1] != "("))
+		{
+			act.act(tc);
+			return true;
+		}
+		return false;
+	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
+};
+
+///////////////////////////////////////////////////////////////
+// action to record the variable's type
+
+class DeferVarDecl : public DeferTypeRef
+{
+public:
+	DeferVarDecl(Repository* pRepos, TypeRefs* pRefs) : DeferTypeRef(pRepos, pRefs) {}
+	template<class TC> void act(TC& tc)
+	{
+		TypeRef ref("variable");
+		ref.names.push_back(tc[0]);
+		defer(ref);
+	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
+};
+
+///////////////////////////////////////////////////////////////
+// Rule 3.b.i. without the type test
+
+class DeferredReturnType : public ReturnType
+{
+public:
+	DeferredReturnType(Repository* pRepos) : ReturnType(pRepos) {}
+	template<class TC, class Act> bool test(TC& tc, Act& act)
+	{
+		if (isFunctionDeclaration(tc) && (tc.summary().first(tok_lparen) >= 2))
+		{
+			act.act(tc);
+			return true;
+		}
+		return false;
+	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
+};
+
+///////////////////////////////////////////////////////////////
+// action to record the return type, which PushReturnType finds
+// before "::", if present, and the name ReturnType tests
+
+class DeferReturnType : public DeferTypeRef
+{
+public:
+	DeferReturnType(Repository* pRepos, TypeRefs* pRefs) : DeferTypeRef(pRepos, pRefs) {}
+	template<class TC> void act(TC& tc)
+	{
+		const TokSummary& ts = tc.summary();
+		size_t pos = ts.first(tok_scope) < tc.length() ? ts.first(tok_scope) : ts.first(tok_lparen);
+		if (pos > 1)
+		{
+			TypeRef ref("retType");
+			ref.names.push_back(tc[ts.first(tok_lparen) - 2]);
+			ref.names.push_back(tc[pos - 2]);
+			defer(ref);
+		}
+	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
+};
+
+///////////////////////////////////////////////////////////////
+// Rule 3.b.ii without the type test
+
+class DeferredCallingParam : public CallingParam
+{
+public:
+	DeferredCallingParam(Repository* pRepos) : CallingParam(pRepos) {}
+	template<class TC, class Act> bool test(TC& tc, Act& act)
+	{
+		if (ReturnType::isFunctionDeclaration(tc) && (tc.summary().first(tok_lparen) + 1 < tc.length()))
+		{
+			act.act(tc);
+			return true;
+		}
+		return false;
+	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
+};
+
+///////////////////////////////////////////////////////////////
+// action to record the names following "(", of which
+// PushCallingParam relates the file to the last type
+
+class DeferCallingParam : public DeferTypeRef
+{
+public:
+	DeferCallingParam(Repository* pRepos, TypeRefs* pRefs) : DeferTypeRef(pRepos, pRefs) {}
+	template<class TC> void act(TC& tc)
+	{
+		size_t lp = tc.summary().first(tok_lparen);
+		if (lp == 1)
+			return;
+		TypeRef ref("param", TypeRef::lastType);
+		ref.throws = (lp == 0);  // PushCallingParam reads tc[lp - 1]
+		for (size_t i=lp+1; i<tc.length(); i++)
+			ref.names.push_back(tc[i]);
+		defer(ref);
+	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
+};
+
+///////////////////////////////////////////////////////////////
+// action to record the inherited type, with InheritanceOpportunity
+
+class DeferInheritance : public DeferTypeRef
+{
+public:
+	DeferInheritance(Repository* pRepos, TypeRefs* pRefs) : DeferTypeRef(pRepos, pRefs) {}
+	template<class TC> void act(TC& tc)
+	{
+		if(p_Repos->scopeStack().size() == 0)
+			return;
+		size_t posInherits = InheritanceOpportunity::inheritedTypePos(tc);
+
+		TypeRef ref("inherits");
+		ref.names.push_back(tc[posInherits]);
+		ref.toFile = true;
+		defer(ref);
+	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
+};
+
+///////////////////////////////////////////////////////////////
+// Rule 3.d. without the type test
+
+class DeferredGlobalFuncCall : public GlobalFuncCall
+{
+public:
+	DeferredGlobalFuncCall(Repository* pRepos) : GlobalFuncCall(pRepos) {}
+	template<class TC, class Act> bool test(TC& tc, Act& act)
+	{
+		if (isCallInFunction(tc))
+		{
+			tc[tc.summary().first(tok_lparen)-1];  // throws where GlobalFuncCall's lookup would
+			act.act(tc);
+			return true;
+		}
+		return false;
+	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
+};
+
+///////////////////////////////////////////////////////////////
+// action to record the called function
+
+class DeferGlobalFuncCall : public DeferTypeRef
+{
+public:
+	DeferGlobalFuncCall(Repository* pRepos, TypeRefs* pRefs) : DeferTypeRef(pRepos, pRefs) {}
+	template<class TC> void act(TC& tc)
+	{
+		TypeRef ref("globalFun");
+		ref.names.push_back(tc[tc.summary().first(tok_lparen) - 1]);
+		defer(ref);
+	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
+};
+
+///////////////////////////////////////////////////////////////
+// action to record the global variable's type, with
+// GlobalVarDeclaration
+
+class DeferGlobalVarDecl : public DeferTypeRef
+{
+public:
+	DeferGlobalVarDecl(Repository* pRepos, TypeRefs* pRefs) : DeferTypeRef(pRepos, pRefs) {}
+	template<class TC> void act(TC& tc)
+	{
+		const TokSummary& ts = tc.summary();
+		TypeRef ref("globalVar");
+		ref.names.push_back(tc[0]);
+		// PushGlobalVarDecl reads the name before "=", or else ";"
+		size_t pos = ts.first(tok_assign) == tc.length() ? ts.first(tok_semicolon) : ts.first(tok_assign);
+		ref.throws = (pos == 0);
+		defer(ref);
+	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
+};
+
+///////////////////////////////////////////////////////////////
+//           End of Deferred Pass 2 Classes                  //
+///////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////
 //                      Pass 1 Classes                       //
 ///////////////////////////////////////////////////////////////
@@ -755,16 +1156,25 @@ public:
 class PreprocStatement : public IRule
 {
 public:
-	bool doTest(ITokCollection*& pTc)
+	PreprocStatement(Repository* = 0)
 	{
+		addTrigger(tok_hash);
+	}
+	template<class TC, class Act> bool test(TC& tc, Act& act)
+	{
+		const TokSummary& ts = tc.summary();
 
-		if(pTc->find("#") < pTc->length())
+		if(ts.first(tok_hash) < tc.length())
 		{
-			doActions(pTc);
+			act.act(tc);
 			return true;
 		}
 		return false;
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -773,9 +1183,14 @@ public:
 class PrintPreproc : public IAction
 {
 public:
+	PrintPreproc(Repository* = 0) {}
+	template<class TC> void act(TC& tc)
+	{
+		//std::cout << "\n\n  Type detected: Preprocessor: " << tc.show().c_str();
+	}
 	void doAction(ITokCollection*& pTc)
 	{
-		//std::cout << "\n\n  Type detected: Preprocessor: " << pTc->show().c_str();
+		act(*pTc);
 	}
 };
 
@@ -789,34 +1204,26 @@ public:
 	GlobalFunctionDefinition(Repository* pRepos)
 	{
 		p_Repos = pRepos;
+		addTrigger(tok_lbrace);
+		addTrigger(tok_lparen);
 	}
 
-	bool isSpecialKeyWord(const std::string& tok)
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
-		const static std::string keys[]
-		= { "for", "while", "switch", "if", "catch" };
-		for(int i=0; i<(sizeof(keys) / sizeof(keys[0])); ++i)
-			if(tok == keys[i])
-				return true;
-		return false;
-	}
-	bool doTest(ITokCollection*& pTc)
-	{
-		ITokCollection& tc = *pTc;
-		if(tc[tc.length()-1] == "{")
+		const TokSummary& ts = tc.summary();
+		if(tc.id(tc.length()-1) == tok_lbrace)
 		{
-			size_t len = tc.find("(");
-			if(len < tc.length() && !isSpecialKeyWord(tc[len-1]))
+			size_t len = ts.first(tok_lparen);
+			if(len < tc.length() && !isTokenKind(tc.id(len-1), tk_control))
 			{
 
 				if (p_Repos->scopeStack().size() == 1)
 				{
-					ScopeStack<element> tempStack = p_Repos->scopeStack();
-					element elem = tempStack.pop();
+					const element& elem = p_Repos->scopeStack().top();
 					if ((elem.type == "function") && (elem.name != "main"))
 					{
 						//std::cout << "\n--FunctionDefinition rule";
-						doActions(pTc);
+						act.act(tc);
 						return true;
 					}
 
@@ -826,6 +1233,10 @@ public:
 		}
 		return false;
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -839,21 +1250,23 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
-		std::string name = (*pTc)[pTc->find("(") - 1];
+		const TokSummary& ts = tc.summary();
+		std::string name = tc[ts.first(tok_lparen) - 1];
 
 		// add the type to the SymbolTable if it isn't already there (which would cause a compilation error)
-		if (!p_Repos->symbolTable().containsType(name))
+		if (p_Repos->isNewType(name))
 		{
 			std::cout << "Glb func detected, adding " << name << "() via pass 1 to the symbol table\n";
-			GraphSingleton *s;
-			s = GraphSingleton::getInstance();
 			// Add the file to the graph
-			s->addTypeToGraph(s->reducePathFileToFileNamePrefix(s->getCurrentFilename()));
-			p_Repos->symbolTable().Add( name, "TBD", s->reducePathFileToFileNamePrefix(s->getCurrentFilename()) );
+			p_Repos->addType(name);
 		}
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 
@@ -864,16 +1277,25 @@ public:
 class EnumStatement : public IRule
 {
 public:
-	bool doTest(ITokCollection*& pTc)
+	EnumStatement(Repository* = 0)
+	{
+		addTrigger(tok_enum);
+	}
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
+		const TokSummary& ts = tc.summary();
 
-		if(pTc->find("enum") < pTc->length())
+		if(ts.first(tok_enum) < tc.length())
 		{
-			doActions(pTc);
+			act.act(tc);
 			return true;
 		}
 		return false;
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -889,26 +1311,26 @@ public:
 		p_Repos = pRepos;
 	}
 
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
-		ITokCollection& tc = *pTc;
-		size_t len = tc.find("enum");
+		const TokSummary& ts = tc.summary();
+		size_t len = ts.first(tok_enum);
 		std::string enumName;
-		GraphSingleton *s;
-		s = GraphSingleton::getInstance();
 
-		if (tc[len+1] == "{")
+		if (tc.id(len+1) == tok_lbrace)
 			enumName = "noName";
 		else
 			enumName = tc[len + 1];
 
 		std::cout << "\n  Type detected: Enum: " << enumName << "\n";
-		s->addTypeToGraph(s->reducePathFileToFileNamePrefix(s->getCurrentFilename()));
-
-		p_Repos->symbolTable().Add( enumName, "TBD", s->reducePathFileToFileNamePrefix(s->getCurrentFilename()) );
+		p_Repos->addType(enumName);
 
 
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -923,22 +1345,16 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
+		const TokSummary& ts = tc.summary();
 		// pop anonymous scope
 		p_Repos->scopeStack().pop();
 
-		if (p_Repos->scopeStack().size() > 0)
-		{
-			element cacheElement = p_Repos->scopeStack().pop();
-			p_Repos->scopeStack().push(cacheElement);
-		}
-
-		ITokCollection& tc = *pTc;
-		size_t len = tc.find("enum");
+		size_t len = ts.first(tok_enum);
 		std::string enumName;
 
-		if (tc[len+1] == "{")
+		if (tc.id(len+1) == tok_lbrace)
 			enumName = "noName";
 		else
 			enumName = tc[len + 1];
@@ -952,6 +1368,10 @@ public:
 		p_Repos->scopeStack().push(elem);
 		std::cout << ".";
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -960,8 +1380,12 @@ public:
 class TypedefStatement : public IRule
 {
 public:
+	TypedefStatement(Repository* = 0)
+	{
+		addTrigger(tok_typedef);
+	}
 
-	bool isStdDatatype(const std::string& tok)
+	bool isStdDatatype(const StrView& tok)
 	{
 		const static std::string keys[]
 		= {  "ios", "ios_base", "istream", "iostream", "ostream","streambuf", "ifstream", "fstream", 
@@ -974,22 +1398,26 @@ public:
 		return false;
 	}
 
-	bool doTest(ITokCollection*& pTc)
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
+		const TokSummary& ts = tc.summary();
 
-		if((pTc->find("typedef") < pTc->length()) && (pTc->find("enum") == pTc->length()))
+		if((ts.first(tok_typedef) < tc.length()) && (ts.first(tok_enum) == tc.length()))
 		{			
-			ITokCollection& tc = *pTc;
-			size_t posTypedefType = tc.find(";") - 1;
+				size_t posTypedefType = ts.first(tok_semicolon) - 1;
 
 			if (!isStdDatatype(tc[posTypedefType]))
 			{
-				doActions(pTc);
+				act.act(tc);
 				return true;
 			}
 		}
 		return false;
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -1004,18 +1432,18 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
-		ITokCollection& tc = *pTc;
-		size_t posTypedef = tc.find(";") -1;	
-		GraphSingleton *s;
-		s = GraphSingleton::getInstance();
+		const TokSummary& ts = tc.summary();
+		size_t posTypedef = ts.first(tok_semicolon) -1;	
 		std::cout << " \nTypedef detected, adding via pass 1: " << tc[posTypedef] << "\n";
-		s->addTypeToGraph(s->reducePathFileToFileNamePrefix(s->getCurrentFilename()));
-
-		p_Repos->symbolTable().Add( tc[posTypedef], "TBD", s->reducePathFileToFileNamePrefix(s->getCurrentFilename()) );
+		p_Repos->addType(tc[posTypedef]);
 
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 
@@ -1025,30 +1453,30 @@ public:
 class FunctionDefinition : public IRule
 {
 public:
-	bool isSpecialKeyWord(const std::string& tok)
+	FunctionDefinition(Repository* = 0)
 	{
-		const static std::string keys[]
-		= { "for", "while", "switch", "if", "catch" };
-		for(int i=0; i<5; ++i)
-			if(tok == keys[i])
-				return true;
-		return false;
+		addTrigger(tok_lbrace);
+		addTrigger(tok_lparen);
 	}
-	bool doTest(ITokCollection*& pTc)
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
-		ITokCollection& tc = *pTc;
-		if(tc[tc.length()-1] == "{")
+		const TokSummary& ts = tc.summary();
+		if(tc.id(tc.length()-1) == tok_lbrace)
 		{
-			size_t len = tc.find("(");
-			if(len < tc.length() && !isSpecialKeyWord(tc[len-1]))
+			size_t len = ts.first(tok_lparen);
+			if(len < tc.length() && !isTokenKind(tc.id(len-1), tk_control))
 			{
 				//std::cout << "\n--FunctionDefinition rule";
-				doActions(pTc);
+				act.act(tc);
 				return true;
 			}
 		}
 		return false;
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -1058,9 +1486,13 @@ public:
 class PrintFunction : public IAction
 {
 public:
+	template<class TC> void act(TC& tc)
+	{
+		std::cout << "\n\n  FuncDef Stmt: " << tc.show().c_str();
+	}
 	void doAction(ITokCollection*& pTc)
 	{
-		std::cout << "\n\n  FuncDef Stmt: " << pTc->show().c_str();
+		act(*pTc);
 	}
 };
 
@@ -1075,19 +1507,24 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
+		const TokSummary& ts = tc.summary();
 		// pop anonymous scope
 		p_Repos->scopeStack().pop();
 
 		// push function scope
-		std::string name = (*pTc)[pTc->find("(") - 1];
+		std::string name = tc[ts.first(tok_lparen) - 1];
 		element elem;
 		elem.type = "function";
 		elem.name = name;
 		elem.lineCount = p_Repos->lineCount();
 		p_Repos->scopeStack().push(elem);
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -1096,22 +1533,31 @@ public:
 class ClassDefinition : public IRule
 {
 public:
+	ClassDefinition(Repository* = 0)
+	{
+		addTrigger(tok_lbrace);
+		addTrigger(tok_class);
+	}
 
-	bool doTest(ITokCollection*& pTc)
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
-		ITokCollection& tc = *pTc;
-		if(tc[tc.length()-1] == "{")
+		const TokSummary& ts = tc.summary();
+		if(tc.id(tc.length()-1) == tok_lbrace)
 		{
-			size_t len = tc.find("class");
+			size_t len = ts.first(tok_class);
 			if(len < tc.length() /*&& (tc.find(":") == tc.length() )*/)
 			{
 				//std::cout << "\n--ClassDefinition rule";
-				doActions(pTc);
+				act.act(tc);
 				return true;
 			}
 		}
 		return false;
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -1126,25 +1572,26 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
+		const TokSummary& ts = tc.summary();
 		// pop anonymous scope
 		p_Repos->scopeStack().pop();
 
 		// push class/struct scope
-		std::string name = (*pTc)[pTc->find("class") + 1];
+		std::string name = tc[ts.first(tok_class) + 1];
 		element elem;
 		elem.type = "class";
 		elem.name = name;
 		elem.lineCount = p_Repos->lineCount();
 		p_Repos->scopeStack().push(elem);
 
-		GraphSingleton *s;
-		s = GraphSingleton::getInstance();
 		std::cout << " \nClass detected, adding via pass 1: " << name << "\n";
-		s->addTypeToGraph(s->reducePathFileToFileNamePrefix(s->getCurrentFilename()));
-
-		p_Repos->symbolTable().Add( name, "TBD", s->reducePathFileToFileNamePrefix(s->getCurrentFilename()) );
+		p_Repos->addType(name);
+	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
 	}
 
 };
@@ -1161,13 +1608,14 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
+		const TokSummary& ts = tc.summary();
 		// pop anonymous scope
 		p_Repos->scopeStack().pop();
 
 		// push class/struct scope
-		std::string name = (*pTc)[pTc->find("class") + 1];
+		std::string name = tc[ts.first(tok_class) + 1];
 		element elem;
 		elem.type = "class";
 		elem.name = name;
@@ -1175,6 +1623,10 @@ public:
 		p_Repos->scopeStack().push(elem);
 
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 
 };
 
@@ -1185,22 +1637,31 @@ public:
 class StructDefinition : public IRule
 {
 public:
+	StructDefinition(Repository* = 0)
+	{
+		addTrigger(tok_lbrace);
+		addTrigger(tok_struct);
+	}
 
-	bool doTest(ITokCollection*& pTc)
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
-		ITokCollection& tc = *pTc;
-		if(tc[tc.length()-1] == "{")
+		const TokSummary& ts = tc.summary();
+		if(tc.id(tc.length()-1) == tok_lbrace)
 		{
-			size_t len = tc.find("struct");
+			size_t len = ts.first(tok_struct);
 			if(len < tc.length() )
 			{
 				//std::cout << "\n--StructDefinition rule";
-				doActions(pTc);
+				act.act(tc);
 				return true;
 			}
 		}
 		return false;
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -1215,26 +1676,27 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
+		const TokSummary& ts = tc.summary();
 		// pop anonymous scope
 		p_Repos->scopeStack().pop();
 
 		// push class/struct scope
-		std::string name = (*pTc)[pTc->find("struct") + 1];
+		std::string name = tc[ts.first(tok_struct) + 1];
 		element elem;
 		elem.type = "struct";
 		elem.name = name;
 		elem.lineCount = p_Repos->lineCount();
 		p_Repos->scopeStack().push(elem);
 
-		GraphSingleton *s;
-		s = GraphSingleton::getInstance();
 
 		std::cout << " \nStruct detected, adding via pass 1: " << name << "\n";
-		s->addTypeToGraph(s->reducePathFileToFileNamePrefix(s->getCurrentFilename()));
-
-		p_Repos->symbolTable().Add( name, "TBD", s->reducePathFileToFileNamePrefix(s->getCurrentFilename()) );
+		p_Repos->addType(name);
+	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
 	}
 };
 
@@ -1250,19 +1712,24 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
+		const TokSummary& ts = tc.summary();
 		// pop anonymous scope
 		p_Repos->scopeStack().pop();
 
 		// push class/struct scope
-		std::string name = (*pTc)[pTc->find("struct") + 1];
+		std::string name = tc[ts.first(tok_struct) + 1];
 		element elem;
 		elem.type = "struct";
 		elem.name = name;
 		elem.lineCount = p_Repos->lineCount();
 		p_Repos->scopeStack().push(elem);
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 
@@ -1272,22 +1739,31 @@ public:
 class UnionDefinition : public IRule
 {
 public:
+	UnionDefinition(Repository* = 0)
+	{
+		addTrigger(tok_lbrace);
+		addTrigger(tok_union);
+	}
 
-	bool doTest(ITokCollection*& pTc)
+	template<class TC, class Act> bool test(TC& tc, Act& act)
 	{
-		ITokCollection& tc = *pTc;
-		if(tc[tc.length()-1] == "{")
+		const TokSummary& ts = tc.summary();
+		if(tc.id(tc.length()-1) == tok_lbrace)
 		{
-			size_t len = tc.find("union");
+			size_t len = ts.first(tok_union);
 			if(len < tc.length() )
 			{
 				//std::cout << "\n--UnionDefinition rule";
-				doActions(pTc);
+				act.act(tc);
 				return true;
 			}
 		}
 		return false;
 	}
+	bool doTest(ITokCollection*& pTc)
+	{
+		return test(*pTc, *this);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -1302,27 +1778,28 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
+		const TokSummary& ts = tc.summary();
 		// pop anonymous scope
 		p_Repos->scopeStack().pop();
 
 		// push class/struct scope
-		std::string name = (*pTc)[pTc->find("union") + 1];
+		std::string name = tc[ts.first(tok_union) + 1];
 		element elem;
 		elem.type = "union";
 		elem.name = name;
 		elem.lineCount = p_Repos->lineCount();
 		p_Repos->scopeStack().push(elem);
 
-		GraphSingleton *s;
-		s = GraphSingleton::getInstance();
 		std::cout << " \nUnion detected, adding via pass 1: " << name << "\n";
-		s->addTypeToGraph(s->reducePathFileToFileNamePrefix(s->getCurrentFilename()));
-
-		p_Repos->symbolTable().Add( name, "TBD", s->reducePathFileToFileNamePrefix(s->getCurrentFilename()) );
+		p_Repos->addType(name);
 
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 ///////////////////////////////////////////////////////////////
@@ -1337,13 +1814,14 @@ public:
 	{
 		p_Repos = pRepos;
 	}
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
+		const TokSummary& ts = tc.summary();
 		// pop anonymous scope
 		p_Repos->scopeStack().pop();
 
 		// push class/struct scope
-		std::string name = (*pTc)[pTc->find("union") + 1];
+		std::string name = tc[ts.first(tok_union) + 1];
 		element elem;
 		elem.type = "union";
 		elem.name = name;
@@ -1351,6 +1829,10 @@ public:
 		p_Repos->scopeStack().push(elem);
 
 	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
+	}
 };
 
 
@@ -1366,15 +1848,19 @@ public:
 class PrettyPrintFunction : public IAction
 {
 public:
-	void doAction(ITokCollection*& pTc)
+	template<class TC> void act(TC& tc)
 	{
-		pTc->remove("public");
-		pTc->remove(":");
-		pTc->trimFront();
-		int len = pTc->find(")");
+		tc.remove("public");
+		tc.remove(":");
+		tc.trimFront();
+		int len = tc.find(tok_rparen);
 		std::cout << "\n\n  Pretty Stmt:    ";
 		for(int i=0; i<len+1; ++i)
-			std::cout << (*pTc)[i] << " ";
+			std::cout << tc[i] << " ";
+	}
+	void doAction(ITokCollection*& pTc)
+	{
+		act(*pTc);
 	}
 };
 
@@ -0,0 +1,345 @@
+///////////////////////////////////////////////////////////////
+// ChunkLexer.cpp - lexes large files on several threads     //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include "ChunkLexer.h"
+#include "Tokenizer.h"
+#include "ScanKernel.h"
+
+//----< lexer for the file owner is attached to >--------------------
+
+ChunkLexer::ChunkLexer(Toker& tkr, size_t minChunkBytes)
+	: owner(tkr), base(tkr.pBegin), size(tkr.pEnd - tkr.pBegin), minChunk(minChunkBytes),
+	nextToLex(0), resyncs(0), pos(0), lines(0), braces(0), seg(0), tok(0)
+{
+	if(minChunk == 0)
+		minChunk = 1;
+}
+//----< start of a chunk, just after a newline at or after from >----
+//
+//  Skips newlines that end with a line continuation, and newlines
+//  followed by a line that starts with '*' or holds "*/", as those
+//  are likely in a block comment.  Takes the first newline if none
+//  suits within a chunk's length.
+
+size_t ChunkLexer::findSplit(size_t from)
+{
+	const char* end = base + size;
+	const char* giveUp = base + std::min(size, from + minChunk);
+	const char* p = base + from;
+	const char* first = 0;
+	while(p < end)
+	{
+		const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+		if(nl == 0)
+			break;
+		const char* next = nl + 1;
+		if(first == 0)
+			first = next;
+		const char* last = (nl[-1] == '\r') ? nl - 1 : nl;
+		bool continued = (last > base && last[-1] == '\\');
+		const char* lineEnd = static_cast<const char*>(memchr(next, '\n', end - next));
+		if(lineEnd == 0)
+			lineEnd = end;
+		const char* text = ScanKernel::skipBlanks(next, lineEnd);
+		const char* closer = "*/";
+		bool inComment = (text < lineEnd && *text == '*') ||
+			std::search(next, lineEnd, closer, closer + 2) != lineEnd;
+		if(!continued && !inComment)
+			return next - base;
+		if(next >= giveUp)
+			return first - base;
+		p = next;
+	}
+	return first ? first - base : size;
+}
+//----< split file, lex chunks on workers, and stitch the results >--
+//
+//  Returns false, leaving Toker to scan serially, if the file is
+//  too small to split or Toker doesn't return newline tokens.
+
+bool ChunkLexer::lex()
+{
+	if(size < 2 * minChunk || size >= 0xFFFFFFFF)
+		return false;
+	if(!(owner.classes['\n'] & CharClasses::singleChar))
+		return false;
+
+	splits.push_back(0);
+	while(size - splits.back() >= 2 * minChunk)
+	{
+		size_t split = findSplit(splits.back() + minChunk);
+		if(split >= size)
+			break;
+		splits.push_back(split);
+	}
+	splits.push_back(size);
+	if(numChunks() < 2)
+		return false;
+
+	results.resize(numChunks());
+	size_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+	numThreads = std::min(numThreads, numChunks());
+	std::vector<std::thread> workers;
+	for(size_t i=1; i<numThreads; ++i)
+		workers.push_back(std::thread(&ChunkLexer::work, this));
+	work();
+	for(size_t i=0; i<workers.size(); ++i)
+		workers[i].join();
+
+	// chunk k joins the stream at the newline token where it stands,
+	// or that part of the file is scanned again from there
+
+	for(size_t k=0; k<numChunks(); ++k)
+	{
+		size_t r = k, first = 0;
+		if(!resumeAt(results[k], pos, first))
+		{
+			++resyncs;
+			r = results.size();
+			results.push_back(Result());
+			lexRange(results.back(), pos, splits[k+1], false);
+		}
+		if(!results[r].complete)
+		{
+			// worker ran out of range, keep its tokens through its last newline
+			size_t last = results[r].toks.size();
+			while(last > first && !results[r].toks[last-1].newline)
+				--last;
+			accept(r, first, last);
+			++resyncs;
+			r = results.size();
+			first = 0;
+			results.push_back(Result());
+			lexRange(results.back(), pos, splits[k+1], false);
+		}
+		accept(r, first, results[r].toks.size());
+		if(results[r].fileEnd)
+			break;
+	}
+	if(segments.size() > 0)
+		tok = segments[0].first;
+	return true;
+}
+//----< worker thread, lexes chunks until none are left >------------
+
+void ChunkLexer::work()
+{
+	for(;;)
+	{
+		size_t k;
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			k = nextToLex++;
+		}
+		if(k >= numChunks())
+			return;
+		lexRange(results[k], splits[k], splits[k+1], true);
+	}
+}
+//----< lex from start to first newline token ending at or after stopAt >
+//
+//  A bounded scan stops short, leaving r incomplete, if it would run
+//  a chunk's length past stopAt, or if it ends in an unclosed quote.
+//  An unbounded scan behaves exactly as the serial scan.
+
+void ChunkLexer::lexRange(Result& r, size_t start, size_t stopAt, bool bounded)
+{
+	Toker w;
+	w.scTok = owner.scTok;
+	w.classes = owner.classes;
+	w._mode = owner._mode;
+	w.doReturnComments = owner.doReturnComments;
+	w.doReturnSingleQuotesAsToken = owner.doReturnSingleQuotesAsToken;
+	w.doFastScan = owner.doFastScan;
+	w.chunkWorker = bounded;
+
+	size_t limit = size;
+	if(bounded && stopAt + (stopAt - start) < size)
+		limit = stopAt + (stopAt - start);
+	w.attachBuffer(base + start, base + limit);
+	if(start > 0)
+	{
+		// as just after the previous newline token
+		w.currChar = '\n';
+		w.nextChar = (char)w.peek();
+	}
+	r.start = start;
+
+	for(;;)
+	{
+		StrView text = w.getTokView();
+
+		// a token scanned up to the end of a range may differ from the serial scan
+		if(w.workerBailed || (limit < size && w.pEnd - w.pNext < 2))
+			return;
+
+		Rec rec;
+		rec.inSource = text.length() > 0 && !w.isTransient(text);
+		if(rec.inSource)
+			rec.offset = (unsigned)(text.data() - base);
+		else
+		{
+			rec.offset = (unsigned)r.owned.size();
+			r.owned.append(text.data(), text.length());
+		}
+		rec.length = (unsigned)text.length();
+		rec.posAfter = (unsigned)(w.pNext - w.putbacks.size() - base);
+		rec.lines = w.numLines;
+		rec.braces = w.braceCount;
+		rec.nextChar = w.nextChar;
+		rec.newline = (text.length() == 1 && text[0] == '\n');
+		r.toks.push_back(rec);
+
+		if(w.isFileEnd())
+		{
+			r.complete = r.fileEnd = true;
+			return;
+		}
+		if(rec.newline && rec.posAfter >= stopAt)
+		{
+			r.complete = true;
+			return;
+		}
+	}
+}
+//----< index in r of first token after newline token ending at pos >
+
+bool ChunkLexer::resumeAt(const Result& r, size_t pos, size_t& first)
+{
+	if(pos == r.start)
+	{
+		first = 0;
+		return true;
+	}
+	for(size_t i=0; i<r.toks.size() && r.toks[i].posAfter <= pos; ++i)
+	{
+		if(r.toks[i].posAfter == pos && r.toks[i].newline)
+		{
+			first = i + 1;
+			return true;
+		}
+	}
+	return false;
+}
+//----< append tokens [first, last) of a result to stitched stream >-
+
+void ChunkLexer::accept(size_t result, size_t first, size_t last)
+{
+	if(last <= first)
+		return;
+	const std::vector<Rec>& toks = results[result].toks;
+	Segment s;
+	s.result = result;
+	s.first = first;
+	s.last = last;
+	s.lineOffset = lines - (first == 0 ? 0 : toks[first-1].lines);
+	s.braceOffset = braces - (first == 0 ? 0 : toks[first-1].braces);
+	segments.push_back(s);
+	lines = toks[last-1].lines + s.lineOffset;
+	braces = toks[last-1].braces + s.braceOffset;
+	pos = toks[last-1].posAfter;
+}
+//----< next stitched token, false after the last >------------------
+
+bool ChunkLexer::next(Tok& t)
+{
+	if(seg == segments.size())
+		return false;
+	const Segment& s = segments[seg];
+	const Result& r = results[s.result];
+	const Rec& rec = r.toks[tok];
+	if(rec.inSource)
+		t.text = StrView(base + rec.offset, rec.length);
+	else
+		t.text = StrView(r.owned.data() + rec.offset, rec.length);
+	t.inSource = rec.inSource;
+	t.lines = rec.lines + s.lineOffset;
+	t.braces = rec.braces + s.braceOffset;
+	t.nextChar = rec.nextChar;
+	if(++tok == s.last && ++seg < segments.size())
+		tok = segments[seg].first;
+	return true;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_CHUNKLEXER
+
+#include <iostream>
+#include <iomanip>
+#include "Timer.h"
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Testing ChunkLexer class\n "
+		<< std::string(26,'=') << std::endl;
+	if(argc < 2)
+	{
+		std::cout << "\n  please enter names of files to process on command line\n\n";
+		return 1;
+	}
+
+	for(int i=1; i<argc; ++i)
+	{
+		std::cout << "\n  Processing file " << argv[i];
+
+		Toker serial;
+		serial.mapInput();
+		serial.returnComments();
+		Timer timer;
+		if(!serial.attach(argv[i]))
+		{
+			std::cout << "\n    can't open file\n";
+			continue;
+		}
+		std::vector<std::string> toks;
+		std::vector<int> counts;
+		do
+		{
+			toks.push_back(serial.getTokView());
+			counts.push_back(serial.lines());
+			counts.push_back(serial.braceLevel());
+		} while(toks.back() != "");
+		double serialTime = timer.elapsed();
+
+		// small chunks, so even small files are split
+
+		const size_t chunkSizes[] = { 64, 4096, 1 << 20 };
+		for(size_t j=0; j<sizeof(chunkSizes)/sizeof(chunkSizes[0]); ++j)
+		{
+			Toker parallel;
+			parallel.mapInput();
+			parallel.returnComments();
+			parallel.lexInParallel(true, chunkSizes[j]);
+			timer.restart();
+			parallel.attach(argv[i]);
+			bool same = true;
+			size_t n = 0;
+			for(; n<toks.size() && same; ++n)
+			{
+				if(toks[n] != parallel.getTokView() || counts[2*n] != parallel.lines() ||
+					counts[2*n+1] != parallel.braceLevel())
+					same = false;
+			}
+			double parallelTime = timer.elapsed();
+			std::cout << "\n    chunks of " << std::setw(7) << chunkSizes[j] << " bytes: "
+				<< (same ? "matches" : "differs from") << " serial scan after " << n << " tokens, "
+				<< std::fixed << std::setprecision(2) << 1000.0 * parallelTime << " msec vs "
+				<< 1000.0 * serialTime << " msec";
+		}
+		std::cout << "\n";
+	}
+	std::cout << "\n";
+}
+
+#endif
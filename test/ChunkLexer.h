@@ -0,0 +1,150 @@
+#ifndef CHUNKLEXER_H
+#define CHUNKLEXER_H
+///////////////////////////////////////////////////////////////
+// ChunkLexer.h - lexes large files on several threads       //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+This module defines a ChunkLexer class, used by Toker when it is
+asked to lexInParallel() a mapped file.  The file is split into
+chunks, each chunk is lexed by its own Toker on a worker thread, and
+the token streams are stitched back together.  Toker then returns the
+stitched tokens, with the same text, line counts, and brace levels
+that the serial scan would have produced.
+
+Chunks start just after a newline.  A cheap pre-scan picks newlines
+that don't look like they are inside a comment or quote, but that is
+only a guess: a worker that starts inside a block comment or quote
+produces wrong tokens until it gets back in step with the file.  So
+the stitch doesn't trust chunk starts.  A serial scan is in the same
+state after every newline token, so chunk k is joined at the newline
+token where chunk k-1 stopped.  If chunk k has no newline token
+there, that part of the file is lexed again, serially, from the end
+of chunk k-1.  Workers are held to a bounded range, so a bad start
+can't make one run to the end of the file.
+
+Public Interface:
+=================
+ChunkLexer cl(toker, 1 << 20);         // toker attached to mapped file
+if(cl.lex())                           // false if file is too small
+{
+  ChunkLexer::Tok tok;
+  while(cl.next(tok))                  // stitched tokens, in file order
+    std::cout << tok.text;
+}
+size_t n = cl.numChunks();             // chunks lexed on workers
+size_t r = cl.numResyncs();            // chunk joins needing a serial rescan
+
+Build Process:
+==============
+Required files
+- ChunkLexer.h, ChunkLexer.cpp, Tokenizer.h, Tokenizer.cpp,
+FileMap.h, FileMap.cpp, StrView.h, StrView.cpp, ScanKernel.h,
+ScanKernel.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /O2 /DTEST_CHUNKLEXER ChunkLexer.cpp Tokenizer.cpp \
+FileMap.cpp StrView.cpp ScanKernel.cpp /link setargv.obj
+
+Maintenance History:
+====================
+ver 1.0 : 16 Oct 26
+- first release
+*/
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include "StrView.h"
+
+class Toker;
+
+class ChunkLexer
+{
+public:
+	// a stitched token, as Toker returns it
+	struct Tok
+	{
+		StrView text;
+		bool inSource;      // text is in the mapped file, not a copy
+		int lines;          // Toker::lines() after this token
+		int braces;         // Toker::braceLevel() after this token
+		char nextChar;      // char Toker looked ahead at after this token
+	};
+
+	ChunkLexer(Toker& owner, size_t minChunkBytes);
+	bool lex();
+	bool next(Tok& tok);
+	size_t numChunks() const;
+	size_t numResyncs() const;
+
+private:
+	// token recorded by a worker, positions are offsets into the file
+	struct Rec
+	{
+		unsigned offset;    // in file if inSource, else in Result::owned
+		unsigned length;
+		unsigned posAfter;  // first char not consumed by this token
+		int lines;          // counted from start of the worker's range
+		int braces;
+		char nextChar;
+		bool inSource;
+		bool newline;
+	};
+
+	// token stream of one lexed range
+	struct Result
+	{
+		Result() : start(0), complete(false), fileEnd(false) {}
+		size_t start;
+		std::vector<Rec> toks;
+		std::string owned;  // text of tokens not found in file
+		bool complete;      // stopped at a newline token, or file end
+		bool fileEnd;
+	};
+
+	// run of tokens taken from one result, in stitched order
+	struct Segment
+	{
+		size_t result, first, last;
+		int lineOffset, braceOffset;
+	};
+
+	void lexRange(Result& r, size_t start, size_t stopAt, bool bounded);
+	bool resumeAt(const Result& r, size_t pos, size_t& first);
+	void accept(size_t result, size_t first, size_t last);
+	size_t findSplit(size_t from);
+	void work();
+
+	Toker& owner;
+	const char* base;
+	size_t size;
+	size_t minChunk;
+	std::vector<size_t> splits;   // chunk k is [splits[k], splits[k+1])
+	std::deque<Result> results;   // one per chunk, then serial rescans
+	std::vector<Segment> segments;
+	std::mutex mtx;               // guards nextToLex
+	size_t nextToLex;             // next chunk a worker should take
+	size_t resyncs;
+	size_t pos;                   // stitching: first unconsumed char
+	int lines, braces;            // stitching: counts at pos
+	size_t seg, tok;              // replay position
+
+	// prohibit copying and assignment
+	ChunkLexer(const ChunkLexer&);
+	ChunkLexer& operator=(const ChunkLexer&);
+};
+
+inline size_t ChunkLexer::numChunks() const { return splits.size() == 0 ? 0 : splits.size() - 1; }
+
+inline size_t ChunkLexer::numResyncs() const { return resyncs; }
+
+#endif
@@ -0,0 +1,329 @@
+///////////////////////////////////////////////////////////////
+// ConcurrentSymbolTable.cpp - table shared by threads       //
+// Ver 1.1                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include <functional>
+#include "ConcurrentSymbolTable.h"
+
+//----< table of numShards shards, rounded up to a power of 2 >------
+
+ConcurrentSymbolTable::ConcurrentSymbolTable(size_t numShards) : published(false)
+{
+	size_t n = 1;
+	while(n < numShards)
+		n <<= 1;
+	for(size_t i=0; i<n; ++i)
+		shards.push_back(new Shard);
+	mask = n - 1;
+}
+
+ConcurrentSymbolTable::~ConcurrentSymbolTable()
+{
+	for(size_t i=0; i<shards.size(); ++i)
+		delete shards[i];
+}
+//----< shard holding type's entries >-------------------------------
+
+ConcurrentSymbolTable::Shard& ConcurrentSymbolTable::shardOf(const TypeName& type) const
+{
+	return *shards[std::hash<TypeName>()(type) & mask];
+}
+//----< add type, defined in namespace ns of file f >----------------
+
+/*
+ *  published is tested under the shard's lock: publish() holds every
+ *  shard's lock while it sets the flag, so an Add() either inserts
+ *  before the table is published or throws.
+ */
+void ConcurrentSymbolTable::Add(const TypeName& t, const Namespace& ns, const SourceFile& f)
+{
+	Shard& shard = shardOf(t);
+	std::lock_guard<std::mutex> lock(shard.mtx);
+	if(isPublished())
+		throw std::exception("symbol table is published, and read only");
+	shard.symbols[t].push_back(NamespaceInfo(ns, f));
+}
+//----< is type defined in any namespace? >--------------------------
+
+bool ConcurrentSymbolTable::containsType(const TypeName& type) const
+{
+	Shard& shard = shardOf(type);
+	if(isPublished())
+		return shard.symbols.find(type) != shard.symbols.end();
+	std::lock_guard<std::mutex> lock(shard.mtx);
+	return shard.symbols.find(type) != shard.symbols.end();
+}
+//----< file defining type in namespace ns, or "" >------------------
+
+namespace
+{
+	SourceFile fileIn(const Symbols& symbols, const TypeName& type, const Namespace& ns)
+	{
+		Symbols::const_iterator iter = symbols.find(type);
+		if(iter == symbols.end())
+			return "";
+		for(Namespaces::const_iterator info = iter->second.begin(); info != iter->second.end(); ++info)
+			if(info->first == ns)
+				return info->second;
+		return "";
+	}
+}
+
+SourceFile ConcurrentSymbolTable::lookUpFile(const TypeName& type, const Namespace& ns) const
+{
+	Shard& shard = shardOf(type);
+	if(isPublished())
+		return fileIn(shard.symbols, type, ns);
+	std::lock_guard<std::mutex> lock(shard.mtx);
+	return fileIn(shard.symbols, type, ns);
+}
+//----< make table read only, so lookups needn't lock >--------------
+/*
+ *  Every shard's lock is held while published is set, so no Add() is
+ *  part way through an insert, and none that comes after can insert.
+ *  Adds made before are ordered before the release store, so a thread
+ *  that sees published sees them all.
+ */
+void ConcurrentSymbolTable::publish()
+{
+	std::vector<std::unique_lock<std::mutex> > locks;
+	locks.reserve(shards.size());
+	for(size_t i=0; i<shards.size(); ++i)
+		locks.push_back(std::unique_lock<std::mutex>(shards[i]->mtx));
+	published.store(true, std::memory_order_release);
+}
+//----< number of type names >---------------------------------------
+
+size_t ConcurrentSymbolTable::size() const
+{
+	size_t n = 0;
+	for(size_t i=0; i<shards.size(); ++i)
+	{
+		if(isPublished())
+			n += shards[i]->symbols.size();
+		else
+		{
+			std::lock_guard<std::mutex> lock(shards[i]->mtx);
+			n += shards[i]->symbols.size();
+		}
+	}
+	return n;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_CONCURRENTSYMBOLTABLE
+
+#include <thread>
+#include <sstream>
+
+int main()
+{
+	Title("Testing ConcurrentSymbolTable class");
+	ConcurrentSymbolTable symbols;
+	symbols.Add("X", "::", "X.h");
+	symbols.Add("Y", "A::", "W.h");
+	symbols.Add("X", "B::", "V.cpp");
+
+	std::vector<std::thread> threads;
+	for(int t=0; t<4; ++t)
+	{
+		threads.push_back(std::thread([&symbols, t]()
+		{
+			for(int i=0; i<1000; ++i)
+			{
+				std::ostringstream name;
+				name << "T" << t << "_" << i;
+				if(!symbols.containsType(name.str()))
+					symbols.Add(name.str(), "::", "T.h");
+			}
+		}));
+	}
+	for(size_t t=0; t<threads.size(); ++t)
+		threads[t].join();
+	std::cout << "\n  4 threads added 4000 types, table has " << symbols.size()
+		<< " in " << symbols.numShards() << " shards";
+
+	symbols.publish();
+	std::cout << "\n  ::X is defined in " << symbols.lookUpFile("X", "::");
+	std::cout << "\n  B::X is defined in " << symbols.lookUpFile("X", "B::");
+	std::cout << "\n  A::Y is defined in " << symbols.lookUpFile("Y", "A::");
+	std::cout << "\n  ::T3_999 is defined in " << symbols.lookUpFile("T3_999", "::");
+	if(!symbols.containsType("Foobar"))
+		std::cout << "\n  ::Foobar not defined";
+	try
+	{
+		symbols.Add("Z", "::", "Z.h");
+	}
+	catch(std::exception& ex)
+	{
+		std::cout << "\n  Add after publish: " << ex.what();
+	}
+
+	// threads keep adding while another publishes: an Add() either
+	// inserts before publish() returns or throws, so the table can't
+	// grow after, and every Add() that returned is found
+
+	size_t grown = 0, lost = 0;
+	for(int round=0; round<200; ++round)
+	{
+		ConcurrentSymbolTable racing(4);
+		std::vector<std::vector<std::string> > added(4);
+		std::vector<std::thread> adders;
+		for(int t=0; t<4; ++t)
+		{
+			adders.push_back(std::thread([&racing, &added, t]()
+			{
+				try
+				{
+					for(int i=0; ; ++i)
+					{
+						std::ostringstream name;
+						name << "R" << t << "_" << i;
+						racing.Add(name.str(), "::", "R.h");
+						added[t].push_back(name.str());
+					}
+				}
+				catch(std::exception&) {}
+			}));
+		}
+		std::thread publisher([&racing]()
+		{
+			std::this_thread::yield();
+			racing.publish();
+		});
+		publisher.join();
+		size_t atPublish = racing.size();
+		for(size_t t=0; t<adders.size(); ++t)
+			adders[t].join();
+		if(racing.size() != atPublish)
+			++grown;
+		for(size_t t=0; t<added.size(); ++t)
+			for(size_t i=0; i<added[t].size(); ++i)
+				if(!racing.containsType(added[t][i]))
+					++lost;
+	}
+	std::cout << "\n  Add racing publish, 200 rounds: table grew after publish in "
+		<< grown << ", " << lost << " added types not found";
+	std::cout << "\n\n";
+}
+
+#endif
+
+//----< benchmark stub >---------------------------------------------
+/*
+ *  Threads share the type names, each adding its part and then looking
+ *  up every name, as pass 1 and pass 2 would.  A SymbolTable behind one
+ *  lock is compared with a published ConcurrentSymbolTable.
+ */
+#ifdef BENCH_CONCURRENTSYMBOLTABLE
+
+#include <thread>
+#include <sstream>
+#include <iomanip>
+#include "Timer.h"
+
+// SymbolTable with one lock, as threads would have to share it
+
+class LockedSymbolTable
+{
+public:
+	void Add(const TypeName& t, const Namespace& ns, const SourceFile& f)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		symbols.Add(t, ns, f);
+	}
+	bool containsType(const TypeName& type)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		return symbols.containsType(type);
+	}
+	SourceFile lookUpFile(const TypeName& type, const Namespace& ns)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		return symbols.lookUpFile(type, ns);
+	}
+	void publish() {}
+
+private:
+	std::mutex mtx;
+	SymbolTable symbols;
+};
+
+//----< run both passes on numThreads threads, returning seconds >---
+
+template<class Table>
+void passes(Table& table, const std::vector<TypeName>& names, size_t numThreads, double secs[2])
+{
+	const size_t lookUps = 4;             // per name, per pass 2 thread
+	std::vector<size_t> found(numThreads, 0);
+	for(int pass=0; pass<2; ++pass)
+	{
+		Timer timer;
+		std::vector<std::thread> threads;
+		for(size_t t=0; t<numThreads; ++t)
+		{
+			threads.push_back(std::thread([&, t]()
+			{
+				size_t chars = 0;
+				for(size_t i=t; i<names.size(); i += numThreads)
+				{
+					if(pass == 0)
+					{
+						if(!table.containsType(names[i]))
+							table.Add(names[i], "TBD", "File.h");
+					}
+					else
+						for(size_t n=0; n<lookUps; ++n)
+							chars += table.lookUpFile(names[(i + n * 7919) % names.size()], "TBD").size();
+				}
+				found[t] += chars;
+			}));
+		}
+		for(size_t t=0; t<numThreads; ++t)
+			threads[t].join();
+		secs[pass] = timer.elapsed();
+		if(pass == 0)
+			table.publish();
+	}
+}
+
+int main()
+{
+	Title("Benchmarking ConcurrentSymbolTable against a locked SymbolTable");
+	std::vector<TypeName> names;
+	for(size_t i=0; i<(1 << 17); ++i)
+	{
+		std::ostringstream name;
+		name << "Type" << i;
+		names.push_back(name.str());
+	}
+	std::cout << "\n  " << names.size() << " types, 4 look ups of each in pass 2\n";
+	std::cout << "\n  threads   locked: pass 1   pass 2   sharded: pass 1   pass 2";
+	size_t numThreads[] = { 1, 4, 16, 64 };
+	for(size_t n=0; n<4; ++n)
+	{
+		double locked[2], sharded[2];
+		{
+			LockedSymbolTable table;
+			passes(table, names, numThreads[n], locked);
+		}
+		{
+			ConcurrentSymbolTable table(64);
+			passes(table, names, numThreads[n], sharded);
+		}
+		std::cout.precision(3);
+		std::cout << std::fixed << "\n  " << std::setw(7) << numThreads[n]
+			<< std::setw(16) << locked[0] << std::setw(9) << locked[1]
+			<< std::setw(18) << sharded[0] << std::setw(9) << sharded[1];
+	}
+	std::cout << "\n  (seconds)\n\n";
+}
+
+#endif
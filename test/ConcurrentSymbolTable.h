@@ -0,0 +1,110 @@
+#ifndef CONCURRENTSYMBOLTABLE_H
+#define CONCURRENTSYMBOLTABLE_H
+///////////////////////////////////////////////////////////////
+// ConcurrentSymbolTable.h - symbol table shared by threads  //
+// Ver 1.1                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+A SymbolTable may be used by one thread at a time, so each worker
+of a ParserPool keeps its own.  A ConcurrentSymbolTable holds the
+same entries, type name to namespaces and files, but may be shared
+by parser threads without a table wide lock.
+
+Types are spread over shards by the hash of their names, each shard
+a Symbols map with its own mutex.  While pass 1 is finding types,
+Add(), containsType() and lookUpFile() lock only the shard of the
+name, so threads working on different names rarely wait for one
+another.  Once pass 1 is done, publish() makes the table read only:
+from then on the lookups of pass 2 take no lock at all, and Add()
+throws.
+
+ParserPool doesn't use it.  Its pass 1 workers start each file with
+an empty SymbolTable, so a file's result can be replayed in file
+order, or the file parsed again, and the graph and output are those
+of a serial run; in a shared table a worker would see types of files
+after its own.  In pass 2 each worker copies pRepo's frozen table,
+whose Bloom filter and flat slots answer lookups faster than a
+shard's map, and whose lookup counts aren't safe to share.  This
+table is for parsers that need not match a serial run, e.g., a pass 1
+whose types are only looked up once every file is parsed.
+
+Public Interface:
+=================
+ConcurrentSymbolTable symbols;             // 16 shards
+ConcurrentSymbolTable big(64);             // 64 shards
+symbols.Add("X", "::", "X.h");             // on any thread, in pass 1
+if(symbols.containsType("X"))
+  f = symbols.lookUpFile("X", "::");       // "X.h"
+symbols.publish();                         // read only, lookups lock free
+size_t n = symbols.size();                 // number of type names
+
+Build Process:
+==============
+Required files
+- ConcurrentSymbolTable.h, ConcurrentSymbolTable.cpp, SymbolTable.h,
+Utility.h, Utility.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_CONCURRENTSYMBOLTABLE ConcurrentSymbolTable.cpp \
+Utility.cpp
+- cl /EHsc /O2 /DBENCH_CONCURRENTSYMBOLTABLE ConcurrentSymbolTable.cpp \
+Utility.cpp
+
+Maintenance History:
+====================
+ver 1.1 : 17 Oct 26
+- Add() tests published under its shard's lock, and publish() holds
+  every shard's lock, so no Add() can insert once published
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include "SymbolTable.h"
+
+class ConcurrentSymbolTable
+{
+public:
+	ConcurrentSymbolTable(size_t numShards = 16);
+	~ConcurrentSymbolTable();
+	void Add(const TypeName& t, const Namespace& ns, const SourceFile& f);
+	bool containsType(const TypeName& type) const;
+	SourceFile lookUpFile(const TypeName& type, const Namespace& ns) const;
+	void publish();
+	bool isPublished() const;
+	size_t size() const;
+	size_t numShards() const;
+
+private:
+	struct Shard
+	{
+		mutable std::mutex mtx;      // not taken once published
+		Symbols symbols;
+		char pad[64];                // keeps shards' locks off each other's cache lines
+	};
+
+	Shard& shardOf(const TypeName& type) const;
+
+	std::vector<Shard*> shards;
+	size_t mask;                   // shards.size() - 1, a power of 2 less one
+	std::atomic<bool> published;
+
+	// prohibit copying and assignment
+	ConcurrentSymbolTable(const ConcurrentSymbolTable&);
+	ConcurrentSymbolTable& operator=(const ConcurrentSymbolTable&);
+};
+
+inline bool ConcurrentSymbolTable::isPublished() const { return published.load(std::memory_order_acquire); }
+
+inline size_t ConcurrentSymbolTable::numShards() const { return shards.size(); }
+
+#endif
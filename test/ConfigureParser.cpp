@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////
 // ConfigureParser.cpp - builds and configures parsers       //
-// Ver 2.0                                                   //
+// Ver 2.6                                                   //
 // Language:    Visual C++ 2012                              //
 // Platform:    Dell E6510, Windows 7                        //
 // Application: CSE687 - OOD, Pr#1, Spring 2013              //
@@ -20,6 +20,8 @@
 #include "SemiExpression.h"
 #include "Tokenizer.h"
 #include "ActionsAndRules.h"
+#include "SemiCache.h"
+#include "SemiPipe.h"
 #include "ConfigureParser.h"
 
 Repository* pRepo;
@@ -29,26 +31,35 @@ Repository* pRepo;
 ConfigParseToConsole::~ConfigParseToConsole()
 {
 	// when Builder goes out of scope, everything must be deallocated
+	// - rules and actions exist only if Build() was called
 
-	delete pHandlePush;
-	delete pBeginningOfScope;
-	delete pHandlePop;
-	delete pEndOfScope;
-	delete pPushFunction;
-	delete pFunctionDefinition;
-	delete pClassDefinition;
-	delete pPushClass;
-	delete pPrintPreproc;
-	delete pPreprocStatement;
-	delete pEnumStatement;
-	delete pPrintEnum;
-	delete pTypedefStatement;
-	delete pPrintTypedef;
-	delete pUnionDefinition;
-	delete pPushUnion;
+	if(pParser)
+	{
+		delete pHandlePush;
+		delete pBeginningOfScope;
+		delete pHandlePop;
+		delete pEndOfScope;
+		delete pPushFunction;
+		delete pFunctionDefinition;
+		delete pClassDefinition;
+		delete pPushClass;
+		delete pPrintPreproc;
+		delete pPreprocStatement;
+		delete pEnumStatement;
+		delete pPrintEnum;
+		delete pTypedefStatement;
+		delete pPrintTypedef;
+		delete pUnionDefinition;
+		delete pPushUnion;
+	}
+	delete pStatic;
 	delete pFR;
-	//delete pRepo;
+	if(ownRepository)
+		delete pRepos;
 	delete pParser;
+	delete pPipe;
+	delete pPipeSemi;
+	delete pPipeToker;
 	delete pSemi;
 	delete pToker;
 
@@ -60,51 +71,137 @@ bool ConfigParseToConsole::Attach(const std::string& name, bool isFile)
 {
 	if(pToker == 0)
 		return false;
+	pSemi->record(0);
+	pSemi->replay(0);
+	if(pPipe)
+		pPipe->stop();      // in case last file wasn't parsed to its end
+	if(pCache && isFile)
+	{
+		// an unchanged file's stream from an earlier run needs no toker
+		SemiRecording* pRec = pCache->restore(name);
+		if(pRec)
+		{
+			pSemi->replay(pRec);
+			return true;
+		}
+		pSemi->record(pCache->startRecording(name));
+	}
+	if(pPipe && isFile)
+	{
+		pSemi->pipe(pPipe);
+		return pPipe->start(name);
+	}
 	return pToker->attach(name, isFile);
+}
+//----< record, or replay, semi-expressions in cache >-------------
+
+void ConfigParseToConsole::UseCache(SemiCache* pCache_)
+{
+	pCache = pCache_;
 }
-//----< Here's where alll the parts get assembled >----------------
+//----< read and tokenize files on a producer thread >-------------
+/*
+ *  The producer's toker and SemiExp are configured like the parser's.
+ */
+void ConfigParseToConsole::Pipeline(size_t numSlots)
+{
+	if(pPipe)
+		return;
+	pPipeToker = new Toker;
+	pPipeToker->returnComments(false);
+	pPipeToker->mapInput();
+	pPipeToker->lexInParallel();
+	pPipeSemi = new SemiExp(pPipeToker);
+	pPipeSemi->returnNewLines(false);
+	pPipe = new SemiPipe(pPipeToker, pPipeSemi, numSlots);
+}
+//----< pipe feeding the parser, 0 if not piped >------------------
 
-Parser* ConfigParseToConsole::Build()
-{	try
-{	// add Parser's main parts
+SemiPipe* ConfigParseToConsole::Pipe()
+{
+	return pPipe;
+}
+//----< collection the parser parses, 0 before Build() >-----------
+
+SemiExp* ConfigParseToConsole::Semi()
+{
+	return pSemi;
+}
+//----< repository the actions share, 0 before Build() >-----------
+
+Repository* ConfigParseToConsole::Repos()
+{
+	return pRepos;
+}
+//----< parts both Build() and BuildStatic() need >---------------
+
+void ConfigParseToConsole::BuildInput()
+{
 	pToker = new Toker;
 	pToker->returnComments(false);
+	pToker->mapInput();
+	pToker->lexInParallel();
 	pSemi = new SemiExp(pToker);
 	pSemi->returnNewLines(false);
+	pRepos = new Repository(pToker);
+	if(!ownRepository)
+		pRepo = pRepos;
+	pFR = new codeFoldingRules;
+}
+//----< same rules and actions as Build(), in a StaticParser >-----
+
+StaticParser1* ConfigParseToConsole::BuildStatic()
+{
+	try
+	{
+		BuildInput();
+		pStatic = new StaticParser1(pSemi, pRepos);
+		pStatic->addFoldingRules(pFR);
+		return pStatic;
+	}
+	catch(std::exception& ex)
+	{
+		std::cout << "\n\n  " << ex.what() << "\n\n";
+		return 0;
+	}
+}
+//----< Here's where alll the parts get assembled >----------------
+
+Parser* ConfigParseToConsole::Build()
+{	try
+{	// add Parser's main parts
+	BuildInput();
 	pParser = new Parser(pSemi);
-	
-	pRepo = new Repository(pToker);
 
 	// add code folding rules
-	pFR = new codeFoldingRules;
 	pParser->addFoldingRules(pFR);
 	// configure to manage scope
 	// these must come first - they return true on match
 	// so rule checking continues
-	pBeginningOfScope = new BeginningOfScope();		pHandlePush = new HandlePush(pRepo);
+	pBeginningOfScope = new BeginningOfScope();		pHandlePush = new HandlePush(pRepos);
 	pBeginningOfScope->addAction(pHandlePush);		pParser->addRule(pBeginningOfScope);
-	pEndOfScope = new EndOfScope();		pHandlePop = new HandlePop(pRepo);
+	pEndOfScope = new EndOfScope();		pHandlePop = new HandlePop(pRepos);
 	pEndOfScope->addAction(pHandlePop);		pParser->addRule(pEndOfScope);
 	pPreprocStatement = new PreprocStatement();		pPrintPreproc = new PrintPreproc();
 	pPreprocStatement->addAction(pPrintPreproc);		pParser->addRule(pPreprocStatement);
 
 	// configure to detect and act on user-defined type definitions
 	// these will stop further rule checking by returning false
-	pClassDefinition = new ClassDefinition;		pPushClass = new PushClass(pRepo); 
+	pClassDefinition = new ClassDefinition;		pPushClass = new PushClass(pRepos); 
 	pClassDefinition->addAction(pPushClass);		pParser->addRule(pClassDefinition);
-	pEnumStatement = new EnumStatement();		pPrintEnum = new PrintEnum(pRepo);		
+	pEnumStatement = new EnumStatement();		pPrintEnum = new PrintEnum(pRepos);		
 	pEnumStatement->addAction(pPrintEnum);		pParser->addRule(pEnumStatement);
-	pFunctionDefinition = new FunctionDefinition;		pPushFunction = new PushFunction(pRepo);  
+	pFunctionDefinition = new FunctionDefinition;		pPushFunction = new PushFunction(pRepos);  
 	pFunctionDefinition->addAction(pPushFunction);		pParser->addRule(pFunctionDefinition);
-	pStructDefinition = new StructDefinition;		pPushStruct = new PushStruct(pRepo);  
+	pStructDefinition = new StructDefinition;		pPushStruct = new PushStruct(pRepos);  
 	pStructDefinition->addAction(pPushStruct);		pParser->addRule(pStructDefinition);
-	pTypedefStatement = new TypedefStatement();		pPrintTypedef = new PrintTypedef(pRepo);
+	pTypedefStatement = new TypedefStatement();		pPrintTypedef = new PrintTypedef(pRepos);
 	pTypedefStatement->addAction(pPrintTypedef);		pParser->addRule(pTypedefStatement);
-	pUnionDefinition = new UnionDefinition;		pPushUnion = new PushUnion(pRepo);  
+	pUnionDefinition = new UnionDefinition;		pPushUnion = new PushUnion(pRepos);  
 	pUnionDefinition->addAction(pPushUnion);		pParser->addRule(pUnionDefinition);
 	
 	//Project 2 pointers
-	pGlobalFunctionDefinition = new GlobalFunctionDefinition(pRepo);		pPushGlobalFunction = new PushGlobalFunction(pRepo);  
+	pGlobalFunctionDefinition = new GlobalFunctionDefinition(pRepos);		pPushGlobalFunction = new PushGlobalFunction(pRepos);  
 	pGlobalFunctionDefinition->addAction(pPushGlobalFunction);		pParser->addRule(pGlobalFunctionDefinition);
 
 	return pParser;
@@ -2,7 +2,7 @@
 #define CONFIGUREPARSER_H
 ///////////////////////////////////////////////////////////////
 // ConfigureParser.h - builds and configures parsers         //
-// Ver 2.0                                                   //
+// Ver 2.6                                                   //
 // Language:    Visual C++ 2012                              //
 // Platform:    Dell E6510, Windows 7                        //
 // Application: CSE687 - OOD, Pr#1, Spring 2013              //
@@ -20,10 +20,32 @@ Module Operations:
 This module builds and configures parsers.  It builds the parser
 parts and configures them with application specific rules and actions.
 
+When given a SemiCache, Attach() replays the recording of a file that
+the cache's store saved on an earlier run, without tokenizing it, and
+otherwise records the file's semi-expressions as they are parsed.
+
+With Pipeline(), files are read and tokenized on a second thread,
+while the parser applies its rules, see SemiPipe.
+
+BuildStatic() builds the same parts, but instead of a Parser, a
+StaticParser applying the same rules and actions, in the same order,
+without virtual calls, see the StaticParser module.
+
+The rules and actions share the Repository pRepo, which pass 2 uses
+too.  A builder constructed with ownRepository true gives them a
+Repository of their own instead, so several can parse at once, see
+ParserPool.
+
 Public Interface:
 =================
-ConfigParseToConsole conConfig;
+ConfigParseToConsole conConfig;   // or conConfig(true), for own Repository
 conConfig.Build();
+conConfig.UseCache(&cache);        // before Attach(), see SemiCache
+conConfig.Pipeline(8);             // lex on a second thread, 8 batches ahead
+SemiPipe* pPipe = conConfig.Pipe();   // its statistics, 0 if not piped
+SemiExp* pSemi = conConfig.Semi();    // what the parser parses, after Build()
+Repository* pRepos = conConfig.Repos();  // what its actions share
+StaticParser1* pStatic = conConfig.BuildStatic();  // instead of Build()
 conConfig.Attach(someFileName);
 
 Build Process:
@@ -40,6 +62,18 @@ semiexpression.cpp tokenizer.cpp /link setargv.obj
 
 Maintenance History:
 ====================
+ver 2.6 : 17 Oct 26
+- added the ownRepository constructor argument, and Repos()
+ver 2.5 : 17 Oct 26
+- added Semi(), so a deferred pass 2 parser can share the SemiExp
+ver 2.4 : 17 Oct 26
+- added BuildStatic(), and the rule list of its StaticParser
+ver 2.3 : 17 Oct 26
+- added Pipeline() and Pipe(), to lex on a producer thread
+ver 2.2 : 17 Oct 26
+- replaced Record() with UseCache(), Attach() replays a stored recording
+ver 2.1 : 17 Oct 26
+- added Record(), so pass 2 can replay this pass's semi-expressions
 ver 2.0 : 01 Jun 11
 - Major revisions to begin building a strong code analyzer
 ver 1.1 : 01 Feb 06
@@ -54,6 +88,27 @@ ver 1.0 : 12 Jan 06
 #include "Tokenizer.h"
 #include "ActionsAndRules.h"
 #include "FoldingRules.h"
+#include "StaticParser.h"
+
+class SemiCache;
+class SemiPipe;
+
+///////////////////////////////////////////////////////////////
+// pass 1 rules and actions, in the order Build() adds them
+
+typedef RuleList<StaticRule<BeginningOfScope, HandlePush>,
+        RuleList<StaticRule<EndOfScope, HandlePop>,
+        RuleList<StaticRule<PreprocStatement, PrintPreproc>,
+        RuleList<StaticRule<ClassDefinition, PushClass>,
+        RuleList<StaticRule<EnumStatement, PrintEnum>,
+        RuleList<StaticRule<FunctionDefinition, PushFunction>,
+        RuleList<StaticRule<StructDefinition, PushStruct>,
+        RuleList<StaticRule<TypedefStatement, PrintTypedef>,
+        RuleList<StaticRule<UnionDefinition, PushUnion>,
+        RuleList<StaticRule<GlobalFunctionDefinition, PushGlobalFunction>,
+        NoRules> > > > > > > > > > Pass1Rules;
+
+typedef StaticParser<SemiExp, Pass1Rules> StaticParser1;
 
 ///////////////////////////////////////////////////////////////
 // build parser that writes its output to console
@@ -63,19 +118,35 @@ ver 1.0 : 12 Jan 06
 class ConfigParseToConsole : IBuilder
 {
 public:
-	ConfigParseToConsole() {};
+	ConfigParseToConsole(bool ownRepository_ = false) : pToker(0), pSemi(0), pParser(0), pStatic(0),
+		pCache(0), pPipeToker(0), pPipeSemi(0), pPipe(0), pRepos(0), ownRepository(ownRepository_),
+		pFR(0) {};
 	~ConfigParseToConsole();
 	bool Attach(const std::string& name, bool isFile=true);
+	void UseCache(SemiCache* pCache);
+	void Pipeline(size_t numSlots);
+	SemiPipe* Pipe();
+	SemiExp* Semi();
+	Repository* Repos();
 	Parser* Build();
+	StaticParser1* BuildStatic();
 
 
 private:
+	void BuildInput();
+
 	// Builder must hold onto all the pieces
 
 	Toker* pToker;
 	SemiExp* pSemi;
 	Parser* pParser;
-	//Repository* pRepo;
+	StaticParser1* pStatic;
+	SemiCache* pCache;
+	Toker* pPipeToker;                 // producer's parts, if piped
+	SemiExp* pPipeSemi;
+	SemiPipe* pPipe;
+	Repository* pRepos;                // pRepo, unless ownRepository
+	bool ownRepository;
 
 	// add folding rules
 
@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////
 // ConfigureParserRelat.cpp - builds and configures parsers  //
-// Ver 2.0                                                   //
+// Ver 2.8                                                   //
 // Language:    Visual C++ 2012                              //
 // Platform:    Dell E6510, Windows 7                        //
 // Application: CSE687 - OOD, Pr#1, Spring 2013              //
@@ -20,6 +20,8 @@
 #include "SemiExpression.h"
 #include "Tokenizer.h"
 #include "ActionsAndRules.h"
+#include "SemiCache.h"
+#include "SemiPipe.h"
 #include "ConfigureParserRelat.h"
 
 extern Repository* pRepo;
@@ -30,34 +32,43 @@ ConfigParseToConsoleRelat::~ConfigParseToConsoleRelat()
 {
 	// when Builder goes out of scope, everything must be deallocated
 	delete pFR;
-	//delete pRepo;
+	if(ownRepository)
+		delete pRepos;
 	delete pParser;
+	delete pStatic;
+	delete pPipe;
+	delete pPipeSemi;
+	delete pPipeToker;
 	delete pSemi;
 	delete pToker;
 
-	delete pHandlePush;
-	delete pBeginningOfScope;
-	delete pHandlePop;
-	delete pEndOfScope;
-
-	//delete pCompositionOpportunity;
-	//delete pUsingOpportunity;
-	//delete pAggregationOpportunity;
-	delete pInheritanceOpportunity;
-
-	delete pClassDefinition;
-	delete pClassScope;
-	delete pEnumStatement;
-	delete pEnumScope;
-
-	delete pFunctionDefinition;
-	delete pPushFunction;
-	delete pStructDefinition;
-	delete pStructScope;
-	delete pVarDeclaration;
-	delete pPushVarDecl;
-	delete pGlobalVarDeclaration;
-	delete pPushGlobalVarDecl;
+	// rules and actions exist only if Build() was called
+	if(pParser)
+	{
+		delete pHandlePush;
+		delete pBeginningOfScope;
+		delete pHandlePop;
+		delete pEndOfScope;
+
+		//delete pCompositionOpportunity;
+		//delete pUsingOpportunity;
+		//delete pAggregationOpportunity;
+		delete pInheritanceOpportunity;
+
+		delete pClassDefinition;
+		delete pClassScope;
+		delete pEnumStatement;
+		delete pEnumScope;
+
+		delete pFunctionDefinition;
+		delete pPushFunction;
+		delete pStructDefinition;
+		delete pStructScope;
+		delete pVarDeclaration;
+		delete pPushVarDecl;
+		delete pGlobalVarDeclaration;
+		delete pPushGlobalVarDecl;
+	}
 }
 //----< attach toker to a file stream or stringstream >------------
 
@@ -67,52 +78,139 @@ bool ConfigParseToConsoleRelat::Attach(const std::string& name, bool isFile)
 {
 	if(pToker == 0)
 		return false;
+	pSemi->replay(0);
+	if(pPipe)
+		pPipe->stop();      // in case last file wasn't parsed to its end
+	if(pCache && isFile)
+	{
+		// replay semi-expressions pass 1 recorded, if it finished the file
+		SemiRecording* pRec = pCache->find(name);
+		if(pRec)
+		{
+			pSemi->replay(pRec);
+			return true;
+		}
+	}
+	if(pPipe && isFile)
+	{
+		pSemi->pipe(pPipe);
+		return pPipe->start(name);
+	}
 	return pToker->attach(name, isFile);
+}
+//----< replay semi-expressions in cache >-------------------------
+
+void ConfigParseToConsoleRelat::UseCache(SemiCache* pCache_)
+{
+	pCache = pCache_;
 }
+//----< read and tokenize files on a producer thread >-------------
+/*
+ *  The producer's toker and SemiExp are configured like the parser's.
+ */
+void ConfigParseToConsoleRelat::Pipeline(size_t numSlots)
+{
+	if(pPipe)
+		return;
+	pPipeToker = new Toker;
+	pPipeToker->returnComments(false);
+	pPipeToker->mapInput();
+	pPipeToker->lexInParallel();
+	pPipeSemi = new SemiExp(pPipeToker);
+	pPipeSemi->returnNewLines(false);
+	pPipe = new SemiPipe(pPipeToker, pPipeSemi, numSlots);
+}
+//----< pipe feeding the parser, 0 if not piped >------------------
+
+SemiPipe* ConfigParseToConsoleRelat::Pipe()
+{
+	return pPipe;
+}
+//----< repository the actions share, 0 before Build() >-----------
+
+Repository* ConfigParseToConsoleRelat::Repos()
+{
+	return pRepos;
+}
+//----< parts both Build() and BuildStatic() need >---------------
+
+void ConfigParseToConsoleRelat::BuildInput()
+{
+	pToker = new Toker;
+	pToker->returnComments(false);
+	pToker->mapInput();
+	pToker->lexInParallel();
+	pSemi = new SemiExp(pToker);
+	pSemi->returnNewLines(false);
+	pFR = new codeFoldingRules;
+	if(ownRepository)
+	{
+		pRepos = new Repository(pToker);
+		pRepos->symbolTable() = pRepo->symbolTable();   // types pass 1 found
+		pRepos->symbolTable().resetLookupCounts();      // ParserPool adds them to pRepo's
+	}
+	else
+		pRepos = pRepo;
+}
+//----< same rules and actions as Build(), in a StaticParser >-----
+/*
+ *  Uses the Repository pass 1 built.
+ */
+StaticParser2* ConfigParseToConsoleRelat::BuildStatic()
+{
+	try
+	{
+		BuildInput();
+		pStatic = new StaticParser2(pSemi, pRepos);
+		pStatic->addFoldingRules(pFR);
+		return pStatic;
+	}
+	catch(std::exception& ex)
+	{
+		std::cout << "\n\n  " << ex.what() << "\n\n";
+		return 0;
+	}
+}
 //----< Here's where alll the parts get assembled >----------------
 
 Parser* ConfigParseToConsoleRelat::Build()
 {
 	try
 	{   // add Parser's main parts
-		pToker = new Toker;
-		pToker->returnComments(false);
-		pSemi = new SemiExp(pToker);
-		pSemi->returnNewLines(false);
+		BuildInput();
 		pParser = new Parser(pSemi);
 
 		// add code folding rules
-		pFR = new codeFoldingRules;
 		pParser->addFoldingRules(pFR);
 
 		// configure to manage scope
-		pBeginningOfScope = new BeginningOfScope();	pHandlePush = new HandlePush(pRepo);
+		pBeginningOfScope = new BeginningOfScope();	pHandlePush = new HandlePush(pRepos);
 		pBeginningOfScope->addAction(pHandlePush);	pParser->addRule(pBeginningOfScope);
-		pEndOfScope = new EndOfScope();	pHandlePop = new HandlePop(pRepo);
+		pEndOfScope = new EndOfScope();	pHandlePop = new HandlePop(pRepos);
 		pEndOfScope->addAction(pHandlePop);	pParser->addRule(pEndOfScope);
 
 		// Rules and actions to push types on scope stack	
-		pClassDefinition = new ClassDefinition;	pClassScope = new ClassScope(pRepo);  
+		pClassDefinition = new ClassDefinition;	pClassScope = new ClassScope(pRepos);  
 		pClassDefinition->addAction(pClassScope);	pParser->addRule(pClassDefinition);
-		pEnumStatement = new EnumStatement();	pEnumScope = new EnumScope(pRepo);
+		pEnumStatement = new EnumStatement();	pEnumScope = new EnumScope(pRepos);
 		pEnumStatement->addAction(pEnumScope);	pParser->addRule(pEnumStatement);
-		pFunctionDefinition = new FunctionDefinition;	pPushFunction = new PushFunction(pRepo);  
+		pFunctionDefinition = new FunctionDefinition;	pPushFunction = new PushFunction(pRepos);  
 		pFunctionDefinition->addAction(pPushFunction);	pParser->addRule(pFunctionDefinition);
-		pStructDefinition = new StructDefinition;	pStructScope = new StructScope(pRepo);  
+		pStructDefinition = new StructDefinition;	pStructScope = new StructScope(pRepos);  
 		pStructDefinition->addAction(pStructScope);	pParser->addRule(pStructDefinition);
 
 		//Project 2 configurations (Rules 3.a. through 3.e.)
-		pVarDeclaration = new VarDeclaration(pRepo);		pPushVarDecl = new PushVarDecl(pRepo);  
+		pVarDeclaration = new VarDeclaration(pRepos);		pPushVarDecl = new PushVarDecl(pRepos);  
 		pVarDeclaration->addAction(pPushVarDecl);		pParser->addRule(pVarDeclaration);
-		pReturnType = new ReturnType(pRepo);		pPushReturnType = new PushReturnType(pRepo);  
+		pReturnType = new ReturnType(pRepos);		pPushReturnType = new PushReturnType(pRepos);  
 		pReturnType->addAction(pPushReturnType);		pParser->addRule(pReturnType);
-		pCallingParam = new CallingParam(pRepo);		pPushCallingParam = new PushCallingParam(pRepo);  
+		pCallingParam = new CallingParam(pRepos);		pPushCallingParam = new PushCallingParam(pRepos);  
 		pCallingParam->addAction(pPushCallingParam);		pParser->addRule(pCallingParam);		
-		pInheritanceOpportunity = new InheritanceOpportunity();	pPrintInheritance = new PrintInheritance(pRepo);
+		pInheritanceOpportunity = new InheritanceOpportunity();	pPrintInheritance = new PrintInheritance(pRepos);
 		pInheritanceOpportunity->addAction(pPrintInheritance);	pParser->addRule(pInheritanceOpportunity);				
-		pGlobalFuncCall = new GlobalFuncCall(pRepo);		pPushGlobalFuncCall = new PushGlobalFuncCall(pRepo);  
+		pGlobalFuncCall = new GlobalFuncCall(pRepos);		pPushGlobalFuncCall = new PushGlobalFuncCall(pRepos);  
 		pGlobalFuncCall->addAction(pPushGlobalFuncCall);		pParser->addRule(pGlobalFuncCall);		
-		pGlobalVarDeclaration = new GlobalVarDeclaration(pRepo);		pPushGlobalVarDecl = new PushGlobalVarDecl(pRepo);  
+		pGlobalVarDeclaration = new GlobalVarDeclaration(pRepos);		pPushGlobalVarDecl = new PushGlobalVarDecl(pRepos);  
 		pGlobalVarDeclaration->addAction(pPushGlobalVarDecl);		pParser->addRule(pGlobalVarDeclaration);
 		return pParser;
 	}
@@ -122,6 +220,63 @@ Parser* ConfigParseToConsoleRelat::Build()
 	}
 }
 
+//----< destructor releases the deferred parser's parts >-----------
+
+ConfigDeferredRelat::~ConfigDeferredRelat()
+{
+	delete pParser;
+	for(size_t i=0; i<rules.size(); ++i)
+	{
+		delete rules[i];
+		delete actions[i];
+	}
+	delete pScopes;
+}
+//----< register rule, with its action, and keep both >------------
+
+void ConfigDeferredRelat::add(IRule* pRule, IAction* pAction)
+{
+	rules.push_back(pRule);
+	actions.push_back(pAction);
+	pRule->addAction(pAction);
+	pParser->addRule(pRule);
+}
+//----< Build()'s rules, in its order, deferring type lookups >----
+/*
+ *  Call after pass 1's Build(), which creates pRepo.  pTc is folded
+ *  and summarized by pass 1's parser, so this one doesn't get or
+ *  fold, and is used only for parse().
+ */
+Parser* ConfigDeferredRelat::Build()
+{
+	try
+	{
+		pScopes = new Repository(pRepo->Toker());
+		pParser = new Parser(pTc);
+
+		// configure to manage scope, as Build() does
+		add(new BeginningOfScope, new HandlePush(pScopes));
+		add(new EndOfScope, new HandlePop(pScopes));
+		add(new ClassDefinition, new ClassScope(pScopes));
+		add(new EnumStatement, new EnumScope(pScopes));
+		add(new FunctionDefinition, new PushFunction(pScopes));
+		add(new StructDefinition, new StructScope(pScopes));
+
+		// Rules 3.a. through 3.e., recording type references
+		add(new DeferredVarDeclaration(pScopes), new DeferVarDecl(pScopes, pRefs));
+		add(new DeferredReturnType(pScopes), new DeferReturnType(pScopes, pRefs));
+		add(new DeferredCallingParam(pScopes), new DeferCallingParam(pScopes, pRefs));
+		add(new InheritanceOpportunity, new DeferInheritance(pScopes, pRefs));
+		add(new DeferredGlobalFuncCall(pScopes), new DeferGlobalFuncCall(pScopes, pRefs));
+		add(new GlobalVarDeclaration(pScopes), new DeferGlobalVarDecl(pScopes, pRefs));
+		return pParser;
+	}
+	catch(std::exception& ex)
+	{	std::cout << "\n\n  " << ex.what() << "\n\n";
+	return 0;
+	}
+}
+
 #ifdef TEST_CONFIGUREPARSERRELAT
 
 #include <queue>
@@ -178,3 +333,128 @@ int main(int argc, char* argv[])
 }
 
 #endif
+
+//----< benchmark stub >---------------------------------------------
+/*
+ *  Generates files whose code is nested depth scopes deep, structs in
+ *  structs around a member function, finds their types with pass 1,
+ *  and times pass 2's rules on them.  Each file has the same
+ *  statements at each depth, in the innermost function, so the time
+ *  per statement shouldn't grow with the depth, as it did when rules
+ *  copied the scope stack.
+ */
+#ifdef BENCH_CONFIGUREPARSERRELAT
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <algorithm>
+#include "ConfigureParser.h"
+#include "GraphSingleton.h"
+#include "Timer.h"
+
+//----< write file k of n, nested depth scopes deep >----------------
+
+std::string nestedFile(size_t depth, size_t k, size_t n, size_t statements)
+{
+	std::ostringstream name;
+	name << "nested_" << depth << "_" << k << ".cpp";
+	std::ofstream out(name.str().c_str());
+	out << "class Widget" << k << " { public: int x; };\n";
+	out << "namespace N" << k << " {\n";
+	for(size_t d=0; d+1<depth; ++d)
+	{
+		out << std::string(2 * d, ' ') << "struct S" << k << "_" << d;
+		if(d % 8 == 0)
+			out << " : public Widget" << (k + 1) % n;
+		out << " {\n";
+	}
+	std::string indent(2 * depth, ' ');
+	out << std::string(2 * (depth - 1), ' ') << "void f(Widget" << (k + 2) % n << " w) {\n";
+	for(size_t i=0; i<statements; ++i)
+	{
+		size_t other = (k + i) % n;
+		switch(i % 4)
+		{
+		case 0: out << indent << "Widget" << other << " v" << i << ";\n"; break;
+		case 1: out << indent << "Widget" << other << "* p" << i << " = new Widget" << other << ";\n"; break;
+		case 2: out << indent << "use(v" << i - 2 << ", w);\n"; break;
+		case 3: out << indent << "int n" << i << " = v" << i - 3 << ".x + " << i << ";\n"; break;
+		}
+	}
+	for(size_t d=depth; d>0; --d)
+		out << std::string(2 * (d - 1), ' ') << (d == 1 ? "}\n" : "};\n");
+	return name.str();
+}
+//----< parse all files, returning seconds taken >-------------------
+
+template<class Config>
+double parseFiles(Config& configure, Parser* pParser, std::vector<std::string>& files)
+{
+	Timer timer;
+	for(size_t i=0; i<files.size(); ++i)
+	{
+		try
+		{
+			if(!configure.Attach(files[i]))
+				continue;
+			GraphSingleton::getInstance()->setCurrentFilename(files[i]);
+			while(pParser->next())
+				pParser->parse();
+		}
+		catch(std::exception&) {}
+	}
+	return timer.elapsed();
+}
+
+int main()
+{
+	std::cout << "\n  Benchmarking pass 2 rules by nesting depth\n "
+		<< std::string(43,'=') << std::endl;
+
+	const size_t numFiles = 20, statements = 400, numRuns = 3;
+	size_t depths[] = { 1, 8, 32, 128, 256 };
+	std::cout << "\n  " << numFiles << " files, " << statements
+		<< " statements in the innermost scope of each, best of " << numRuns << "\n";
+	std::cout << "\n  depth   pass 2 ms   us per statement   edges";
+	std::ostringstream sink;
+	std::streambuf* pCout = std::cout.rdbuf();
+	double firstPerStatement = 0, lastPerStatement = 0;
+	for(size_t d=0; d<sizeof(depths)/sizeof(depths[0]); ++d)
+	{
+		std::vector<std::string> files;
+		for(size_t k=0; k<numFiles; ++k)
+			files.push_back(nestedFile(depths[d], k, numFiles, statements));
+		double best = 1e9;
+		size_t edges = 0;
+		for(size_t run=0; run<numRuns; ++run)
+		{
+			GraphSingleton::getInstance()->clear();
+			std::cout.rdbuf(sink.rdbuf());
+			ConfigParseToConsole pass1;
+			parseFiles(pass1, pass1.Build(), files);
+			ConfigParseToConsoleRelat pass2;
+			best = std::min(best, parseFiles(pass2, pass2.Build(), files));
+			std::cout.rdbuf(pCout);
+			sink.str("");
+			graph& g = GraphSingleton::getInstance()->getGraph();
+			edges = 0;
+			for(size_t v=0; v<g.size(); ++v)
+				edges += g[v].size();
+		}
+		for(size_t k=0; k<files.size(); ++k)
+			std::remove(files[k].c_str());
+		double perStatement = 1e6 * best / (numFiles * statements);
+		if(d == 0)
+			firstPerStatement = perStatement;
+		lastPerStatement = perStatement;
+		std::cout << std::fixed << std::setprecision(2) << "\n  " << std::setw(5) << depths[d]
+			<< std::setw(12) << 1000 * best << std::setw(19) << perStatement
+			<< std::setw(8) << edges;
+	}
+	std::cout << "\n\n  deepest costs " << lastPerStatement / firstPerStatement
+		<< " times as much per statement as depth 1\n\n";
+}
+
+#endif
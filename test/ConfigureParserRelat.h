@@ -2,7 +2,7 @@
 #define CONFIGUREPARSERRELAT_H
 ///////////////////////////////////////////////////////////////
 // ConfigureParserRelat.h - builds and configures parsers    //
-// Ver 2.0                                                   //
+// Ver 2.8                                                   //
 // Language:    Visual C++ 2012                              //
 // Platform:    Dell E6510, Windows 7                        //
 // Application: CSE687 - OOD, Pr#1, Spring 2013              //
@@ -20,11 +20,39 @@ Module Operations:
 This module builds and configures parsers.  It builds the parser
 parts and configures them with application specific rules and actions.
 
+When given a SemiCache, Attach() replays the semi-expressions pass 1
+recorded for a file, instead of tokenizing it again.
+
+With Pipeline(), files that aren't replayed are read and tokenized on
+a second thread, while the parser applies its rules, see SemiPipe.
+
+BuildStatic() builds the same parts, but instead of a Parser, a
+StaticParser applying the same rules and actions, in the same order,
+without virtual calls, see the StaticParser module.
+
+Like pass 1's, the rules and actions share pRepo, for the types pass
+1 found and for its scope stack.  A builder constructed with
+ownRepository true gives them their own Repository, with a copy of
+pRepo's symbol table, so several can parse at once, see ParserPool.
+
+ConfigDeferredRelat builds a parser that runs along with pass 1, on
+the SemiExp of pass 1's builder: its rules are the deferred versions
+of the pass 2 rules, which record TypeRefs instead of adding edges,
+see the TypeRefs module.  It keeps its own scope stack, which starts
+empty, as pass 2's does when pass 1 ends with every scope closed.
+
 Public Interface:
 =================
 ConfigParseToConsole conConfig;
 conConfig.Build();
+conConfig.UseCache(&cache);        // before Attach(), see SemiCache
+conConfig.Pipeline(8);             // lex on a second thread, 8 batches ahead
+SemiPipe* pPipe = conConfig.Pipe();   // its statistics, 0 if not piped
+StaticParser2* pStatic = conConfig.BuildStatic();  // instead of Build()
+Repository* pRepos = conConfig.Repos();  // what its actions share
 conConfig.Attach(someFileName);
+ConfigDeferredRelat deferred(pass1Config.Semi(), &typeRefs);
+Parser* pDeferred = deferred.Build();  // parse() after pass 1's parse()
 
 Build Process:
 ==============
@@ -37,9 +65,31 @@ Build commands (either one)
 - cl /EHsc /DTEST_PARSER ConfigureParser.cpp parser.cpp \
 ActionsAndRules.cpp \
 semiexpression.cpp tokenizer.cpp /link setargv.obj
+- cl /EHsc /O2 /DBENCH_CONFIGUREPARSERRELAT ConfigureParserRelat.cpp,
+and the other .cpp files Submission.vcxproj compiles, except
+Executive.cpp
 
 Maintenance History:
 ====================
+ver 2.8 : 17 Oct 26
+- a builder's copy of pRepo's symbol table starts with no lookup counts
+ver 2.7 : 17 Oct 26
+- added BENCH_CONFIGUREPARSERRELAT, timing pass 2 on generated files
+by nesting depth
+ver 2.6 : 17 Oct 26
+- added the ownRepository constructor argument, and Repos()
+ver 2.5 : 17 Oct 26
+- added ConfigDeferredRelat, to record pass 2 type references while
+pass 1 parses
+ver 2.4 : 17 Oct 26
+- added BuildStatic(), and the rule list of its StaticParser
+ver 2.3 : 17 Oct 26
+- added Pipeline() and Pipe(), to lex on a producer thread
+ver 2.2 : 17 Oct 26
+- replaced Replay() with UseCache(), Attach() replays cached recordings
+ver 2.1 : 17 Oct 26
+- added Replay(), which parses semi-expressions recorded by pass 1
+instead of tokenizing the file again
 ver 2.0 : 01 Jun 11
 - Major revisions to begin building a strong code analyzer
 ver 1.1 : 01 Feb 06
@@ -54,6 +104,29 @@ ver 1.0 : 12 Jan 06
 #include "Tokenizer.h"
 #include "ActionsAndRules.h"
 #include "FoldingRules.h"
+#include "StaticParser.h"
+
+class SemiCache;
+class SemiPipe;
+
+///////////////////////////////////////////////////////////////
+// pass 2 rules and actions, in the order Build() adds them
+
+typedef RuleList<StaticRule<BeginningOfScope, HandlePush>,
+        RuleList<StaticRule<EndOfScope, HandlePop>,
+        RuleList<StaticRule<ClassDefinition, ClassScope>,
+        RuleList<StaticRule<EnumStatement, EnumScope>,
+        RuleList<StaticRule<FunctionDefinition, PushFunction>,
+        RuleList<StaticRule<StructDefinition, StructScope>,
+        RuleList<StaticRule<VarDeclaration, PushVarDecl>,
+        RuleList<StaticRule<ReturnType, PushReturnType>,
+        RuleList<StaticRule<CallingParam, PushCallingParam>,
+        RuleList<StaticRule<InheritanceOpportunity, PrintInheritance>,
+        RuleList<StaticRule<GlobalFuncCall, PushGlobalFuncCall>,
+        RuleList<StaticRule<GlobalVarDeclaration, PushGlobalVarDecl>,
+        NoRules> > > > > > > > > > > > Pass2Rules;
+
+typedef StaticParser<SemiExp, Pass2Rules> StaticParser2;
 
 ///////////////////////////////////////////////////////////////
 // build parser that writes its output to console
@@ -61,19 +134,34 @@ ver 1.0 : 12 Jan 06
 class ConfigParseToConsoleRelat : IBuilder
 {
 public:
-	ConfigParseToConsoleRelat() {};
+	ConfigParseToConsoleRelat(bool ownRepository_ = false) : pToker(0), pSemi(0), pParser(0),
+		pStatic(0), pCache(0), pPipeToker(0), pPipeSemi(0), pPipe(0), pRepos(0),
+		ownRepository(ownRepository_), pFR(0) {};
 	~ConfigParseToConsoleRelat();
 	bool Attach(const std::string& name, bool isFile=true);
+	void UseCache(SemiCache* pCache);
+	void Pipeline(size_t numSlots);
+	SemiPipe* Pipe();
+	Repository* Repos();
 	Parser* Build();
+	StaticParser2* BuildStatic();
 
 
 private:
+	void BuildInput();
+
 	// Builder must hold onto all the pieces
 
 	Toker* pToker;
 	SemiExp* pSemi;
 	Parser* pParser;
-	//Repository* pRepo;
+	StaticParser2* pStatic;
+	SemiCache* pCache;
+	Toker* pPipeToker;                 // producer's parts, if piped
+	SemiExp* pPipeSemi;
+	SemiPipe* pPipe;
+	Repository* pRepos;                // pRepo, unless ownRepository
+	bool ownRepository;
 
 	// add folding rules
 
@@ -126,5 +214,30 @@ private:
 	ConfigParseToConsoleRelat& operator=(const ConfigParseToConsoleRelat&);
 };
 
+///////////////////////////////////////////////////////////////
+// build parser recording pass 2 type references during pass 1
+
+class ConfigDeferredRelat : IBuilder
+{
+public:
+	ConfigDeferredRelat(ITokCollection* pTc_, TypeRefs* pRefs_)
+		: pTc(pTc_), pRefs(pRefs_), pScopes(0), pParser(0) {};
+	~ConfigDeferredRelat();
+	Parser* Build();
+
+private:
+	void add(IRule* pRule, IAction* pAction);
+
+	ITokCollection* pTc;               // pass 1's collection
+	TypeRefs* pRefs;
+	Repository* pScopes;               // pass 2 scope stack
+	Parser* pParser;
+	std::vector<IRule*> rules;         // rules and actions, in order
+	std::vector<IAction*> actions;
+
+	// prohibit copies and assignments
+	ConfigDeferredRelat(const ConfigDeferredRelat&);
+	ConfigDeferredRelat& operator=(const ConfigDeferredRelat&);
+};
 
 #endif
@@ -0,0 +1,427 @@
+///////////////////////////////////////////////////////////////
+// CsrGraph.cpp - read only graph in compressed sparse rows  //
+// Ver 1.1                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <unordered_set>
+#include "CsrGraph.h"
+
+//----< empty graph >------------------------------------------------
+
+CsrGraph::CsrGraph() : offsets(1, 0), textOffsets(1, 0) {}
+
+//----< copy of g, vertex v of g is vertex v of the copy >-----------
+
+CsrGraph::CsrGraph(GraphLib::Graph<node, RelKind>& g) : offsets(1, 0), textOffsets(1, 0)
+{
+	size_t numEdges = 0;
+	for(size_t v=0; v<g.size(); ++v)
+		numEdges += g[v].size();
+	offsets.reserve(g.size() + 1);
+	textOffsets.reserve(g.size() + 1);
+	ids.reserve(g.size());
+	targets.reserve(numEdges);
+	labels.reserve(numEdges);
+	for(size_t v=0; v<g.size(); ++v)
+	{
+		GraphLib::Vertex<node, RelKind>& vert = g[v];
+		addVertex(vert.value().payload, vert.id());
+		for(size_t i=0; i<vert.size(); ++i)
+			addEdge((Index)vert[i].first, vert[i].second);
+	}
+}
+//----< append vertex, with no edges yet >---------------------------
+
+void CsrGraph::addVertex(const StrView& payload, size_t id)
+{
+	text.append(payload.data(), payload.size());
+	textOffsets.push_back((unsigned)text.size());
+	ids.push_back(id);
+	offsets.push_back(offsets.back());
+}
+//----< append edge of the last vertex >-----------------------------
+
+void CsrGraph::addEdge(Index child, RelKind label)
+{
+	targets.push_back(child);
+	labels.push_back(label);
+	++offsets.back();
+}
+//----< bytes held by the graph's arrays >---------------------------
+
+size_t CsrGraph::bytes() const
+{
+	size_t n = sizeof(*this) + text.capacity();
+	n += offsets.capacity() * sizeof(unsigned) + textOffsets.capacity() * sizeof(unsigned);
+	n += targets.capacity() * sizeof(Index) + labels.capacity() * sizeof(RelKind);
+	n += ids.capacity() * sizeof(size_t);
+	return n;
+}
+//----< strongly connected components, by Tarjan's algorithm >-------
+/*
+ *  The recursion of strongConnect() is kept on a stack of its own,
+ *  each frame a vertex and the next of its edges to follow, so deep
+ *  graphs can't overflow the call stack.
+ */
+std::vector<std::vector<CsrGraph::Index> > strongComponents(const CsrGraph& g)
+{
+	typedef CsrGraph::Index Index;
+	const Index none = (Index)-1;
+	std::vector<Index> index(g.size(), none), lowIndex(g.size(), none);
+	std::vector<bool> onStack(g.size(), false);
+	std::vector<Index> stk;
+	std::vector<std::pair<Index, size_t> > frames;
+	std::vector<std::vector<Index> > sccs;
+	Index next = 0;
+
+	for(Index root=0; root<g.size(); ++root)
+	{
+		if(index[root] != none)
+			continue;
+		index[root] = lowIndex[root] = next++;
+		stk.push_back(root);
+		onStack[root] = true;
+		frames.push_back(std::make_pair(root, g.edgesBegin(root)));
+		while(!frames.empty())
+		{
+			Index v = frames.back().first;
+			size_t e = frames.back().second;
+			if(e < g.edgesEnd(v))
+			{
+				frames.back().second = e + 1;
+				Index w = g.target(e);
+				if(index[w] == none)
+				{
+					index[w] = lowIndex[w] = next++;
+					stk.push_back(w);
+					onStack[w] = true;
+					frames.push_back(std::make_pair(w, g.edgesBegin(w)));
+				}
+				else if(onStack[w])
+					lowIndex[v] = std::min(lowIndex[v], index[w]);
+				continue;
+			}
+			frames.pop_back();
+			if(lowIndex[v] == index[v])
+			{
+				std::vector<Index> scc;
+				Index w;
+				do
+				{
+					w = stk.back();
+					stk.pop_back();
+					onStack[w] = false;
+					scc.push_back(w);
+				} while(w != v);
+				sccs.push_back(scc);
+			}
+			if(!frames.empty())
+			{
+				Index parent = frames.back().first;
+				lowIndex[parent] = std::min(lowIndex[parent], lowIndex[v]);
+			}
+		}
+	}
+	return sccs;
+}
+//----< graph of the components, joined by their edges >-------------
+/*
+ *  Like GraphXml::condensedGraph(), components are added as the edges
+ *  of g's vertices are met, so a component with no edges in or out is
+ *  left out, and each edge between two components is labeled
+ *  "relationship".
+ */
+CsrGraph condense(const CsrGraph& g, const std::vector<std::vector<CsrGraph::Index> >& sccs)
+{
+	typedef CsrGraph::Index Index;
+	const Index none = (Index)-1;
+	std::vector<Index> sccOf(g.size(), none);
+	for(size_t c=0; c<sccs.size(); ++c)
+		for(size_t i=0; i<sccs[c].size(); ++i)
+			sccOf[sccs[c][i]] = (Index)c;
+
+	std::vector<Index> vertexOf(sccs.size(), none);     // component to condensed vertex
+	std::vector<Index> order;                           // condensed vertex to component
+	std::vector<std::vector<Index> > children;
+	std::unordered_set<unsigned long long> edges;
+	for(Index v=0; v<g.size(); ++v)
+	{
+		for(size_t e=g.edgesBegin(v); e<g.edgesEnd(v); ++e)
+		{
+			Index comps[2] = { sccOf[v], sccOf[g.target(e)] };
+			for(int k=0; k<2 && (k == 0 || comps[1] != comps[0]); ++k)
+			{
+				if(vertexOf[comps[k]] == none)
+				{
+					vertexOf[comps[k]] = (Index)order.size();
+					order.push_back(comps[k]);
+					children.push_back(std::vector<Index>());
+				}
+			}
+			if(comps[0] == comps[1])
+				continue;
+			unsigned long long key = ((unsigned long long)comps[0] << 32) | comps[1];
+			if(edges.insert(key).second)
+				children[vertexOf[comps[0]]].push_back(vertexOf[comps[1]]);
+		}
+	}
+
+	CsrGraph dag;
+	const RelKind label = rel_relationship;
+	for(size_t c=0; c<order.size(); ++c)
+	{
+		const std::vector<Index>& scc = sccs[order[c]];
+		std::string collapsed;
+		for(size_t i=0; i<scc.size(); ++i)
+			collapsed += g.payload(scc[i]).str() + ";";
+		dag.addVertex(collapsed, order[c]);
+		for(size_t i=0; i<children[c].size(); ++i)
+			dag.addEdge(children[c][i], label);
+	}
+	return dag;
+}
+//----< vertices, children before parents, false if g has a cycle >--
+/*
+ *  Depth first from each vertex not yet visited, in vertex order, as
+ *  TopoSort::topoSort() visits them.  A vertex still being visited
+ *  when met again closes a cycle: it isn't followed, and the order is
+ *  no topological sort.
+ */
+bool topologicalSort(const CsrGraph& g, std::vector<CsrGraph::Index>& order)
+{
+	typedef CsrGraph::Index Index;
+	std::vector<marking> mark(g.size(), unvisited);
+	std::vector<std::pair<Index, size_t> > frames;
+	bool isDag = true;
+	order.clear();
+	order.reserve(g.size());
+
+	for(Index root=0; root<g.size(); ++root)
+	{
+		if(mark[root] != unvisited)
+			continue;
+		mark[root] = temporary;
+		frames.push_back(std::make_pair(root, g.edgesBegin(root)));
+		while(!frames.empty())
+		{
+			Index v = frames.back().first;
+			size_t e = frames.back().second;
+			if(e < g.edgesEnd(v))
+			{
+				frames.back().second = e + 1;
+				Index w = g.target(e);
+				if(mark[w] == unvisited)
+				{
+					mark[w] = temporary;
+					frames.push_back(std::make_pair(w, g.edgesBegin(w)));
+				}
+				else if(mark[w] == temporary)
+					isDag = false;
+				continue;
+			}
+			frames.pop_back();
+			mark[v] = permanent;
+			order.push_back(v);
+		}
+	}
+	return isDag;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_CSRGRAPH
+
+#include <iostream>
+
+void show(const CsrGraph& g)
+{
+	for(CsrGraph::Index v=0; v<g.size(); ++v)
+	{
+		std::cout << "\n  vertex " << v << ", id = " << g.id(v) << ", " << g.payload(v);
+		for(size_t e=g.edgesBegin(v); e<g.edgesEnd(v); ++e)
+			std::cout << "\n    " << g.label(e) << " " << g.payload(g.target(e));
+	}
+}
+
+int main()
+{
+	std::cout << "\n  Testing CsrGraph\n " << std::string(18,'=') << std::endl;
+
+	typedef GraphLib::Graph<node, RelKind> graph;
+	typedef GraphLib::Vertex<node, RelKind> vertex;
+	graph g;
+	const char* names[] = { "Executive", "Parser", "SemiExp", "Tokenizer", "Display", "Utility" };
+	for(int i=0; i<6; ++i)
+		g.addVertex(vertex(node(names[i])));
+	g.addEdge("uses", g[0], g[1]);
+	g.addEdge("uses", g[0], g[4]);
+	g.addEdge("composes", g[1], g[2]);
+	g.addEdge("composes", g[2], g[3]);
+	g.addEdge("aggregates", g[3], g[1]);      // Parser, SemiExp and Tokenizer are a cycle
+	g.addEdge("uses", g[4], g[2]);
+	g.addEdge("uses", g[3], g[5]);
+
+	CsrGraph csr(g);
+	std::cout << "\n  " << csr.size() << " vertices, " << csr.numEdges() << " edges, "
+		<< csr.bytes() << " bytes";
+	show(csr);
+
+	std::vector<std::vector<CsrGraph::Index> > sccs = strongComponents(csr);
+	std::cout << "\n\n  " << sccs.size() << " strongly connected components:";
+	for(size_t c=0; c<sccs.size(); ++c)
+	{
+		std::cout << "\n    ";
+		for(size_t i=0; i<sccs[c].size(); ++i)
+			std::cout << csr.payload(sccs[c][i]) << " ";
+	}
+
+	CsrGraph dag = condense(csr, sccs);
+	std::cout << "\n\n  condensed graph:";
+	show(dag);
+
+	std::vector<CsrGraph::Index> order;
+	bool isDag = topologicalSort(dag, order);
+	std::cout << "\n\n  topological sort of condensed graph:";
+	for(size_t i=0; i<order.size(); ++i)
+		std::cout << "\n    " << dag.payload(order[i]);
+	std::cout << "\n\n  condensed graph is " << (isDag ? "" : "not ") << "a DAG, full graph is "
+		<< (topologicalSort(csr, order) ? "" : "not ") << "a DAG\n\n";
+}
+
+#endif
+
+//----< benchmark stub >---------------------------------------------
+/*
+ *  Builds a Graph of n vertices, 100000 unless given on the command
+ *  line, with ten edges each, labeled as the parser labels them, and
+ *  reports the heap each representation takes per million edges,
+ *  counted by replacing operator new and delete.  Then it times the
+ *  strong components, condensation and topological sort of GraphXml.h
+ *  and of this module on a graph of n/50 vertices, small enough for
+ *  GraphXml.h's copies of vertices.  Their numbers of components
+ *  differ: TarjanAlgorithm compares a vertex on its stack with the
+ *  graph's by value, lowIndex too, and misses the ones whose lowIndex
+ *  has dropped since they were pushed.
+ */
+#ifdef BENCH_CSRGRAPH
+
+#include <iostream>
+#include <cstdlib>
+#include <sstream>
+#include <new>
+#include "Timer.h"
+
+size_t heapBytes = 0;     // now allocated
+
+void* operator new(size_t n)
+{
+	size_t* p = (size_t*)malloc(n + sizeof(size_t) * 2);
+	if(p == 0)
+		throw std::bad_alloc();
+	*p = n;
+	heapBytes += n;
+	return p + 2;
+}
+
+void operator delete(void* p)
+{
+	if(p == 0)
+		return;
+	size_t* block = (size_t*)p - 2;
+	heapBytes -= *block;
+	free(block);
+}
+
+typedef GraphLib::Graph<node, RelKind> graph;
+typedef GraphLib::Vertex<node, RelKind> vertex;
+typedef GraphXml<node, RelKind> graphXml;
+typedef TarjanAlgorithm<node, RelKind> tarjanAlgorithm;
+typedef TopoSort<node, RelKind> topoSort;
+
+//----< n vertices, each with numEdges edges, some forming cycles >--
+
+void build(graph& g, size_t n, size_t numEdges)
+{
+	const RelKind rels[] = { rel_inherits, rel_composes, rel_aggregates, rel_uses };
+	g.reserve(n);
+	for(size_t i=0; i<n; ++i)
+	{
+		std::ostringstream name;
+		name << "SourceFile" << i;
+		g.addVertex(vertex(node(name.str())));
+	}
+	size_t r = 12345;
+	for(size_t i=0; i<n; ++i)
+		for(size_t k=0; k<numEdges; ++k)
+		{
+			r = r * 1103515245 + 12345;
+			size_t child = (k == 0 && i % 4 == 3) ? i - 3 : (i + 1 + (r >> 8) % 64) % n;
+			g.addEdge(rels[(r >> 4) % 4], g[i], g[child]);
+		}
+}
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Benchmarking CsrGraph\n " << std::string(23,'=') << std::endl;
+	size_t n = argc > 1 ? (size_t)atoi(argv[1]) : 100000;
+	{
+		size_t before = heapBytes;
+		graph g;
+		build(g, n, 10);
+		size_t graphBytes = heapBytes - before;
+		before = heapBytes;
+		CsrGraph csr(g);
+		size_t csrBytes = heapBytes - before;
+		double perMillion = 1e6 / csr.numEdges() / (1 << 20);
+		std::cout.precision(1);
+		std::cout << std::fixed << "\n  " << csr.size() << " vertices, " << csr.numEdges() << " edges";
+		std::cout << "\n  Graph:    " << graphBytes * perMillion << " MB per million edges";
+		std::cout << "\n  CsrGraph: " << csrBytes * perMillion << " MB per million edges, "
+			<< csr.bytes() * perMillion << " MB by bytes()\n";
+	}
+
+	tarjanAlgorithm tarjObj;   // of GraphXml.h
+	topoSort topoObj;
+	graph g;
+	build(g, n / 50, 4);
+	std::cout.precision(4);
+	std::cout << "\n  " << g.size() << " vertices, 4 edges each (seconds)";
+	std::cout << "\n             strong  condense      sort";
+
+	Timer timer;
+	size_t numSccs = tarjObj.tarjan(g).size();
+	double t0 = timer.elapsed();
+	timer.restart();
+	graph condensed = graphXml::condensedGraph(tarjObj.getSCC(), g);
+	double t1 = timer.elapsed();
+	std::streambuf* pCout = std::cout.rdbuf(0);   // reports each cycle it meets
+	timer.restart();
+	topoObj.topoSort(condensed);
+	double t2 = timer.elapsed();
+	std::cout.rdbuf(pCout);
+	std::cout.clear();
+	std::cout << "\n  Graph:   " << std::setw(8) << t0 << std::setw(10) << t1 << std::setw(10) << t2
+		<< "   " << numSccs << " components";
+
+	timer.restart();
+	CsrGraph csr(g);
+	std::vector<std::vector<CsrGraph::Index> > sccs = strongComponents(csr);
+	t0 = timer.elapsed();
+	timer.restart();
+	CsrGraph dag = condense(csr, sccs);
+	t1 = timer.elapsed();
+	timer.restart();
+	std::vector<CsrGraph::Index> order;
+	topologicalSort(dag, order);
+	t2 = timer.elapsed();
+	std::cout << "\n  CsrGraph:" << std::setw(8) << t0 << std::setw(10) << t1 << std::setw(10) << t2
+		<< "   " << sccs.size() << " components, strongComponents includes building it\n\n";
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+///////////////////////////////////////////////////////////////
+// CsrGraph.h - read only graph in compressed sparse rows    //
+// Ver 1.1                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+A Graph<node, RelKind> keeps a vector of vertices, each with its
+own vector of edges, so each vertex is a heap block of its own, and
+walking the graph jumps from block to block.  Once the graph is
+finished it no longer changes, and a CsrGraph copies it into
+compressed sparse rows: the edges of vertex v are
+targets[offsets[v]] up to targets[offsets[v+1]], all vertices' edges
+in one array.
+
+Edge labels are RelKinds, a byte per edge, and the vertices'
+payloads are kept apart from the edges, in one string, so a
+traversal reads only offsets and targets.  Vertex v of a CsrGraph is
+vertex v of the graph it was built from, and has that vertex's id.
+
+strongComponents(), condense() and topologicalSort() do the work of
+GraphXml.h's Tarjan algorithm, condensation and topological sort on
+a CsrGraph, without recursion or copies of vertices:
+- strongComponents() returns the strongly connected components, as
+  lists of vertex indices, in the order Tarjan's algorithm finds
+  them.
+- condense() makes a CsrGraph with a vertex for each component that
+  has edges, in the order GraphXml::condensedGraph() adds them, with
+  the component's number as id and its payloads joined by ';'.
+- topologicalSort() lists the vertices children first, and returns
+  false if it met a cycle.
+
+Public Interface:
+=================
+CsrGraph csr(s->getGraph());             // copy of a finished graph
+for(size_t e=csr.edgesBegin(v); e<csr.edgesEnd(v); ++e)
+  use(csr.target(e), csr.label(e));      // vertex index, RelKind
+StrView name = csr.payload(v);
+size_t bytes = csr.bytes();              // memory held
+std::vector<std::vector<CsrGraph::Index> > sccs = strongComponents(csr);
+CsrGraph dag = condense(csr, sccs);
+std::vector<CsrGraph::Index> order;
+if(!topologicalSort(dag, order))
+  std::cout << "not a DAG";
+
+Build Process:
+==============
+Required files
+- CsrGraph.h, CsrGraph.cpp, Graph.h, GraphXml.h, RelKind.h,
+RelKind.cpp, XmlReader.h, XmlReader.cpp, XmlWriter.h, XmlWriter.cpp,
+StrView.h, StrView.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_CSRGRAPH CsrGraph.cpp RelKind.cpp XmlReader.cpp \
+XmlWriter.cpp StrView.cpp
+- cl /EHsc /O2 /DBENCH_CSRGRAPH CsrGraph.cpp RelKind.cpp \
+XmlReader.cpp XmlWriter.cpp StrView.cpp Timer.cpp
+
+Maintenance History:
+====================
+ver 1.1 : 17 Oct 26
+- edge labels are the graph's RelKinds, no longer interned here
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include <vector>
+#include <string>
+#include "GraphXml.h"
+#include "StrView.h"
+
+class CsrGraph
+{
+public:
+	typedef unsigned Index;          // of a vertex
+
+	CsrGraph();
+	CsrGraph(GraphLib::Graph<node, RelKind>& g);
+	size_t size() const;             // number of vertices
+	size_t numEdges() const;
+	StrView payload(Index v) const;
+	size_t id(Index v) const;
+	size_t edgesBegin(Index v) const;
+	size_t edgesEnd(Index v) const;
+	Index target(size_t e) const;
+	RelKind label(size_t e) const;
+	size_t bytes() const;            // held in the arrays
+
+	friend CsrGraph condense(const CsrGraph& g, const std::vector<std::vector<Index> >& sccs);
+
+private:
+	void addVertex(const StrView& payload, size_t id);
+	void addEdge(Index child, RelKind label);   // from the last vertex added
+
+	std::vector<unsigned> offsets;   // size() + 1, edges of v start at offsets[v]
+	std::vector<Index> targets;
+	std::vector<RelKind> labels;
+	std::string text;                // payloads, one after another
+	std::vector<unsigned> textOffsets;
+	std::vector<size_t> ids;
+};
+
+inline size_t CsrGraph::size() const { return ids.size(); }
+
+inline size_t CsrGraph::numEdges() const { return targets.size(); }
+
+inline StrView CsrGraph::payload(Index v) const
+{
+	return StrView(text.data() + textOffsets[v], textOffsets[v + 1] - textOffsets[v]);
+}
+
+inline size_t CsrGraph::id(Index v) const { return ids[v]; }
+
+inline size_t CsrGraph::edgesBegin(Index v) const { return offsets[v]; }
+
+inline size_t CsrGraph::edgesEnd(Index v) const { return offsets[v + 1]; }
+
+inline CsrGraph::Index CsrGraph::target(size_t e) const { return targets[e]; }
+
+inline RelKind CsrGraph::label(size_t e) const { return labels[e]; }
+
+std::vector<std::vector<CsrGraph::Index> > strongComponents(const CsrGraph& g);
+CsrGraph condense(const CsrGraph& g, const std::vector<std::vector<CsrGraph::Index> >& sccs);
+bool topologicalSort(const CsrGraph& g, std::vector<CsrGraph::Index>& order);
+
+#endif
@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////
 // Executive.cpp - Top level executable for SP13 Project 1   //
-// Ver 1.0                                                   //
+// Ver 2.9                                                   //
 // Language:    Visual C++ 2012                              //
 // Platform:    Dell E6510, Windows 7                        //
 // Application: CSE687 - OOD, Pr#1, Spring 2013              //
@@ -26,6 +26,38 @@ and add them into the graph (vertices).  The second pass is to
 find all the relationships between the types and add them to the 
 graph.  
 
+Pass 1 records each file's semi-expressions in a SemiCache, and pass 2
+replays them, so each file is read and tokenized only once.  Files
+that pass 1 couldn't finish are tokenized again by pass 2.
+
+With "-cache {dir}", recordings are also kept in a SemiStore in that
+directory, so a later run replays the files that haven't changed
+instead of tokenizing them.  "-cachemb {MB}" caps the directory's
+size, 256 MB by default.  The cache's hits and misses are shown at
+the end of the run.
+
+With "-pipe {slots}", files are read and tokenized on a second thread
+that runs up to {slots} batches of semi-expressions ahead of the
+parser, see SemiPipe.  Each pass then shows how busy each side was,
+and how long it waited for the other.
+
+With "-onepass", each file is parsed once: pass 1's parser and a
+deferred pass 2 parser take turns on each semi-expression, and the
+latter records type references instead of looking them up, see
+TypeRefs.  When all files are parsed, the references are resolved
+against the complete symbol table, adding the edges pass 2 would
+have.  If pass 1 leaves a scope open, or pass 2 would have stopped
+at a reference the symbol table resolves, pass 2 runs as usual.
+
+With "-j {N}", each pass parses files on N threads, see ParserPool,
+and the graph and console output are as without it.  -pipe isn't used
+with -j, and -onepass parses on one thread.
+
+Once pass 1 is done, the symbol table is frozen for pass 2's lookups.
+With "-symstats", the end of the run shows how many of those lookups
+the table's filter rejected, and how many it passed on that weren't
+types after all.
+
 Build Process:
 ==============
 Required files
@@ -33,15 +65,38 @@ Required files
 ActionsAndRules.h, ActionsAndRules.cpp, 
 ConfigureParser.h, ConfigureParser.cpp,
 ItokCollection.h, SemiExpression.h, SemiExpression.cpp, 
-tokenizer.h, tokenizer.cpp
+tokenizer.h, tokenizer.cpp, SemiCache.h, SemiCache.cpp,
+SemiStore.h, SemiStore.cpp, SemiPipe.h, SemiPipe.cpp, TypeRefs.h,
+TypeRefs.cpp, FileEffects.h, FileEffects.cpp, ParserPool.h, ParserPool.cpp
 Build commands (either one)
 - devenv display.sln
 - cl /EHsc Executive.cpp parser.cpp ActionsAndRules.cpp \
 ConfigureParser.cpp ConfigureParserRelat.cpp FoldingRules.cpp 
-ScopeStack.cpp semiexpression.cpp tokenizer.cpp /link setargv.obj
+ScopeStack.cpp semiexpression.cpp tokenizer.cpp SemiCache.cpp SemiStore.cpp SemiPipe.cpp \
+TypeRefs.cpp FileEffects.cpp ParserPool.cpp /link setargv.obj
 
 Maintenance History:
 ====================
+ver 2.9 : 17 Oct 26
+- processAFolderOnePass() returns false, instead of using null
+pointers, if the parsers or pRepo weren't built
+ver 2.8 : 17 Oct 26
+- graph is printed and written without copying it
+ver 2.7 : 17 Oct 26
+- added -symstats option, to show the symbol table filter's counters
+ver 2.6 : 17 Oct 26
+- symbol table is frozen once pass 1 is done
+ver 2.5 : 17 Oct 26
+- added -j option, to parse on a pool of threads
+ver 2.4 : 17 Oct 26
+- added -onepass option, to parse each file once and resolve type
+references after all are parsed
+ver 2.3 : 17 Oct 26
+- added -pipe option, to tokenize on a second thread
+ver 2.2 : 17 Oct 26
+- added -cache and -cachemb options, to keep recordings between runs
+ver 2.1 : 17 Oct 26
+- pass 2 replays the semi-expressions recorded by pass 1
 ver 2.0 : 12 Feb 13
 - Adapted by Msynborski
 
@@ -49,6 +104,7 @@ ver 2.0 : 12 Feb 13
 
 #include <string>
 #include <iostream>
+#include <cstdlib>
 #include "Tokenizer.h"
 #include "SemiExpression.h"
 #include "Parser.h"
@@ -59,11 +115,18 @@ ver 2.0 : 12 Feb 13
 #include "filefind.h"
 #include "FileSystem.h"
 #include "GraphXml.h"
+#include "SemiCache.h"
+#include "SemiStore.h"
+#include "SemiPipe.h"
+#include "TypeRefs.h"
+#include "ParserPool.h"
+
+typedef Display<node, RelKind> display;
+typedef GraphXml<node, RelKind> graphXml;
+typedef TarjanAlgorithm<node, RelKind> tarjanAlgorithm;
+typedef TopoSort<node, RelKind> topoSort;
 
-typedef Display<node, std::string> display;
-typedef GraphXml<node, std::string> graphXml;
-typedef TarjanAlgorithm<node, std::string> tarjanAlgorithm;
-typedef TopoSort<node, std::string> topoSort;
+extern Repository* pRepo;
 
 #ifdef TEST_EXEC
 
@@ -94,19 +157,14 @@ void printOutGraph()
 {
 	GraphSingleton *s;
 	s = GraphSingleton::getInstance();
-	graph g;
-	g = s->getGraph();
-
-	graphXml::printPrettyGraph(g);
+	graphXml::printPrettyGraph(s->getGraph());
 }
 
 void writeGraphXmlFile()
 {
 	GraphSingleton *s;
 	s = GraphSingleton::getInstance();
-	graph g;
-	g = s->getGraph();
-	graphXml::writeXml("out.xml",g);
+	graphXml::writeXml("out.xml",s->getGraph());
 }
 
 void printBanner()
@@ -122,6 +180,12 @@ void printUsage()
 	std::cout << "2. \"cppAnaly {folder}\" will execute on a specific folder without recursing into subfolders.\n";
 	std::cout << "3. \"cppAnaly -R {folder}\" will execute on a specific folder recursing into subfolders.\n";
 	std::cout << "4. \"cppAnaly -G {file}.xml\" will display a graphXml file without parsing C++ files.\n";
+	std::cout << "5. \"cppAnaly -cache {dir} ...\" keeps tokenized files in {dir}, for the next run.\n";
+	std::cout << "   \"-cachemb {MB}\" limits the size of {dir}, 256 MB by default.\n";
+	std::cout << "6. \"cppAnaly -pipe {slots} ...\" tokenizes on a second thread, up to {slots} batches ahead.\n";
+	std::cout << "7. \"cppAnaly -onepass ...\" parses each file once, resolving types after all are parsed.\n";
+	std::cout << "8. \"cppAnaly -j {N} ...\" parses files on N threads.\n";
+	std::cout << "9. \"cppAnaly -symstats ...\" counts how pass 2's type lookups were answered.\n";
 }
 
 void pressAKeyPrompt()
@@ -130,6 +194,60 @@ void pressAKeyPrompt()
 	std::getchar();
 }
 
+void getOptions(int& argc, char* argv[], std::string& cacheDir, size_t& cacheMB, size_t& pipeSlots,
+	bool& onePass, size_t& numThreads, bool& symStats)
+{
+	int kept = 1;
+	for (int i=1; i<argc; i++)
+	{
+		std::string arg = argv[i];
+		if ((arg == "-cache") && (i+1 < argc))
+			cacheDir = argv[++i];
+		else if ((arg == "-cachemb") && (i+1 < argc))
+			cacheMB = (size_t)atoi(argv[++i]);
+		else if ((arg == "-pipe") && (i+1 < argc))
+			pipeSlots = (size_t)atoi(argv[++i]);
+		else if (arg == "-onepass")
+			onePass = true;
+		else if ((arg == "-j") && (i+1 < argc))
+			numThreads = (size_t)atoi(argv[++i]);
+		else if (arg == "-symstats")
+			symStats = true;
+		else
+			argv[kept++] = argv[i];
+	}
+	argc = kept;
+}
+
+void printCacheCounters(SemiStore& store)
+{
+	std::cout << "\nToken cache: " << store.hits() << " hits, " << store.misses() << " misses, "
+		<< store.evictions() << " evicted\n";
+}
+
+void printSymbolCounters(SymbolTable& symbols)
+{
+	const SymbolTable::LookupCounts& counts = symbols.lookupCounts();
+	std::cout << "\nSymbol filter: " << counts.rejected << " rejected, " << counts.lookedUp
+		<< " looked up, " << counts.falsePositives << " of those not types\n";
+}
+
+int percent(double part, double whole)
+{
+	return whole > 0 ? (int)(100 * part / whole + 0.5) : 0;
+}
+
+void printPipeStats(const std::string& pass, SemiPipe& pipe)
+{
+	double run = pipe.runTime();
+	std::cout << "\n" << pass << " pipeline: " << pipe.numFiles() << " files, " << pipe.numBatches()
+		<< " batches, " << run << " sec\n";
+	std::cout << "  lexing:  busy " << percent(pipe.producerBusy(), run) << "%, blocked on full ring "
+		<< percent(pipe.producerBlocked(), run) << "%\n";
+	std::cout << "  parsing: busy " << percent(run - pipe.consumerWaiting(), run)
+		<< "%, waiting on empty ring " << percent(pipe.consumerWaiting(), run) << "%\n";
+}
+
 std::vector<std::string> getExtListFromCommandArgs(int argc, char* argv[])
 {
 	std::vector<std::string> extList;
@@ -164,8 +282,6 @@ void demonstrateGraphSearch()
 {
 	GraphSingleton *s;
 	s = GraphSingleton::getInstance();
-	graph g;
-	g = s->getGraph();
 	std::cout << "\nDemonstrating search functions for vertices and edges\n";
 	std::cout << "_____________________________________________________\n";
 	s->graphSearchVertex("CPolygon");
@@ -179,7 +295,7 @@ void demonstrateGraphCondenseAndTopoSort()
 	GraphSingleton *s;
 	s = GraphSingleton::getInstance();
 	graph gGraph;
-	gGraph = s->getGraph();
+	gGraph = s->getGraph();   // a copy, tarjan() marks its vertices
 	std::cout << "\n\nDemonstrating graph condense \n";
 	std::cout << "_________________________________\n";
 	tarjanAlgorithm tarjObj;
@@ -198,11 +314,15 @@ void demonstrateGraphCondenseAndTopoSort()
 
 }
 
-void processAFolderPass1(int argc, char* argv[], bool isRecursive, std::vector<std::string> fileList)
+void processAFolderPass1(int argc, char* argv[], bool isRecursive, std::vector<std::string> fileList,
+	SemiCache& cache, size_t pipeSlots)
 {
 	ConfigParseToConsole configure;
 	Parser* pParser;
 	pParser = configure.Build();
+	configure.UseCache(&cache);
+	if (pParser && (pipeSlots > 0))
+		configure.Pipeline(pipeSlots);
 
 	for(std::vector<std::string>::iterator iterTxt = fileList.begin();
 		iterTxt != fileList.end();
@@ -231,19 +351,29 @@ void processAFolderPass1(int argc, char* argv[], bool isRecursive, std::vector<s
 
 			while(pParser->next())
 				pParser->parse();
+			cache.endRecording(*iterTxt);
 		}
 		catch(std::exception& ex)
 		{
 			std::cout << "\n\n    " << ex.what() << "\n\n";
+			cache.endRecording(*iterTxt);
 		}
 	}
+	if (configure.Pipe() && (configure.Pipe()->numFiles() > 0))
+		printPipeStats("Pass 1", *configure.Pipe());
 }
 
-void processAFolderPass2(int argc, char* argv[], bool isRecursive, std::vector<std::string> fileList)
+void processAFolderPass2(int argc, char* argv[], bool isRecursive, std::vector<std::string> fileList,
+	SemiCache& cache, size_t pipeSlots)
 {
 	ConfigParseToConsoleRelat configure;
 	Parser* pParser;
 	pParser = configure.Build();
+	configure.UseCache(&cache);
+	if (pParser && (pipeSlots > 0))
+		configure.Pipeline(pipeSlots);
+	if (pRepo)
+		pRepo->symbolTable().freeze();    // pass 2 only looks types up
 
 	for(std::vector<std::string>::iterator iterTxt = fileList.begin();
 		iterTxt != fileList.end();
@@ -272,12 +402,100 @@ void processAFolderPass2(int argc, char* argv[], bool isRecursive, std::vector<s
 
 			while(pParser->next())
 				pParser->parse();
+			cache.erase(*iterTxt);
 		}
 		catch(std::exception& ex)
 		{
 			std::cout << "\n\n    " << ex.what() << "\n\n";
 		}
 	}
+	if (configure.Pipe() && (configure.Pipe()->numFiles() > 0))
+		printPipeStats("Pass 2", *configure.Pipe());
+}
+
+// Pass 1 and a deferred pass 2 take turns on each semi-expression, each
+// stopping at its own exception, as it would on its own.  Returns false
+// if pass 2 must run after all, which replays the recordings, or if the
+// parsers or the repository weren't built.
+
+bool processAFolderOnePass(int argc, char* argv[], bool isRecursive, std::vector<std::string> fileList,
+	SemiCache& cache, size_t pipeSlots)
+{
+	ConfigParseToConsole configure;
+	Parser* pParser;
+	pParser = configure.Build();
+	configure.UseCache(&cache);
+	if (pParser && (pipeSlots > 0))
+		configure.Pipeline(pipeSlots);
+	TypeRefs refs;
+	ConfigDeferredRelat deferred(configure.Semi(), &refs);
+	Parser* pDeferred = pParser ? deferred.Build() : 0;
+	if (pParser == 0 || pDeferred == 0)
+	{
+		std::cout << "\n\n  Parser not built\n\n";
+		return false;
+	}
+
+	for(std::vector<std::string>::iterator iterTxt = fileList.begin();
+		iterTxt != fileList.end();
+		++iterTxt)
+	{
+		try
+		{
+			if(!configure.Attach(*iterTxt))
+			{
+				std::cout << "\n  could not open file " << *iterTxt << std::endl;
+				continue;
+			}
+			std::cout << "\n Pass 1+2: Parsing file: " << *iterTxt << "\n";
+
+			GraphSingleton *s;
+			s = GraphSingleton::getInstance();
+			s->setCurrentFilename(*iterTxt);
+
+			bool pass1 = true, pass2 = true;
+			while((pass1 || pass2) && pParser->next())
+			{
+				if(pass1)
+					try { pParser->parse(); }
+					catch(std::exception& ex) { std::cout << "\n\n    " << ex.what() << "\n\n"; pass1 = false; }
+				if(pass2)
+					try { pDeferred->parse(); }
+					catch(std::exception& ex) { std::cout << "\n\n    " << ex.what() << "\n\n"; pass2 = false; }
+			}
+			cache.endRecording(*iterTxt);
+		}
+		catch(std::exception& ex)
+		{
+			std::cout << "\n\n    " << ex.what() << "\n\n";
+			cache.endRecording(*iterTxt);
+		}
+	}
+	if (configure.Pipe() && (configure.Pipe()->numFiles() > 0))
+		printPipeStats("Pass 1+2", *configure.Pipe());
+
+	if (pRepo == 0)
+		return false;
+	pRepo->symbolTable().freeze();        // all types are found
+	size_t matched = 0;
+	if (pRepo->scopeStack().size() > 0 || !refs.resolve(pRepo->symbolTable(), matched))
+	{
+		std::cout << "\nType references can't be resolved in one pass, running pass 2\n";
+		return false;
+	}
+	std::cout << "\nResolved " << matched << " of " << refs.size() << " type references\n";
+	return true;
+}
+
+// Both passes on a ParserPool of numThreads workers
+
+void processAFolderInPool(std::vector<std::string> fileList, SemiCache& cache, size_t numThreads)
+{
+	ParserPool pool(numThreads, cache);
+	pool.pass1(fileList);
+	pool.pass2(fileList);
+	std::cout << "\nParser pool: " << pool.numWorkers() << " threads, " << pool.numReparsed()
+		<< " of " << 2 * fileList.size() << " files parsed again in order\n";
 }
 
 int main(int argc, char* argv[])
@@ -285,6 +503,22 @@ int main(int argc, char* argv[])
 	printBanner();
 	std::string cmdArg;
 	std::string direct = Directory::getCurrentDirectory();
+	std::string cacheDir;
+	size_t cacheMB = 256;
+	size_t pipeSlots = 0;
+	bool onePass = false;
+	size_t numThreads = 0;
+	bool symStats = false;
+	getOptions(argc, argv, cacheDir, cacheMB, pipeSlots, onePass, numThreads, symStats);
+	SemiStore* pStore = 0;
+	if (!cacheDir.empty())
+	{	pStore = new SemiStore(Path::getFullFileSpec(cacheDir), cacheMB << 20);
+	if (!pStore->isOpen())
+	{	std::cout << "Can't use cache directory " << cacheDir << ", files will be tokenized.\n";
+	delete pStore;
+	pStore = 0;
+	}
+	}
 	if (argc == 1)
 		printUsage();
 	else if ((argc == 2))
@@ -302,7 +536,17 @@ int main(int argc, char* argv[])
 	{		cmdArg = argv[1];
 	if (cmdArg == "-R") {
 		std::vector<std::string> fileList = getFileListToParse( argc, argv, true);
-		processAFolderPass1(argc, argv, true, fileList); processAFolderPass2(argc, argv, true, fileList);
+		SemiCache cache;
+		cache.useStore(pStore);
+		if (onePass)
+		{	if (!processAFolderOnePass(argc, argv, true, fileList, cache, pipeSlots))
+			processAFolderPass2(argc, argv, true, fileList, cache, pipeSlots);
+		}
+		else if (numThreads > 0)
+			processAFolderInPool(fileList, cache, numThreads);
+		else
+		{	processAFolderPass1(argc, argv, true, fileList, cache, pipeSlots); processAFolderPass2(argc, argv, true, fileList, cache, pipeSlots);
+		}
 		printOutGraph();demonstrateGraphCondenseAndTopoSort();
 		Directory::setCurrentDirectory(direct);
 		writeGraphXmlFile();
@@ -316,13 +560,29 @@ int main(int argc, char* argv[])
 	}
 	else {			
 		std::vector<std::string> fileList = getFileListToParse( argc, argv, false);
-		processAFolderPass1(argc, argv, false, fileList); 
-		processAFolderPass2(argc, argv, false, fileList);
+		SemiCache cache;
+		cache.useStore(pStore);
+		if (onePass)
+		{	if (!processAFolderOnePass(argc, argv, false, fileList, cache, pipeSlots))
+			processAFolderPass2(argc, argv, false, fileList, cache, pipeSlots);
+		}
+		else if (numThreads > 0)
+			processAFolderInPool(fileList, cache, numThreads);
+		else
+		{	processAFolderPass1(argc, argv, false, fileList, cache, pipeSlots); 
+		processAFolderPass2(argc, argv, false, fileList, cache, pipeSlots);
+		}
 		printOutGraph();demonstrateGraphCondenseAndTopoSort();
 		Directory::setCurrentDirectory(direct);
 		writeGraphXmlFile();
 	}
 	}
+	if (symStats && pRepo)
+		printSymbolCounters(pRepo->symbolTable());
+	if (pStore)
+	{	printCacheCounters(*pStore);
+	delete pStore;
+	}
 	pressAKeyPrompt();
 	return 0;
 }
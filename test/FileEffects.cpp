@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////
+// FileEffects.cpp - graph changes and output of one file    //
+// Ver 1.1                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include "FileEffects.h"
+#include "GraphSingleton.h"
+
+// Visual C++ 2012 has no thread_local, but supports thread storage
+// for plain pointers
+
+#ifdef _MSC_VER
+#define THREAD_STORAGE __declspec(thread)
+#else
+#define THREAD_STORAGE __thread
+#endif
+
+namespace
+{
+	THREAD_STORAGE FileEffects* pThreadEffects = 0;  // capturing, or 0
+}
+
+//----< start logging the effects of parsing a file >----------------
+
+void FileEffects::start(const std::string& fileSpec)
+{
+	fileName = GraphSingleton::reducePathFileToFileNamePrefix(fileSpec);
+	text.clear();
+	changes.clear();
+	newTypes.clear();
+}
+//----< log file's vertex and type's symbol table entry >------------
+
+void FileEffects::addType(const TypeName& name, const std::string& file)
+{
+	Change change = { type, name, file, "", text.size() };
+	changes.push_back(change);
+}
+//----< log an edge >------------------------------------------------
+
+void FileEffects::addRelationship(const std::string& parent, const std::string& child,
+	const std::string& relationship_)
+{
+	Change change = { relationship, parent, child, relationship_, text.size() };
+	changes.push_back(change);
+}
+//----< note name was taken to be a type no earlier file defines >---
+
+void FileEffects::assumeNewType(const TypeName& name)
+{
+	newTypes.push_back(name);
+}
+//----< are all assumed new types still missing from symbols? >-----
+
+bool FileEffects::holds(SymbolTable& symbols) const
+{
+	for(size_t i=0; i<newTypes.size(); ++i)
+		if(symbols.containsType(newTypes[i]))
+			return false;
+	return true;
+}
+//----< write output and make changes, in the order logged >---------
+
+void FileEffects::replay(SymbolTable& symbols) const
+{
+	GraphSingleton* s = GraphSingleton::getInstance();
+	size_t pos = 0;
+	for(size_t i=0; i<changes.size(); ++i)
+	{
+		const Change& change = changes[i];
+		std::cout.write(text.data() + pos, change.textPos - pos);
+		pos = change.textPos;
+		if(change.kind == type)
+		{
+			s->addTypeToGraph(change.b);
+			symbols.Add(change.a, "TBD", change.b);
+		}
+		else
+			s->addRelationshipToGraph(change.a, change.b, change.c);
+	}
+	std::cout.write(text.data() + pos, text.size() - pos);
+}
+
+//----< buffer passing output to the console, or a FileEffects >-----
+
+CaptureBuf::CaptureBuf(std::streambuf* pConsole_) : pConsole(pConsole_) {}
+
+int CaptureBuf::overflow(int ch)
+{
+	if(pThreadEffects == 0)
+		return pConsole->sputc((char)ch);
+	if(ch != EOF)
+		pThreadEffects->text += (char)ch;
+	return ch;
+}
+
+std::streamsize CaptureBuf::xsputn(const char* s, std::streamsize n)
+{
+	if(pThreadEffects == 0)
+		return pConsole->sputn(s, n);
+	pThreadEffects->text.append(s, (size_t)n);
+	return n;
+}
+
+int CaptureBuf::sync()
+{
+	return pThreadEffects == 0 ? pConsole->pubsync() : 0;
+}
+//----< std::cout may be captured until destruction >---------------
+
+ConsoleCapture::ConsoleCapture() : pConsole(std::cout.rdbuf()), buf(pConsole)
+{
+	std::cout.rdbuf(&buf);
+}
+
+ConsoleCapture::~ConsoleCapture()
+{
+	std::cout.rdbuf(pConsole);
+}
+//----< calling thread's output goes to pEffects, or 0 for console >-
+
+void ConsoleCapture::capture(FileEffects* pEffects)
+{
+	pThreadEffects = pEffects;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_FILEEFFECTS
+
+#include <thread>
+
+int main()
+{
+	std::cout << "\n  Testing FileEffects class\n "
+		<< std::string(27,'=') << std::endl;
+
+	SymbolTable symbols;
+	FileEffects effects[2];
+	const char* files[] = { "..\\Tokenizer.cpp", "..\\SemiExpression.cpp" };
+	{
+		ConsoleCapture capture;
+		std::thread worker([&]()
+		{
+			for(int i=1; i>=0; --i)
+			{
+				effects[i].start(files[i]);
+				ConsoleCapture::capture(&effects[i]);
+				std::cout << "\n  parsing " << effects[i].file();
+				if(i == 0)
+					effects[i].addType("Toker", effects[i].file());
+				else
+				{
+					effects[i].assumeNewType("getLine");
+					effects[i].addRelationship(effects[i].file(), "Tokenizer", "variable");
+				}
+				std::cout << "\n  parsed " << effects[i].file();
+			}
+			ConsoleCapture::capture(0);
+		});
+		worker.join();
+		std::cout << "\n  worker parsed both files, applying in file order:";
+		for(int i=0; i<2; ++i)
+			if(effects[i].holds(symbols))
+				effects[i].replay(symbols);
+	}
+	std::cout << "\n  Toker is defined in " << symbols.lookUpFile("Toker", "TBD");
+	std::cout << "\n  graph has " << GraphSingleton::getInstance()->size() << " vertices\n\n";
+}
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef FILEEFFECTS_H
+#define FILEEFFECTS_H
+///////////////////////////////////////////////////////////////
+// FileEffects.h - graph changes and output of one file      //
+// Ver 1.1                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+Parsing a file changes the GraphSingleton, the symbol table and the
+console.  A FileEffects holds those changes for one file instead, so
+a file can be parsed on any thread and its effects applied later, on
+the main thread, in file order, see ParserPool.
+
+Actions add types and relationships through their Repository, which
+logs them in its FileEffects, if it has one.  Console output is
+captured while a ConsoleCapture is alive: each thread that calls
+ConsoleCapture::capture() writes what it sends to std::cout into
+that FileEffects, other threads write to the console as before.
+replay() writes the captured text and makes the logged changes, in
+the order they happened.
+
+A file parsed without the types earlier files define can only tell
+they're new if no earlier file defined them.  isNewType() notes the
+names it assumed were new, and holds() checks them against the
+symbol table the earlier files built.
+
+Public Interface:
+=================
+ConsoleCapture capture;                  // std::cout may be captured
+FileEffects effects;
+effects.start("..\\Parser.cpp");         // logging the file's effects
+ConsoleCapture::capture(&effects);       // this thread's output too
+effects.addType("Parser", effects.file());  // or, via a Repository
+ConsoleCapture::capture(0);              // thread writes to console
+if(effects.holds(symbols))               // assumptions still true?
+  effects.replay(symbols);               // output and change graph
+
+Build Process:
+==============
+Required files
+- FileEffects.h, FileEffects.cpp, SymbolTable.h, GraphSingleton.h,
+GraphSingleton.cpp, and the files they require
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_FILEEFFECTS FileEffects.cpp GraphSingleton.cpp \
+GraphXml.cpp Graph.cpp RelKind.cpp XmlReader.cpp XmlWriter.cpp StrView.cpp
+
+Maintenance History:
+====================
+ver 1.1 : 17 Oct 26
+- start() names the file without getting the GraphSingleton
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include <string>
+#include <vector>
+#include <streambuf>
+#include "SymbolTable.h"
+
+///////////////////////////////////////////////////////////////
+// logged effects of parsing one file
+
+class FileEffects
+{
+public:
+	void start(const std::string& fileSpec);
+	const std::string& file() const;
+
+	// logged by a Repository
+	void addType(const TypeName& name, const std::string& file);
+	void addRelationship(const std::string& parent, const std::string& child,
+		const std::string& relationship);
+	void assumeNewType(const TypeName& name);
+
+	bool holds(SymbolTable& symbols) const;
+	void replay(SymbolTable& symbols) const;
+
+private:
+	friend class CaptureBuf;
+
+	enum Kind { type, relationship };
+	struct Change
+	{
+		Kind kind;
+		std::string a, b, c;       // type and file, or parent, child and relationship
+		size_t textPos;            // text output before the change
+	};
+
+	std::string fileName;          // graph name of the file
+	std::string text;              // captured console output
+	std::vector<Change> changes;
+	std::vector<TypeName> newTypes;
+};
+
+inline const std::string& FileEffects::file() const { return fileName; }
+
+///////////////////////////////////////////////////////////////
+// routes std::cout output of capturing threads to FileEffects
+
+class CaptureBuf : public std::streambuf
+{
+public:
+	CaptureBuf(std::streambuf* pConsole);
+protected:
+	int overflow(int ch);
+	std::streamsize xsputn(const char* s, std::streamsize n);
+	int sync();
+private:
+	std::streambuf* pConsole;
+};
+
+class ConsoleCapture
+{
+public:
+	ConsoleCapture();
+	~ConsoleCapture();
+	static void capture(FileEffects* pEffects);
+
+private:
+	std::streambuf* pConsole;
+	CaptureBuf buf;
+
+	// prohibit copying and assignment
+	ConsoleCapture(const ConsoleCapture&);
+	ConsoleCapture& operator=(const ConsoleCapture&);
+};
+
+#endif
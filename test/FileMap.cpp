@@ -0,0 +1,184 @@
+///////////////////////////////////////////////////////////////
+// FileMap.cpp - read-only view of a whole source file       //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include "FileMap.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static const char emptyFile[1] = { 0 };
+
+//----< construct with nothing attached >----------------------------
+
+FileMap::FileMap() : pData(emptyFile), length(0), mapped(false)
+#ifdef _WIN32
+	, hFile(INVALID_HANDLE_VALUE), hMapping(0)
+#endif
+{
+}
+//----< destructor releases mapping >--------------------------------
+
+FileMap::~FileMap()
+{
+	close();
+}
+//----< map file, falling back to a buffered read >------------------
+
+bool FileMap::open(const std::string& filename)
+{
+	close();
+	if(map(filename))
+		return true;
+	return read(filename);
+}
+//----< release mapping or fallback buffer >-------------------------
+
+void FileMap::close()
+{
+	if(mapped)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(pData);
+		CloseHandle(hMapping);
+		CloseHandle(hFile);
+		hMapping = 0;
+		hFile = INVALID_HANDLE_VALUE;
+#else
+		munmap(const_cast<char*>(pData), length);
+#endif
+	}
+	mapped = false;
+	std::vector<char>().swap(buffer);
+	pData = emptyFile;
+	length = 0;
+}
+//----< map regular, non-empty files >-------------------------------
+
+bool FileMap::map(const std::string& filename)
+{
+#ifdef _WIN32
+	HANDLE hF = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+		0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if(hF == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	if(GetFileType(hF) != FILE_TYPE_DISK || !GetFileSizeEx(hF, &size) ||
+		size.QuadPart == 0 || size.HighPart != 0)
+	{
+		CloseHandle(hF);
+		return false;
+	}
+	HANDLE hM = CreateFileMappingA(hF, 0, PAGE_READONLY, 0, 0, 0);
+	if(hM == 0)
+	{
+		CloseHandle(hF);
+		return false;
+	}
+	void* pView = MapViewOfFile(hM, FILE_MAP_READ, 0, 0, 0);
+	if(pView == 0)
+	{
+		CloseHandle(hM);
+		CloseHandle(hF);
+		return false;
+	}
+	hFile = hF;
+	hMapping = hM;
+	pData = static_cast<const char*>(pView);
+	length = (size_t)size.QuadPart;
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if(fd < 0)
+		return false;
+	struct stat info;
+	if(fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0)
+	{
+		::close(fd);
+		return false;
+	}
+	void* pView = mmap(0, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(pView == MAP_FAILED)
+		return false;
+	madvise(pView, (size_t)info.st_size, MADV_SEQUENTIAL);
+	pData = static_cast<const char*>(pView);
+	length = (size_t)info.st_size;
+#endif
+	mapped = true;
+	return true;
+}
+//----< read whole file into private buffer >------------------------
+
+bool FileMap::read(const std::string& filename)
+{
+	std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+	if(!in.good())
+		return false;
+	const size_t BlockSize = 64 * 1024;
+	size_t used = 0;
+	for(;;)
+	{
+		buffer.resize(used + BlockSize);
+		in.read(&buffer[used], BlockSize);
+		size_t got = (size_t)in.gcount();
+		used += got;
+		if(got < BlockSize)
+			break;
+	}
+	buffer.resize(used);
+	pData = used > 0 ? &buffer[0] : emptyFile;
+	length = used;
+	return true;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_FILEMAP
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Testing FileMap class\n "
+		<< std::string(23,'=') << std::endl;
+
+	if(argc < 2)
+	{
+		std::cout
+			<< "\n  please enter name of file to process on command line\n\n";
+		return 1;
+	}
+
+	for(int i=1; i<argc; ++i)
+	{
+		FileMap fm;
+		if(!fm.open(argv[i]))
+		{
+			std::cout << "\n  can't open " << argv[i];
+			continue;
+		}
+		size_t newLines = 0;
+		for(const char* p = fm.begin(); p != fm.end(); ++p)
+			if(*p == '\n')
+				++newLines;
+		std::cout << "\n  " << argv[i] << ": " << fm.size() << " bytes, "
+			<< newLines << " lines, "
+			<< (fm.isMapped() ? "mapped" : "read into buffer");
+	}
+	std::cout << "\n\n";
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef FILEMAP_H
+#define FILEMAP_H
+///////////////////////////////////////////////////////////////
+// FileMap.h - read-only view of a whole source file         //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+This module defines a FileMap class.  Its instances map an entire
+file into memory, read-only, so that a scanner can walk the file's
+bytes as one contiguous range instead of pulling characters, one at
+a time, through an istream.
+
+If the file can't be mapped, e.g., it is a pipe, a device, or the
+mapping call fails, FileMap falls back to reading the file into a
+private buffer with large block reads.  Either way, clients see the
+same contiguous [begin(), end()) range.
+
+Public Interface:
+=================
+FileMap fm;
+if(fm.open(someFileName))       // map or read file
+{
+  const char* p = fm.begin();   // first byte of file
+  size_t n = fm.size();         // number of bytes in file
+  bool mapped = fm.isMapped();  // false if fallback buffer was used
+}
+fm.close();                     // release mapping or buffer
+
+Build Process:
+==============
+Required files
+- FileMap.h, FileMap.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_FILEMAP FileMap.cpp
+
+Maintenance History:
+====================
+ver 1.0 : 16 Oct 26
+- first release
+*/
+
+#include <string>
+#include <vector>
+
+class FileMap
+{
+public:
+	FileMap();
+	~FileMap();
+	bool open(const std::string& filename);
+	void close();
+	const char* begin() const;
+	const char* end() const;
+	size_t size() const;
+	bool isMapped() const;
+
+private:
+	bool map(const std::string& filename);
+	bool read(const std::string& filename);
+
+	const char* pData;
+	size_t length;
+	bool mapped;
+	std::vector<char> buffer;   // fallback when the file can't be mapped
+#ifdef _WIN32
+	void* hFile;
+	void* hMapping;
+#endif
+
+	// prohibit copying and assignment
+	FileMap(const FileMap&);
+	FileMap& operator=(const FileMap&);
+};
+
+inline const char* FileMap::begin() const { return pData; }
+
+inline const char* FileMap::end() const { return pData + length; }
+
+inline size_t FileMap::size() const { return length; }
+
+inline bool FileMap::isMapped() const { return mapped; }
+
+#endif
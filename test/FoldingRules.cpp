@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  FoldingRules.h - declares ITokCollection folding rules         //
-//  ver 1.0                                                        //
+//  ver 1.1                                                        //
 //  Language:      Visual C++ 2010, SP1                            //
 //  Platform:      Dell Precision T7400, Win 7 Pro SP1             //
 //  Application:   Code Analysis Research                          //
@@ -24,8 +24,8 @@ void codeFoldingRules::MergeOperatorTokens(ITokCollection*& pTc)
 
 void codeFoldingRules::doFold(ITokCollection*& pTc)
 {
-  if(pTc->find("for") < pTc->length())
+  if(pTc->find(tok_for) < pTc->length())
     codeFoldingRules::MergeForCollections(pTc);
-  if(pTc->find("operator") < pTc->length())
+  if(pTc->find(tok_operator) < pTc->length())
     codeFoldingRules::MergeOperatorTokens(pTc);
 }
\ No newline at end of file
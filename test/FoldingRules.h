@@ -2,7 +2,7 @@
 #define FOLDINGRULES_H
 /////////////////////////////////////////////////////////////////////
 //  FoldingRules.h - declares ITokCollection folding rules         //
-//  ver 1.0                                                        //
+//  ver 1.1                                                        //
 //  Language:      Visual C++ 2010, SP1                            //
 //  Platform:      Dell Precision T7400, Win 7 Pro SP1             //
 //  Application:   Code Analysis Research                          //
@@ -38,6 +38,8 @@
 
   Maintenance History:
   ====================
+  ver 1.1 : 16 Oct 26
+  - searches for "for" and "operator" by TokId
   ver 1.0 : 02 Jan 11
   - first release
 
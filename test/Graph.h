@@ -2,7 +2,7 @@
 #define GRAPH_H
 ///////////////////////////////////////////////////////////////
 // Graph.h - Graph Library                                   //
-// Ver 1.2                                                   //
+// Ver 1.4                                                   //
 // Language:    Visual C++ 2012                              //
 // Platform:    Lenova ThinkPad E420s, Windows 7             //
 // Application: Help for CSE687 - OOD, Pr#1, Spring 2013     //
@@ -28,6 +28,11 @@
    is the id of the child vertex and the second parameter is
    an instance of the edge information type E.
 
+   The graph also keeps a set of the (parent, child) index pairs of
+   the edges added with addEdge(), so hasEdge() needn't walk the
+   parent's edges.  Edges added directly with Vertex::add() aren't
+   in the set.
+
    Note:
    It is important that vertex ids be unique.  If you set any of
    them with the second argument of the Vertex constructor or with
@@ -48,6 +53,10 @@
 
    Revision History:
    -----------------
+   - ver 1.4 : added hasEdge(), answered from a set of the edges
+               added with addEdge()
+   - ver 1.3 : added reserve(), to add many vertices without copying
+               the collection as it grows
    - ver 1.2 : changed id() return to reference so can be changed
    - ver 1.1 : added prologue comments, compile test directive
    - ver 1.0 : first release
@@ -63,6 +72,7 @@
 
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace GraphLib 
 {
@@ -157,13 +167,17 @@ namespace GraphLib
     Vertex<V,E>& operator[](size_t i);
     Vertex<V,E> operator[](size_t i) const;
     void addVertex(Vertex<V,E> v);
+    void reserve(size_t n);
     void addEdge(E eval, Vertex<V,E>& parent, Vertex<V,E>& child);
+    bool hasEdge(size_t parentId, size_t childId);
     size_t findVertexIndexById(size_t id);
     size_t size();
     void dfs(Vertex<V,E>& v, void(*f)(Vertex<V,E>& v));
   private:
     std::vector< Vertex<V,E> > adj;
     std::unordered_map<size_t, size_t> idMap; // id maps to graph index
+    std::unordered_set<unsigned long long> edgeKeys; // parent and child indices
+    static unsigned long long edgeKey(size_t parentIndex, size_t childIndex);
     void dfsCore(Vertex<V,E>& v, void(*f)(Vertex<V,E>& v));
   };
   //----< return iterator pointing to first vertex >-------------
@@ -189,6 +203,13 @@ namespace GraphLib
     adj.push_back(v);
     idMap[v.id()] = adj.size() - 1;
   }
+  //----< make room for n vertices >-----------------------------
+  template<typename V, typename E>
+  void Graph<V,E>::reserve(size_t n)
+  {
+    adj.reserve(n);
+    idMap.reserve(n);
+  }
   //----< return number of vertices in graph's collection >------
   template<typename V, typename E>
   size_t Graph<V,E>::size() { return adj.size(); }
@@ -213,6 +234,23 @@ namespace GraphLib
     e.first = childIndex;
     e.second = eVal;
     adj[parentIndex].add(e);
+    edgeKeys.insert(edgeKey(parentIndex, childIndex));
+  }
+  //----< is there an edge from parent to child vertex? >--------
+  template<typename V, typename E>
+  bool Graph<V,E>::hasEdge(size_t parentId, size_t childId)
+  {
+    std::unordered_map<size_t, size_t>::iterator parent = idMap.find(parentId);
+    std::unordered_map<size_t, size_t>::iterator child = idMap.find(childId);
+    if(parent == idMap.end() || child == idMap.end())
+      return false;
+    return edgeKeys.count(edgeKey(parent->second, child->second)) != 0;
+  }
+  //----< pack indices of an edge's vertices into a set key >----
+  template<typename V, typename E>
+  unsigned long long Graph<V,E>::edgeKey(size_t parentIndex, size_t childIndex)
+  {
+    return ((unsigned long long)parentIndex << 32) | (unsigned long long)childIndex;
   }
   //----< recursive depth first search with action f >-----------
   template<typename V, typename E>
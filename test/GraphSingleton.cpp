@@ -20,10 +20,10 @@
 
 using namespace GraphLib;
 
-typedef GraphLib::Graph<node, std::string> graph;
-typedef GraphLib::Vertex<node, std::string> vertex;
-typedef GraphLib::Display<node, std::string> display;
-typedef GraphXml<node, std::string> graphXml;
+typedef GraphLib::Graph<node, RelKind> graph;
+typedef GraphLib::Vertex<node, RelKind> vertex;
+typedef GraphLib::Display<node, RelKind> display;
+typedef GraphXml<node, RelKind> graphXml;
 
 bool GraphSingleton::instanceFlag = false;
 GraphSingleton* GraphSingleton::single = NULL;
@@ -63,4 +63,67 @@ int main()
 	return 0;
 }
 
-#endif
\ No newline at end of file
+#endif
+//----< benchmark stub >---------------------------------------------
+/*
+ *  Builds a graph of n types, 100000 unless given on the command line,
+ *  each related to another, through the calls the parser's actions
+ *  make, and times adding the vertices and the edges.  Then the first
+ *  type uses all the others, so each duplicate test is of a vertex
+ *  with up to n edges.
+ */
+#ifdef BENCH_GRAPHSINGLETON
+
+#include <cstdlib>
+#include <sstream>
+#include "Timer.h"
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Benchmarking GraphSingleton construction\n "
+		<< std::string(41,'=') << std::endl;
+	size_t n = argc > 1 ? (size_t)atoi(argv[1]) : 100000;
+	std::vector<std::string> names;
+	for(size_t i=0; i<n; ++i)
+	{
+		std::ostringstream name;
+		name << "Type" << i;
+		names.push_back(name.str());
+	}
+	GraphSingleton* s = GraphSingleton::getInstance();
+	std::streambuf* pCout = std::cout.rdbuf(0);   // actions report each vertex
+
+	Timer timer;
+	for(size_t i=0; i<n/2; ++i)
+		s->addTypeToGraph(names[i]);
+	s->addTypes(names.begin() + n/2, names.end());      // the rest at once
+	double vertSecs = timer.elapsed();
+	timer.restart();
+	for(size_t i=1; i<n; ++i)
+	{
+		s->addRelationshipToGraph(names[i], names[i/2], "inherits");
+		s->addRelationshipToGraph(names[i], names[i/2], "inherits");  // already there
+	}
+	double edgeSecs = timer.elapsed();
+	timer.restart();
+	for(size_t i=1; i<n; ++i)
+	{
+		s->addRelationshipToGraph(names[0], names[i], "uses");
+		s->addRelationshipToGraph(names[0], names[i], "uses");
+	}
+	double hubSecs = timer.elapsed();
+
+	std::cout.rdbuf(pCout);
+	std::cout.clear();
+	size_t numEdges = 0;
+	graph& g = s->getGraph();
+	for(graph::iterator iter = g.begin(); iter != g.end(); ++iter)
+		numEdges += iter->size();
+	std::cout << "\n  " << g.size() << " vertices added in " << vertSecs << " sec";
+	std::cout << "\n  " << n - 1 << " edges added, " << 2 * (n - 1) << " calls, in "
+		<< edgeSecs << " sec";
+	std::cout << "\n  " << numEdges - (n - 1) << " edges from one vertex added, " << 2 * (n - 1)
+		<< " calls, in " << hubSecs << " sec\n\n";
+}
+
+#endif
@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////
 // GraphSingleton.h - Graph Library                          //
-// Ver 1.0                                                   //
+// Ver 1.5                                                   //
 // Language:    Visual C++ 2012                              //
 // Platform:    Dell E6510, Windows 7                        //
 // Application: CSE687 - OOD, Pr#2, Spring 2013              //
@@ -12,18 +12,40 @@
 // a graph instance via the Singleton pattern.               //
 //                                                           //
 ///////////////////////////////////////////////////////////////
+/*
+Maintenance History:
+====================
+ver 1.5 : 17 Oct 26
+- reducePathFileToFileNamePrefix() is static, so threads that don't
+own the graph needn't get the instance
+ver 1.4 : 17 Oct 26
+- edges are labeled with RelKinds instead of strings
+ver 1.3 : 17 Oct 26
+- doesEdgeExistByIds() asks the graph's edge set, with hasEdge()
+ver 1.2 : 17 Oct 26
+- vertex ids are found by name in a hash map, kept by addVertex(),
+instead of by scanning the vertices, and addTypes() adds a range of
+names at once
+ver 1.1 : 17 Oct 26
+- getGraph() returns a reference to the instance, and the searches
+and additions read the graph in place instead of copying it
+ver 1.0
+- first release
+*/
 
 #ifndef GRAPHSING_H
 #define GRAPHSING_H
 
 #include <iostream>
+#include <iterator>
+#include <unordered_map>
 #include "Graph.h"
 #include "GraphXml.h"
 
 using namespace GraphLib;
 
-typedef Graph<node, std::string> graph;
-typedef Vertex<node, std::string> vertex;
+typedef Graph<node, RelKind> graph;
+typedef Vertex<node, RelKind> vertex;
 
 class GraphSingleton : public graph  // implements GraphSingleton shall(1)
 {
@@ -31,6 +53,7 @@ protected:
 	static bool instanceFlag;
 	static GraphSingleton* single;
 	std::string currentFilename;
+	std::unordered_map<std::string, size_t> nameIds;  // vertex value to id
 private:
 	GraphSingleton()
 	{
@@ -60,14 +83,24 @@ public:
 			return single;
 		}
 	}
-	graph getGraph()
+	graph& getGraph()  // the instance, not a copy
 	{
-		return *single;
+		return *this;
 	}
 	~GraphSingleton()
 	{
 		instanceFlag = false;
 	}
+	void addVertex(vertex v)  // hides graph::addVertex(), to index v's name
+	{
+		graph::addVertex(v);
+		nameIds[v.value().payload] = v.id();
+	}
+	void clear()  // remove all vertices, e.g., between runs
+	{
+		static_cast<graph&>(*this) = graph();
+		nameIds.clear();
+	}
 
 	std::vector<size_t> GraphSingleton::graphSearchVertex(std::string value)
 	{
@@ -75,7 +108,7 @@ public:
 		size_t idVert;
 		std::cout << "Searching the graph for vertices containing: " << value << "\n";
 
-		for(auto& vert : single->getGraph())
+		for(auto& vert : *this)
 		{
 			if (vert.value() == value)
 			{
@@ -89,21 +122,17 @@ public:
 
 	void GraphSingleton::graphSearchEdge(std::string value)
 	{
-		std::vector<size_t> idVector;
-		graph g = single->getGraph();
+		graph& g = *this;
 		graph::iterator iter = g.begin();
 
 		std::cout << "Searching the graph for edges containing: '" << value << "'\n";
 		while(iter != g.end())
 		{
-			vertex v = *iter;
-			std::string parent;
-			parent = v.value().payload;
+			vertex& v = *iter;
 			for(size_t i=0; i<v.size(); ++i)
 			{
-				vertex::Edge edge = v[i];
-				std::string child = g[edge.first].value().payload;
-				std::string relationship = (edge.second);
+				vertex::Edge& edge = v[i];
+				const std::string& relationship = edge.second.name();
 				if (relationship == value)
 				{
 					std::cout << "Found edge with value: " << relationship << " to: " << g[edge.first].value().payload << " from: " << v.value().payload << "\n";
@@ -115,107 +144,66 @@ public:
 
 	bool GraphSingleton::doesEdgeExistByIds(size_t parentId, size_t childId)
 	{
-		graph g = single->getGraph();
-		graph::iterator iter = g.begin();
-		bool parentFound;
-
-		while(iter != g.end())
-		{
-			vertex v = *iter;
-			std::string parent;
-			parent = v.value().payload;
-
-			parentFound = (v.id() == parentId);
-
-			for (size_t i=0; i<v.size(); ++i)
-			{
-				vertex::Edge edge = v[i];
-				std::string child = g[edge.first].value().payload;
-				std::string relationship = (edge.second);
-				if ((parentFound == true) && (g[edge.first].id() == childId )) 
-					return true;
-			}
-			++iter;
-		}
-		return false;
+		return hasEdge(parentId, childId);
 	}
 
-
 	size_t GraphSingleton::addTypeToGraph(std::string vertName)
 	{
-		bool foundVert = false;
 		size_t idVert;
-		for(auto& vert : single->getGraph())
-		{
-			if (vert.value() == vertName)
-			{
-				foundVert = true;
-				idVert = vert.id();
-			}
-		}
-		if (foundVert == false)
-		{
-			vertex vv1(vertName,-1);
-			std::cout << "  Can't find " << vertName << " Adding it to graph\n";
-			single->addVertex(vv1);
-			idVert = vv1.id();
-		}
-		return idVert;
+		if (findVertex(vertName, idVert))
+			return idVert;
+		vertex vv1(vertName,-1);
+		std::cout << "  Can't find " << vertName << " Adding it to graph\n";
+		addVertex(vv1);
+		return vv1.id();
+	}
+
+	// addTypeToGraph() of each name in [first, last), a forward range
+
+	template<typename Iter>
+	void GraphSingleton::addTypes(Iter first, Iter last)
+	{
+		size_t n = size() + std::distance(first, last);
+		reserve(n);
+		nameIds.reserve(n);
+		for (; first != last; ++first)
+			addTypeToGraph(*first);
 	}
 
 	void GraphSingleton::addRelationshipToGraph(std::string parentName, std::string childName, std::string relationship_s)
 	{
 		if (parentName != childName)
 		{
-			GraphSingleton *s;
-			s = GraphSingleton::getInstance();
-			graph g = s->getGraph();
-
-			bool foundParent = false;
 			size_t idParent;
-			bool foundChild = false;
-			size_t idChild;
-
-			for(auto& vert : s->getGraph())
-			{
-				if (vert.value() == parentName)
-				{
-					foundParent = true;
-					idParent = vert.id();
-				}
-			}
-
-			if (foundParent == false)
-				idParent = s->addTypeToGraph(parentName);
+			if (!findVertex(parentName, idParent))
+				idParent = addTypeToGraph(parentName);
 
-			for(auto& vert : s->getGraph())
-			{
-				if (vert.value() == childName)
-				{
-					foundChild = true;
-					idChild = vert.id();
-				}
-			}
-
-			if (foundChild == false)
-				idChild = s->addTypeToGraph(childName);
-
-			bool edgeFound = false;
-			for (size_t i=0; i<s->getGraph()[s->getGraph().findVertexIndexById(idParent)].size();i++)
-				if (s->getGraph()[i].id() == idChild)
-					edgeFound = true;
+			size_t idChild;
+			if (!findVertex(childName, idChild))
+				idChild = addTypeToGraph(childName);
 
-			if (!s->doesEdgeExistByIds(idParent, idChild))
+			if (!doesEdgeExistByIds(idParent, idChild))
 			{
-				s->addEdge(
+				addEdge(
 					relationship_s, 
-					s->getGraph()[s->getGraph().findVertexIndexById(idParent)], 
-					s->getGraph()[s->getGraph().findVertexIndexById(idChild)]	);
+					(*this)[findVertexIndexById(idParent)], 
+					(*this)[findVertexIndexById(idChild)]	);
 			}
 		}
 	}
 
-	std::string GraphSingleton::reducePathFileToFileNamePrefix(std::string pathFile)
+	// id of the vertex with value name, names are added only once
+
+	bool GraphSingleton::findVertex(const std::string& name, size_t& id)
+	{
+		std::unordered_map<std::string, size_t>::iterator iter = nameIds.find(name);
+		if (iter == nameIds.end())
+			return false;
+		id = iter->second;
+		return true;
+	}
+
+	static std::string GraphSingleton::reducePathFileToFileNamePrefix(std::string pathFile)
 	{
 		size_t endPos = pathFile.find_last_of(".");
 		size_t startPos = pathFile.find_last_of("\\") + 1;
@@ -37,12 +37,12 @@
 
 using namespace GraphLib;
 
-typedef Graph<node, std::string> graph;
-typedef Vertex<node, std::string> vertex;
-typedef Display<node, std::string> display;
-typedef GraphXml<node, std::string> graphXml;
-typedef TarjanAlgorithm<node, std::string> tarjanAlgorithm;
-typedef TopoSort<node, std::string> topoSort;
+typedef Graph<node, RelKind> graph;
+typedef Vertex<node, RelKind> vertex;
+typedef Display<node, RelKind> display;
+typedef GraphXml<node, RelKind> graphXml;
+typedef TarjanAlgorithm<node, RelKind> tarjanAlgorithm;
+typedef TopoSort<node, RelKind> topoSort;
 
 
 template<typename V, typename E>
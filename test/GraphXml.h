@@ -38,6 +38,7 @@
 #include "XmlReader.h"
 #include "XmlWriter.h"
 #include "Graph.h"
+#include "RelKind.h"
 #include <unordered_map>
 
 using namespace GraphLib;
@@ -148,8 +149,8 @@ public:
 				if (indexSCC != indexSCCchild )
 				{
 					AddVertexToGraph(collapseSccIntoString(stronglyConnectedComponents[indexSCCchild]), indexSCCchild, condensedGraph);
-					vertex vertParent = condensedGraph[condensedGraph.findVertexIndexById(indexSCC)];
-					vertex vertChild = condensedGraph[condensedGraph.findVertexIndexById(indexSCCchild)];
+					vertex& vertParent = condensedGraph[condensedGraph.findVertexIndexById(indexSCC)];
+					vertex& vertChild = condensedGraph[condensedGraph.findVertexIndexById(indexSCCchild)];
 					bool edgeExist = doesEdgeExistAlready(indexSCC, indexSCCchild, condensedGraph);
 
 					if (!edgeExist)
@@ -163,26 +164,7 @@ public:
 
 	static bool doesEdgeExistAlready(size_t parentId, size_t childId, graph& g)
 	{
-		std::vector<size_t> idVector;
-		graph::iterator iter = g.begin();
-		while(iter != g.end())
-		{
-			vertex v = *iter;
-			std::string parent;
-			parent = v.value().payload;
-			for(size_t i=0; i<v.size(); ++i)
-			{
-				vertex::Edge edge = v[i];
-				std::string child = g[edge.first].value().payload;
-				std::string relationship = (edge.second);				
-				if ((v.id() == parentId) && (g[edge.first].id() == childId))
-				{
-					return true;
-				}
-			}
-			++iter;
-		}
-		return false;
+		return g.hasEdge(parentId, childId);
 	}
 
 	static std::string collapseSccIntoString(std::vector<vertex> stronglyConnectedComponent)
@@ -235,7 +217,7 @@ public:
 
 
 
-	static void printPrettyGraph(graph g)
+	static void printPrettyGraph(graph& g)
 	{
 
 		std::cout << "\nPrinting the graph\n";
@@ -244,16 +226,16 @@ public:
 		graph::iterator iter = g.begin();
 		while(iter != g.end())
 		{
-			vertex v = *iter;
+			vertex& v = *iter;
 			std::string parent;
 			parent = v.value().payload;
 
 			std::cout << std::setw(30) << parent << "\n";
 			for(size_t i=0; i<v.size(); ++i)
 			{
-				vertex::Edge edge = v[i];
+				typename vertex::Edge& edge = v[i];
 				std::string child = g[edge.first].value().payload;
-				std::string relationship = (edge.second);
+				std::string relationship = (edge.second).c_str();
 
 				if (relationship == "variable")
 					relationship = "V----variable------>";
@@ -282,7 +264,7 @@ public:
 		}
 	}
 
-	static void writeXml(std::string filename, graph g) // implements GraphXml shall(1)
+	static void writeXml(std::string filename, graph& g) // implements GraphXml shall(1)
 	{
 		XmlWriter wtr;
 		wtr.addDeclaration();
@@ -293,7 +275,7 @@ public:
 		{
 			XmlWriter vertXml;
 			vertXml.start("vertex");
-			vertex v = *iter;
+			vertex& v = *iter;
 			std::string t1;
 			t1 =  std::to_string(v.id());
 			vertXml.addAttribute("id",t1 );
@@ -301,7 +283,7 @@ public:
 			vertXml.addAttribute("value",t1);
 			for(size_t i=0; i<v.size(); ++i)
 			{
-				vertex::Edge edge = v[i];
+				typename vertex::Edge& edge = v[i];
 				XmlWriter edgeXml;
 				edgeXml.start("edge /");
 				t1 = (edge.second).c_str();
@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  Parser.cpp - Analyzes C++ language constructs                  //
-//  ver 1.3                                                        //
+//  ver 1.6                                                        //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
 //  Application:   Prototype for CSE687 Pr1, Sp09                  //
@@ -36,16 +36,24 @@ bool Parser::next()
   if(!succeeded)
     return false;
   pFoldingRules->doFold(pTokColl);
+  pTokColl->summary();  // one scan, shared by all rules
   return true;
 }
 
 //----< parse the SemiExp by applying all rules to it >--------
-
+/*
+ *  Rules whose triggers aren't all in the SemiExp can't match, so
+ *  they aren't tested.  If an action changes the SemiExp, its
+ *  summary is rebuilt before the next rule is considered.
+ */
 bool Parser::parse()
 {
   bool succeeded = false;
   for(size_t i=0; i<rules.size(); ++i)
   {
+    const TokSet& trigs = rules[i]->triggers();
+    if((trigs & pTokColl->summary().present()) != trigs)
+      continue;
     if(rules[i]->doTest(pTokColl))
       succeeded = true;
   }
@@ -57,6 +65,14 @@ void IRule::addAction(IAction *pAction)
 {
   actions.push_back(pAction);
 }
+//----< rule can't match unless token id is present >---------
+
+void IRule::addTrigger(TokId id)
+{
+  if(id >= numPredefinedToks)
+    throw std::exception("trigger must be a predefined token");
+  trigs.set(id);
+}
 //----< invoke all actions associated with a rule >------------
 
 void IRule::doActions(ITokCollection*& pTokColl)
@@ -65,6 +81,13 @@ void IRule::doActions(ITokCollection*& pTokColl)
     for(size_t i=0; i<actions.size(); ++i)
       actions[i]->doAction(pTokColl);
 }
+//----< invoke all actions, for rules' test(tc, act) >---------
+
+void IRule::act(ITokCollection& tc)
+{
+  ITokCollection* pTc = &tc;
+  doActions(pTc);
+}
 
 //----< test stub >--------------------------------------------
 
@@ -17,12 +17,26 @@
   applying a set of rules to the semi-expression, and for each rule
   that matches, a set of actions is invoked.
 
+  After folding, the parser asks the collection for its summary(), the
+  positions of its punctuators and keywords, built in one pass.  Rules
+  share that summary, so finding "(" or "class" takes constant time.
+
+  A rule may declare trigger tokens, punctuators or keywords it can't
+  match without, e.g., "{" and "class" for a class definition.  The
+  parser tests only the rules whose triggers are all in the summary.
+  Rules that declare no triggers are tested every time.
+
+  Rules and actions are called through virtual functions here.  The
+  StaticParser module applies a fixed list of rules to a concrete
+  collection type, without them.
+
   Public Interface:
   =================
   Toker t(someFile);              // create tokenizer instance
   SemiExp se(&t);                 // create a SemiExp attached to tokenizer
   Parser parser(se);              // now we have a parser
   Rule1 r1;                       // create instance of a derived Rule class
+  r1.addTrigger(tok_lbrace);      // r1 can't match without a "{"
   Action1 a1;                     // create a derived action
   r1.addAction(&a1);              // register action with the rule
   parser.addRule(&r1);            // register rule with parser
@@ -43,6 +57,14 @@
 
   Maintenance History:
   ====================
+  ver 1.6 : 17 Oct 26
+  - added IRule::act(), which invokes the rule's actions
+  ver 1.5 : 17 Oct 26
+  - next() summarizes each semi-expression after folding, and parse()
+    takes the tokens present from that summary
+  ver 1.4 : 17 Oct 26
+  - rules may declare trigger tokens, and parse() skips rules whose
+    triggers are missing from the semi-expression
   ver 1.3 : 02 Jun 11
   - added use of folding rules in get();
   ver 1.2 : 17 Jan 09
@@ -94,11 +116,18 @@ public:
   virtual ~IRule() {}
   void addAction(IAction* pAction);
   void doActions(ITokCollection*& pTc);
+  void act(ITokCollection& tc);
   virtual bool doTest(ITokCollection*& pTc)=0;
+  void addTrigger(TokId id);
+  const TokSet& triggers() const;
 protected:
   std::vector<IAction*> actions;
+  TokSet trigs;
 };
 
+inline const TokSet& IRule::triggers() const { return trigs; }
+
+
 class FoldingRules
 {
 public:
@@ -107,8 +136,9 @@ public:
 ///////////////////////////////////////////////////////////////
 // class that implements a parser
 //   - It collects semi-expressions from a file for analysis.
-//   - Each rule is applied to each semi-expression.  if the
-//     rule matches, then it invokes any registered actions.
+//   - Each rule is applied to each semi-expression that holds
+//     its triggers.  if the rule matches, then it invokes any
+//     registered actions.
 
 class Parser
 {
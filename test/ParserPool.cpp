@@ -0,0 +1,218 @@
+///////////////////////////////////////////////////////////////
+// ParserPool.cpp - parses files on several threads          //
+// Ver 1.3                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "ParserPool.h"
+#include "ConfigureParser.h"
+#include "ConfigureParserRelat.h"
+#include "SemiCache.h"
+#include "FileEffects.h"
+
+extern Repository* pRepo;
+
+namespace
+{
+	// Visual C++ 2012 doesn't initialize function statics thread
+	// safely, so build the typedef rule's type list before main
+
+	bool keywordListsBuilt = TypedefStatement().isStdDatatype(StrView());
+
+	// what a worker leaves for the main thread
+
+	struct FileResult
+	{
+		FileEffects effects;
+		ScopeStack<element> endStack;
+		bool attached;             // file was opened, or replayed
+	};
+}
+
+//----< pool of numWorkers threads, sharing cache >------------------
+
+ParserPool::ParserPool(size_t numWorkers, SemiCache& cache_)
+	: workers(numWorkers > 0 ? numWorkers : 1), cache(cache_), firstPass(true), reparsed(0) {}
+
+//----< find types, in pRepo and the graph >-------------------------
+
+void ParserPool::pass1(const std::vector<std::string>& files)
+{
+	firstPass = true;
+	run<ConfigParseToConsole>(files);
+}
+//----< find relationships between the types pass 1 found >----------
+
+void ParserPool::pass2(const std::vector<std::string>& files)
+{
+	firstPass = false;
+	if(pRepo)
+		pRepo->symbolTable().freeze();      // workers copy it read only
+	run<ConfigParseToConsoleRelat>(files);
+}
+//----< parse one file, as processAFolderPass1 or 2 does >-----------
+/*
+ *  inOrder is true when parsing on pRepo, on the main thread, so the
+ *  file becomes the GraphSingleton's current file.
+ */
+template<class Config>
+bool ParserPool::parseFile(Config& configure, Parser* pParser, const std::string& file, bool inOrder)
+{
+	try
+	{
+		if(!configure.Attach(file))
+		{
+			std::cout << "\n  could not open file " << file << std::endl;
+			return false;
+		}
+		std::cout << "\n Pass " << (firstPass ? 1 : 2) << ": Parsing file: " << file << "\n";
+		if(inOrder)
+			GraphSingleton::getInstance()->setCurrentFilename(file);
+
+		while(pParser->next())
+			pParser->parse();
+		if(firstPass)
+			cache.endRecording(file);
+		else
+			cache.erase(file);
+	}
+	catch(std::exception& ex)
+	{
+		std::cout << "\n\n    " << ex.what() << "\n\n";
+		if(firstPass)
+			cache.endRecording(file);
+	}
+	return true;
+}
+//----< parse files on the workers, apply results in file order >----
+
+template<class Config>
+void ParserPool::run(const std::vector<std::string>& files)
+{
+	Config inOrder;                      // parses on pRepo, in pass 1 creating it
+	Parser* pInOrder = inOrder.Build();
+	inOrder.UseCache(&cache);
+	std::vector<Config*> configs;
+	std::vector<Parser*> parsers;
+	for(size_t w=0; w<workers; ++w)
+	{
+		configs.push_back(new Config(true));
+		parsers.push_back(configs[w]->Build());
+		configs[w]->UseCache(&cache);
+		if(parsers[w] == 0)
+			pInOrder = 0;
+	}
+	if(pInOrder == 0)
+	{
+		std::cout << "\n\n  Parser not built\n\n";
+		for(size_t w=0; w<workers; ++w)
+			delete configs[w];
+		return;
+	}
+
+	// getInstance() makes the instance without a lock, so make it
+	// here, before any worker runs
+
+	GraphSingleton::getInstance();
+	std::vector<FileResult*> results(files.size(), 0);
+	std::atomic<size_t> nextFile(0);
+	std::mutex mtx;                      // guards results
+	std::condition_variable resultReady;
+	ConsoleCapture capture;
+	std::vector<std::thread> threads;
+	for(size_t w=0; w<workers; ++w)
+	{
+		threads.push_back(std::thread([&, w]()
+		{
+			Repository* pRepos = configs[w]->Repos();
+			for(size_t i = nextFile++; i < files.size(); i = nextFile++)
+			{
+				FileResult* pResult = new FileResult;
+				pResult->effects.start(files[i]);
+				pRepos->scopeStack() = ScopeStack<element>();
+				if(firstPass)
+					pRepos->symbolTable() = SymbolTable();
+				pRepos->logTo(&pResult->effects);
+				ConsoleCapture::capture(&pResult->effects);
+				pResult->attached = parseFile(*configs[w], parsers[w], files[i], false);
+				ConsoleCapture::capture(0);
+				pRepos->logTo(0);
+				pResult->endStack = pRepos->scopeStack();
+				std::lock_guard<std::mutex> lock(mtx);
+				results[i] = pResult;
+				resultReady.notify_all();
+			}
+		}));
+	}
+
+	for(size_t i=0; i<files.size(); ++i)
+	{
+		FileResult* pResult;
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			while(results[i] == 0)
+				resultReady.wait(lock);
+			pResult = results[i];
+		}
+		if(pRepo->scopeStack().size() == 0 && pResult->effects.holds(pRepo->symbolTable()))
+		{
+			if(pResult->attached)
+				GraphSingleton::getInstance()->setCurrentFilename(files[i]);
+			pResult->effects.replay(pRepo->symbolTable());
+			pRepo->scopeStack() = pResult->endStack;
+		}
+		else
+		{
+			++reparsed;
+			parseFile(inOrder, pInOrder, files[i], true);
+		}
+		delete pResult;
+	}
+	for(size_t w=0; w<workers; ++w)
+	{
+		threads[w].join();
+		pRepo->symbolTable().addLookupCounts(configs[w]->Repos()->symbolTable().lookupCounts());
+		delete configs[w];
+	}
+}
+
+//----< test stub >--------------------------------------------------
+/*
+ *  Builds the graph of the files named on the command line with the
+ *  pool, and shows it.
+ */
+#ifdef TEST_PARSERPOOL
+
+#include "GraphXml.h"
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Testing ParserPool class\n "
+		<< std::string(26,'=') << std::endl;
+	if(argc < 2)
+	{
+		std::cout << "\n  please enter names of files to process on command line\n\n";
+		return 1;
+	}
+	std::vector<std::string> files(argv + 1, argv + argc);
+	SemiCache cache;
+	ParserPool pool(4, cache);
+	pool.pass1(files);
+	pool.pass2(files);
+	std::cout << "\n  " << pool.numWorkers() << " workers, " << pool.numReparsed()
+		<< " of " << 2 * files.size() << " file parses repeated in order\n";
+	graph& g = GraphSingleton::getInstance()->getGraph();
+	GraphXml<node, RelKind>::printPrettyGraph(g);
+	std::cout << "\n\n";
+}
+
+#endif
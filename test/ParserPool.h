@@ -0,0 +1,104 @@
+#ifndef PARSERPOOL_H
+#define PARSERPOOL_H
+///////////////////////////////////////////////////////////////
+// ParserPool.h - parses files on several threads            //
+// Ver 1.3                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+A ParserPool runs each pass of the executive on several worker
+threads.  Each worker has its own parser, built by a builder with its
+own Toker, SemiExp and Repository, and parses whole files.  Workers
+take the next file from a shared cursor, so one that gets small files
+takes more of them, and files finish roughly in list order.
+
+A worker's Repository logs the file's graph changes in a FileEffects,
+and its console output is captured there too.  The main thread takes
+the results in file order and replays them, so the graph, the symbol
+table and the console get the same changes, in the same order, as
+when the files are parsed one after another.
+
+That holds if the file would have been parsed the same way in order.
+Each worker starts a file with an empty scope stack and, in pass 1,
+an empty symbol table, while in order it starts with what the files
+before it left.  So a result is replayed only if pRepo's scope stack
+is empty and the types the file took to be new still aren't in the
+symbol table, see FileEffects::holds().  Otherwise the main thread
+parses the file again, on pRepo, as processAFolderPass1 and 2 do.
+
+Workers share the SemiCache, so pass 2 replays what pass 1 recorded,
+whichever workers parsed the file.
+
+Public Interface:
+=================
+SemiCache cache;
+ParserPool pool(4, cache);          // 4 worker threads
+pool.pass1(files);                  // find types, builds pRepo
+pool.pass2(files);                  // find relationships
+size_t n = pool.numReparsed();      // results that couldn't be used
+
+Build Process:
+==============
+Required files
+- ParserPool.h, ParserPool.cpp, FileEffects.h, FileEffects.cpp,
+ConfigureParser.h, ConfigureParser.cpp, ConfigureParserRelat.h,
+ConfigureParserRelat.cpp, and the files they require
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_PARSERPOOL ParserPool.cpp, and the other .cpp files
+Submission.vcxproj compiles, except Executive.cpp, /link setargv.obj
+
+Maintenance History:
+====================
+ver 1.3 : 17 Oct 26
+- the GraphSingleton is made on the main thread, before the workers
+start
+ver 1.2 : 17 Oct 26
+- workers' symbol table lookup counts are added to pRepo's
+ver 1.1 : 17 Oct 26
+- pass2() freezes pRepo's symbol table before workers copy it
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include <string>
+#include <vector>
+
+class Parser;
+class SemiCache;
+
+class ParserPool
+{
+public:
+	ParserPool(size_t numWorkers, SemiCache& cache);
+	void pass1(const std::vector<std::string>& files);
+	void pass2(const std::vector<std::string>& files);
+	size_t numWorkers() const;
+	size_t numReparsed() const;
+
+private:
+	template<class Config> void run(const std::vector<std::string>& files);
+	template<class Config> bool parseFile(Config& configure, Parser* pParser,
+		const std::string& file, bool inOrder);
+
+	size_t workers;
+	SemiCache& cache;
+	bool firstPass;                // recording, and finding types
+	size_t reparsed;
+
+	// prohibit copying and assignment
+	ParserPool(const ParserPool&);
+	ParserPool& operator=(const ParserPool&);
+};
+
+inline size_t ParserPool::numWorkers() const { return workers; }
+
+inline size_t ParserPool::numReparsed() const { return reparsed; }
+
+#endif
@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////
+// RelKind.cpp - kinds of relationship between files         //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include "RelKind.h"
+
+namespace
+{
+#define RELKIND_LABEL(name, label) label,
+	const char* const predefinedLabel[] =
+	{
+		RELKIND_PREDEFINED(RELKIND_LABEL)
+	};
+#undef RELKIND_LABEL
+}
+
+//----< the one registry >-------------------------------------------
+
+RelKindRegistry& RelKindRegistry::instance()
+{
+	static RelKindRegistry registry;
+	return registry;
+}
+
+// Visual C++ 2012 doesn't make the first call of instance() thread
+// safe, so make that call during static initialization, before main
+
+namespace
+{
+	RelKindRegistry& registryBuiltAtStartup = RelKindRegistry::instance();
+}
+
+//----< register predefined labels, in list order >------------------
+
+RelKindRegistry::RelKindRegistry() : count(numPredefinedRelKinds)
+{
+	for(size_t id=0; id<numPredefinedRelKinds; ++id)
+		names[id] = predefinedLabel[id];
+}
+//----< id of label, registered if new >-----------------------------
+
+unsigned char RelKindRegistry::intern(const StrView& name)
+{
+	for(size_t id=0; id<numPredefinedRelKinds; ++id)
+		if(StrView(names[id]) == name)
+			return (unsigned char)id;
+	std::lock_guard<std::mutex> lock(mtx);
+	for(size_t id=numPredefinedRelKinds; id<count; ++id)
+		if(StrView(names[id]) == name)
+			return (unsigned char)id;
+	if(count == maxKinds)
+		throw std::exception("more than 256 kinds of relationship");
+	names[count] = name.str();
+	return (unsigned char)count++;
+}
+//----< number of labels registered >--------------------------------
+
+size_t RelKindRegistry::size()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return count;
+}
+//----< write kind's name >------------------------------------------
+
+std::ostream& operator<<(std::ostream& out, const RelKind& kind)
+{
+	return out << kind.name();
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_RELKIND
+
+#include <vector>
+#include <sstream>
+
+int main()
+{
+	std::cout << "\n  Testing RelKind\n "
+		<< std::string(17,'=') << std::endl;
+
+	RelKindRegistry& registry = RelKindRegistry::instance();
+	std::cout << "\n  " << registry.size() << " predefined kinds, a RelKind is "
+		<< sizeof(RelKind) << " byte";
+	size_t mismatches = 0;
+	for(size_t id=0; id<numPredefinedRelKinds; ++id)
+		if(RelKind(predefinedLabel[id]).id() != id)
+			++mismatches;
+	std::cout << "\n  " << mismatches << " predefined kinds with unexpected ids";
+
+	RelKind inherits("inherits");
+	std::cout << "\n  \"inherits\" is " << (int)inherits.id() << ", rel_inherits is " << rel_inherits
+		<< ", equal: " << (inherits == rel_inherits ? "yes" : "no");
+	RelKind friendOf(std::string("friendOf"));
+	std::cout << "\n  \"friendOf\" is " << (int)friendOf.id() << ", again " << (int)RelKind("friendOf").id()
+		<< ", name of " << (int)friendOf.id() << " is " << friendOf;
+	RelKind none;
+	std::cout << "\n  default kind is " << none;
+
+	std::vector<std::pair<int, RelKind> > edges;
+	edges.push_back(std::make_pair(1, RelKind("variable")));
+	edges.push_back(std::make_pair(2, RelKind(rel_param)));
+	for(size_t i=0; i<edges.size(); ++i)
+		std::cout << "\n  edge to " << edges[i].first << " is " << edges[i].second.c_str();
+	std::cout << "\n  an edge is " << sizeof(edges[0]) << " bytes, with a string label it was "
+		<< sizeof(std::pair<int, std::string>);
+
+	try
+	{
+		for(int i=0; i<300; ++i)
+		{
+			std::ostringstream label;
+			label << "label" << i;
+			RelKind kind(label.str());
+		}
+	}
+	catch(std::exception& ex)
+	{
+		std::cout << "\n  after " << registry.size() << " kinds: " << ex.what();
+	}
+	std::cout << "\n\n";
+}
+
+#endif
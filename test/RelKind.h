@@ -0,0 +1,144 @@
+#ifndef RELKIND_H
+#define RELKIND_H
+///////////////////////////////////////////////////////////////
+// RelKind.h - kinds of relationship between files           //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+Every edge of the dependency graph is labeled with the kind of
+relationship it stands for, "variable", "inherits" and so on, and
+the graph used to hold each label as a std::string of its own,
+copied with every copy of its vertex.  A RelKind is one byte: the
+id of its label in the RelKindRegistry.
+
+The relationships the parser finds are registered first, in the
+order of the list below, so their ids are compile time constants,
+e.g., rel_inherits for "inherits", and code may switch on them.
+Any other label, e.g., one read from an XML file, is registered
+when a RelKind is first made from it, up to 256 labels in all.
+
+A RelKind made from text registers it, so to ask whether an edge has
+some label without registering it, compare names.  The registry may
+be used from several threads: predefined labels are found without a
+lock, others under a mutex, and names never move once registered.
+
+Public Interface:
+=================
+RelKind kind = rel_inherits;            // predefined, no lookup
+RelKind other("friendOf");              // registered if new
+g.addEdge("variable", parent, child);   // converts, edges hold RelKinds
+if(edge.second == rel_param)            // compares ids
+  std::cout << edge.second;             // its name, as name() or c_str()
+switch(edge.second.id()) { case rel_variable: ... }
+size_t n = RelKindRegistry::instance().size();
+
+Build Process:
+==============
+Required files
+- RelKind.h, RelKind.cpp, StrView.h, StrView.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_RELKIND RelKind.cpp StrView.cpp
+
+Maintenance History:
+====================
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include <string>
+#include <iosfwd>
+#include <mutex>
+#include "StrView.h"
+
+///////////////////////////////////////////////////////////////
+// predefined relationships: X(id name, label)
+
+#define RELKIND_PREDEFINED(X) \
+	X(rel_relationship, "relationship") X(rel_variable, "variable") X(rel_retType, "retType") \
+	X(rel_param, "param") X(rel_inherits, "inherits") X(rel_globalFun, "globalFun") \
+	X(rel_globalVar, "globalVar") X(rel_composes, "composes") X(rel_aggregates, "aggregates") \
+	X(rel_uses, "uses")
+
+#define RELKIND_ENUM(name, label) name,
+enum PredefinedRelKind
+{
+	RELKIND_PREDEFINED(RELKIND_ENUM)
+	numPredefinedRelKinds
+};
+#undef RELKIND_ENUM
+
+///////////////////////////////////////////////////////////////
+// RelKind: label of an edge, held as its registry id
+
+class RelKind
+{
+public:
+	RelKind();                           // rel_relationship
+	RelKind(PredefinedRelKind kind);
+	RelKind(const std::string& name);    // registered if new
+	RelKind(const char* name);
+	unsigned char id() const;
+	const std::string& name() const;
+	const char* c_str() const;           // as Display<V,E>::show() prints edges
+	bool operator==(const RelKind& other) const;
+	bool operator!=(const RelKind& other) const;
+
+private:
+	unsigned char kind;
+};
+
+std::ostream& operator<<(std::ostream& out, const RelKind& kind);
+
+///////////////////////////////////////////////////////////////
+// RelKindRegistry: single, process wide, label interner
+
+class RelKindRegistry
+{
+public:
+	enum { maxKinds = 256 };
+	static RelKindRegistry& instance();
+	unsigned char intern(const StrView& name);
+	const std::string& name(unsigned char id) const;
+	size_t size();
+
+private:
+	RelKindRegistry();
+
+	std::string names[maxKinds];      // by id, never moved
+	std::mutex mtx;                   // guards count and adding names
+	size_t count;
+
+	// prohibit copying and assignment
+	RelKindRegistry(const RelKindRegistry&);
+	RelKindRegistry& operator=(const RelKindRegistry&);
+};
+
+inline RelKind::RelKind() : kind(rel_relationship) {}
+
+inline RelKind::RelKind(PredefinedRelKind kind_) : kind((unsigned char)kind_) {}
+
+inline RelKind::RelKind(const std::string& name) : kind(RelKindRegistry::instance().intern(name)) {}
+
+inline RelKind::RelKind(const char* name) : kind(RelKindRegistry::instance().intern(name)) {}
+
+inline unsigned char RelKind::id() const { return kind; }
+
+inline const std::string& RelKind::name() const { return RelKindRegistry::instance().name(kind); }
+
+inline const char* RelKind::c_str() const { return name().c_str(); }
+
+inline bool RelKind::operator==(const RelKind& other) const { return kind == other.kind; }
+
+inline bool RelKind::operator!=(const RelKind& other) const { return kind != other.kind; }
+
+inline const std::string& RelKindRegistry::name(unsigned char id) const { return names[id]; }
+
+#endif
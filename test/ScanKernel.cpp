@@ -0,0 +1,419 @@
+///////////////////////////////////////////////////////////////
+// ScanKernel.cpp - vectorized scans for the tokenizer       //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include "ScanKernel.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define SCANKERNEL_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SSE2_TARGET
+#define AVX2_TARGET
+#else
+#include <cpuid.h>
+#define SSE2_TARGET __attribute__((target("sse2")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace
+{
+	//----< scalar versions, also used for tails of vector scans >---
+
+	inline bool isBlank(unsigned char ch)
+	{
+		return ch == ' ' || ch == '\t' || ch == '\v' || ch == '\f';
+	}
+
+	inline bool isIdent(unsigned char ch)
+	{
+		return (unsigned)((ch | 0x20) - 'a') < 26u || (unsigned)(ch - '0') < 10u || ch == '_';
+	}
+
+	const char* skipBlanksScalar(const char* p, const char* end)
+	{
+		while(p != end && isBlank(*p))
+			++p;
+		return p;
+	}
+
+	const char* skipIdentScalar(const char* p, const char* end)
+	{
+		while(p != end && isIdent(*p))
+			++p;
+		return p;
+	}
+
+	const char* findFirstOfScalar(const char* p, const char* end, char a, char b, char c)
+	{
+		while(p != end && *p != a && *p != b && *p != c)
+			++p;
+		return p;
+	}
+
+	size_t countScalar(const char* p, const char* end, char ch)
+	{
+		size_t n = 0;
+		for(; p != end; ++p)
+			if(*p == ch)
+				++n;
+		return n;
+	}
+
+#ifdef SCANKERNEL_X86
+
+	//----< index of lowest set bit, bits must not be zero >---------
+
+	inline unsigned firstBit(unsigned bits)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, bits);
+		return (unsigned)index;
+#else
+		return (unsigned)__builtin_ctz(bits);
+#endif
+	}
+
+	//----< SSE2 versions, 16 bytes per step >------------------------
+
+	SSE2_TARGET const char* skipBlanksSse2(const char* p, const char* end)
+	{
+		const __m128i space = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t');
+		const __m128i vtab = _mm_set1_epi8('\v'), feed = _mm_set1_epi8('\f');
+		while(end - p >= 16)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			__m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+				_mm_or_si128(_mm_cmpeq_epi8(v, vtab), _mm_cmpeq_epi8(v, feed)));
+			unsigned bits = ~(unsigned)_mm_movemask_epi8(m) & 0xFFFFu;
+			if(bits)
+				return p + firstBit(bits);
+			p += 16;
+		}
+		return skipBlanksScalar(p, end);
+	}
+
+	// x is in [lo, lo+n) when x + (0x80 - lo) < 0x80 + n as signed bytes
+
+	SSE2_TARGET const char* skipIdentSse2(const char* p, const char* end)
+	{
+		const __m128i caseBit = _mm_set1_epi8(0x20), under = _mm_set1_epi8('_');
+		const __m128i alphaBias = _mm_set1_epi8((char)(0x80 - 'a')), alphaLimit = _mm_set1_epi8((char)(0x80 + 26));
+		const __m128i digitBias = _mm_set1_epi8((char)(0x80 - '0')), digitLimit = _mm_set1_epi8((char)(0x80 + 10));
+		while(end - p >= 16)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			__m128i alpha = _mm_cmplt_epi8(_mm_add_epi8(_mm_or_si128(v, caseBit), alphaBias), alphaLimit);
+			__m128i digit = _mm_cmplt_epi8(_mm_add_epi8(v, digitBias), digitLimit);
+			__m128i m = _mm_or_si128(_mm_or_si128(alpha, digit), _mm_cmpeq_epi8(v, under));
+			unsigned bits = ~(unsigned)_mm_movemask_epi8(m) & 0xFFFFu;
+			if(bits)
+				return p + firstBit(bits);
+			p += 16;
+		}
+		return skipIdentScalar(p, end);
+	}
+
+	SSE2_TARGET const char* findFirstOfSse2(const char* p, const char* end, char a, char b, char c)
+	{
+		const __m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b), vc = _mm_set1_epi8(c);
+		while(end - p >= 16)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			__m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)),
+				_mm_cmpeq_epi8(v, vc));
+			unsigned bits = (unsigned)_mm_movemask_epi8(m);
+			if(bits)
+				return p + firstBit(bits);
+			p += 16;
+		}
+		return findFirstOfScalar(p, end, a, b, c);
+	}
+
+	// matches are summed per byte lane, at most 255 steps at a time
+
+	SSE2_TARGET size_t countSse2(const char* p, const char* end, char ch)
+	{
+		const __m128i target = _mm_set1_epi8(ch), zero = _mm_setzero_si128();
+		size_t n = 0;
+		while(end - p >= 16)
+		{
+			__m128i lanes = zero;
+			for(int step=0; step<255 && end - p >= 16; ++step, p += 16)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(v, target));
+			}
+			__m128i sums = _mm_sad_epu8(lanes, zero);
+			n += (size_t)_mm_cvtsi128_si32(sums) + (size_t)_mm_extract_epi16(sums, 4);
+		}
+		return n + countScalar(p, end, ch);
+	}
+
+	//----< AVX2 versions, 32 bytes per step >------------------------
+
+	AVX2_TARGET const char* skipBlanksAvx2(const char* p, const char* end)
+	{
+		const __m256i space = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t');
+		const __m256i vtab = _mm256_set1_epi8('\v'), feed = _mm256_set1_epi8('\f');
+		while(end - p >= 32)
+		{
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			__m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, vtab), _mm256_cmpeq_epi8(v, feed)));
+			unsigned bits = ~(unsigned)_mm256_movemask_epi8(m);
+			if(bits)
+				return p + firstBit(bits);
+			p += 32;
+		}
+		return skipBlanksSse2(p, end);
+	}
+
+	AVX2_TARGET const char* skipIdentAvx2(const char* p, const char* end)
+	{
+		const __m256i caseBit = _mm256_set1_epi8(0x20), under = _mm256_set1_epi8('_');
+		const __m256i alphaBias = _mm256_set1_epi8((char)(0x80 - 'a')), alphaLimit = _mm256_set1_epi8((char)(0x80 + 26));
+		const __m256i digitBias = _mm256_set1_epi8((char)(0x80 - '0')), digitLimit = _mm256_set1_epi8((char)(0x80 + 10));
+		while(end - p >= 32)
+		{
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			__m256i alpha = _mm256_cmpgt_epi8(alphaLimit, _mm256_add_epi8(_mm256_or_si256(v, caseBit), alphaBias));
+			__m256i digit = _mm256_cmpgt_epi8(digitLimit, _mm256_add_epi8(v, digitBias));
+			__m256i m = _mm256_or_si256(_mm256_or_si256(alpha, digit), _mm256_cmpeq_epi8(v, under));
+			unsigned bits = ~(unsigned)_mm256_movemask_epi8(m);
+			if(bits)
+				return p + firstBit(bits);
+			p += 32;
+		}
+		return skipIdentSse2(p, end);
+	}
+
+	AVX2_TARGET const char* findFirstOfAvx2(const char* p, const char* end, char a, char b, char c)
+	{
+		const __m256i va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b), vc = _mm256_set1_epi8(c);
+		while(end - p >= 32)
+		{
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			__m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb)),
+				_mm256_cmpeq_epi8(v, vc));
+			unsigned bits = (unsigned)_mm256_movemask_epi8(m);
+			if(bits)
+				return p + firstBit(bits);
+			p += 32;
+		}
+		return findFirstOfSse2(p, end, a, b, c);
+	}
+
+	AVX2_TARGET size_t countAvx2(const char* p, const char* end, char ch)
+	{
+		const __m256i target = _mm256_set1_epi8(ch), zero = _mm256_setzero_si256();
+		size_t n = 0;
+		while(end - p >= 32)
+		{
+			__m256i lanes = zero;
+			for(int step=0; step<255 && end - p >= 32; ++step, p += 32)
+			{
+				__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				lanes = _mm256_sub_epi8(lanes, _mm256_cmpeq_epi8(v, target));
+			}
+			__m256i sums = _mm256_sad_epu8(lanes, zero);
+			__m128i half = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+			n += (size_t)_mm_cvtsi128_si32(half) + (size_t)_mm_extract_epi16(half, 4);
+		}
+		return n + countSse2(p, end, ch);
+	}
+
+	//----< highest level supported by processor and OS >-------------
+
+	ScanKernel::Level detectLevel()
+	{
+		unsigned regs[4] = { 0, 0, 0, 0 };   // eax, ebx, ecx, edx
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		unsigned maxLeaf = (unsigned)info[0];
+		__cpuid(info, 1);
+		for(int i=0; i<4; ++i)
+			regs[i] = (unsigned)info[i];
+#else
+		unsigned maxLeaf = __get_cpuid_max(0, 0);
+		if(maxLeaf >= 1)
+			__get_cpuid(1, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+		if((regs[3] & (1u << 26)) == 0)
+			return ScanKernel::scalar;
+		bool osSavesYmm = false;
+		if((regs[2] & (1u << 27)) && (regs[2] & (1u << 28)))   // OSXSAVE and AVX
+		{
+#ifdef _MSC_VER
+			unsigned long long xcr0 = _xgetbv(0);
+#else
+			unsigned lo, hi;
+			__asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+			unsigned long long xcr0 = ((unsigned long long)hi << 32) | lo;
+#endif
+			osSavesYmm = (xcr0 & 6) == 6;
+		}
+		if(!osSavesYmm || maxLeaf < 7)
+			return ScanKernel::sse2;
+#ifdef _MSC_VER
+		__cpuidex(info, 7, 0);
+		regs[1] = (unsigned)info[1];
+#else
+		__cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+		return (regs[1] & (1u << 5)) ? ScanKernel::avx2 : ScanKernel::sse2;
+	}
+
+#else
+
+	ScanKernel::Level detectLevel() { return ScanKernel::scalar; }
+
+#endif
+
+	//----< dispatch table for the selected level >-------------------
+
+	struct Kernels
+	{
+		ScanKernel::Level level;
+		const char* (*skipBlanks)(const char*, const char*);
+		const char* (*skipIdent)(const char*, const char*);
+		const char* (*findFirstOf)(const char*, const char*, char, char, char);
+		size_t (*count)(const char*, const char*, char);
+	};
+
+	Kernels kernelsFor(ScanKernel::Level lvl)
+	{
+		Kernels k = { ScanKernel::scalar, skipBlanksScalar, skipIdentScalar, findFirstOfScalar, countScalar };
+#ifdef SCANKERNEL_X86
+		if(lvl == ScanKernel::sse2)
+		{
+			Kernels k2 = { ScanKernel::sse2, skipBlanksSse2, skipIdentSse2, findFirstOfSse2, countSse2 };
+			k = k2;
+		}
+		if(lvl == ScanKernel::avx2)
+		{
+			Kernels k3 = { ScanKernel::avx2, skipBlanksAvx2, skipIdentAvx2, findFirstOfAvx2, countAvx2 };
+			k = k3;
+		}
+#endif
+		return k;
+	}
+
+	const ScanKernel::Level supported = detectLevel();
+	Kernels active = kernelsFor(supported);
+}
+
+//----< level in use >-----------------------------------------------
+
+ScanKernel::Level ScanKernel::level() { return active.level; }
+
+//----< best level this machine supports >---------------------------
+
+ScanKernel::Level ScanKernel::supportedLevel() { return supported; }
+
+//----< select level, limited to what is supported, not thread safe >
+
+ScanKernel::Level ScanKernel::setLevel(Level lvl)
+{
+	active = kernelsFor(lvl < supported ? lvl : supported);
+	return active.level;
+}
+//----< name of level, for display >---------------------------------
+
+const char* ScanKernel::levelName(Level lvl)
+{
+	switch(lvl)
+	{
+	case sse2: return "SSE2";
+	case avx2: return "AVX2";
+	default:   return "scalar";
+	}
+}
+//----< first byte at or after p that isn't a blank >----------------
+
+const char* ScanKernel::skipBlanks(const char* p, const char* end)
+{
+	return active.skipBlanks(p, end);
+}
+//----< first byte at or after p that isn't an identifier char >-----
+
+const char* ScanKernel::skipIdent(const char* p, const char* end)
+{
+	return active.skipIdent(p, end);
+}
+//----< first byte at or after p equal to a, b, or c >---------------
+
+const char* ScanKernel::findFirstOf(const char* p, const char* end, char a, char b, char c)
+{
+	return active.findFirstOf(p, end, a, b, c);
+}
+//----< number of bytes in [p, end) equal to ch >--------------------
+
+size_t ScanKernel::count(const char* p, const char* end, char ch)
+{
+	return active.count(p, end, ch);
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_SCANKERNEL
+
+#include <iostream>
+#include <string>
+#include "FileMap.h"
+
+// compare every level with the scalar scans, starting at every offset
+
+int main(int argc, char* argv[])
+{
+	using namespace ScanKernel;
+	std::cout << "\n  Testing ScanKernel functions\n "
+		<< std::string(30,'=') << std::endl;
+	std::cout << "\n  supported level: " << levelName(supportedLevel());
+
+	std::string text = "  \t\vfoo_Bar42 /* a * b */ \"str\\\"ing\" {\n}\n\f";
+	for(int i=1; i<argc; ++i)
+	{
+		FileMap fm;
+		if(fm.open(argv[i]))
+			text.append(fm.begin(), fm.end());
+	}
+	for(int ch=0; ch<256; ++ch)
+		text.append(40, (char)ch).append(1, (char)ch);
+
+	size_t failures = 0;
+	const char* b = text.data();
+	const char* e = b + text.size();
+	for(int lvl=sse2; lvl<=(int)supportedLevel(); ++lvl)
+	{
+		setLevel((Level)lvl);
+		for(const char* p=b; p<e; ++p)
+		{
+			if(skipBlanks(p, e) != skipBlanksScalar(p, e) ||
+				skipIdent(p, e) != skipIdentScalar(p, e) ||
+				findFirstOf(p, e, '*', '\n', '\r') != findFirstOfScalar(p, e, '*', '\n', '\r') ||
+				findFirstOf(p, e, (char)0xFF, '"', '\\') != findFirstOfScalar(p, e, (char)0xFF, '"', '\\'))
+				++failures;
+			if((p - b) % 97 == 0 && count(p, e, '\n') != countScalar(p, e, '\n'))
+				++failures;
+		}
+		std::cout << "\n  " << levelName((Level)lvl) << ": " << text.size()
+			<< " offsets checked against scalar scans";
+	}
+	setLevel(supportedLevel());
+	std::cout << "\n  " << failures << " differences\n\n";
+	return failures == 0 ? 0 : 1;
+}
+
+#endif
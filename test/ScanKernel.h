@@ -0,0 +1,66 @@
+#ifndef SCANKERNEL_H
+#define SCANKERNEL_H
+///////////////////////////////////////////////////////////////
+// ScanKernel.h - vectorized scans for the tokenizer         //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+This module provides the bulk scans Toker uses to skip runs of
+characters that can't end what it is currently collecting: blanks
+between tokens, identifier characters, and the bodies of comments
+and quotes.  Each function examines 16 bytes per step with SSE2, or
+32 bytes per step with AVX2 when the processor and operating system
+support it.  The level is selected once, at startup, with cpuid.
+Other processors use the scalar versions.
+
+All functions work on the range [p, end) and never read outside it.
+
+Public Interface:
+=================
+using namespace ScanKernel;
+const char* q = skipBlanks(p, end);    // first byte not ' ', \t, \v, \f
+q = skipIdent(p, end);                 // first byte not [A-Za-z0-9_]
+q = findFirstOf(p, end, '*', '\r', '\r');  // first of up to 3 bytes
+size_t n = count(p, end, '\n');        // occurrences of a byte
+Level lvl = level();                   // scalar, sse2, or avx2
+setLevel(scalar);                      // force a level, for testing
+
+Build Process:
+==============
+Required files
+- ScanKernel.h, ScanKernel.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_SCANKERNEL ScanKernel.cpp FileMap.cpp /link setargv.obj
+
+Maintenance History:
+====================
+ver 1.0 : 16 Oct 26
+- first release
+*/
+
+#include <cstddef>
+
+namespace ScanKernel
+{
+	enum Level { scalar, sse2, avx2 };
+
+	Level level();
+	Level supportedLevel();
+	Level setLevel(Level lvl);
+	const char* levelName(Level lvl);
+
+	const char* skipBlanks(const char* p, const char* end);
+	const char* skipIdent(const char* p, const char* end);
+	const char* findFirstOf(const char* p, const char* end, char a, char b, char c);
+	size_t count(const char* p, const char* end, char ch);
+}
+
+#endif
@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////////////////////
 // ScopeStack.cpp - implements template stack holding specified element type //
-// ver 2.0                                                                   //
+// ver 2.2                                                                   //
 // Language:      Visual C++ 2010, SP1                                       //
 // Platform:      Dell Precision T7400, Win 7 Pro SP1                        //
 // Application:   Code Analysis Research                                     //
@@ -79,3 +79,69 @@ int main()
 }
 
 #endif
+
+//----< benchmark stub >-------------------------------------------------
+/*
+ *  Rules check the scope stack on every semi-expression.  Up to ver 2.1
+ *  they copied it to do so, which costs time in proportion to nesting
+ *  depth.  This times that check, copying a list as before and reading
+ *  size() and top() as now, on stacks of increasing depth.
+ */
+#ifdef BENCH_SCOPESTACK
+
+#include <string>
+#include <list>
+#include <iostream>
+#include <iomanip>
+#include "ScopeStack.h"
+#include "Timer.h"
+
+struct scope
+{
+  std::string type;
+  std::string name;
+  size_t lineCount;
+};
+
+int main()
+{
+  std::cout << "\n  Benchmarking scope checks by nesting depth";
+  std::cout << "\n ============================================\n";
+
+  const size_t numChecks = 20000;     // semi-expressions, each checked by 4 rules
+  size_t depths[] = { 1, 8, 32, 128, 512 };
+  std::cout << "\n  depth   list copy   vector top   (ms per " << numChecks << " semi-expressions)";
+  for(size_t d=0; d<sizeof(depths)/sizeof(depths[0]); ++d)
+  {
+    std::list<scope> oldStack;
+    ScopeStack<scope> newStack;
+    for(size_t i=0; i<depths[d]; ++i)
+    {
+      scope item = { i % 2 ? "function" : "class", "aScopeWithALongerName", i };
+      oldStack.push_back(item);
+      newStack.push(item);
+    }
+    size_t hits[2] = { 0, 0 };
+    Timer timer;
+    for(size_t n=0; n<numChecks; ++n)
+      for(int rule=0; rule<4; ++rule)
+      {
+        std::list<scope> tempStack = oldStack;
+        if(tempStack.size() > 0 && tempStack.back().type == "function")
+          ++hits[0];
+      }
+    double oldMs = 1000 * timer.elapsed();
+    timer.restart();
+    for(size_t n=0; n<numChecks; ++n)
+      for(int rule=0; rule<4; ++rule)
+        if(newStack.size() > 0 && newStack.top().type == "function")
+          ++hits[1];
+    double newMs = 1000 * timer.elapsed();
+    std::cout << std::fixed << std::setprecision(2) << "\n  " << std::setw(5) << depths[d]
+              << std::setw(12) << oldMs << std::setw(13) << newMs
+              << (hits[0] == hits[1] ? "" : "   results differ");
+  }
+  std::cout << "\n\n";
+}
+
+#endif
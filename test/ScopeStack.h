@@ -2,7 +2,7 @@
 #define SCOPESTACK_H
 /////////////////////////////////////////////////////////////////////////////
 // ScopeStack.h - implements template stack holding specified element type //
-// ver 2.0                                                                 //
+// ver 2.2                                                                 //
 // Language:      Visual C++ 2010, SP1                                     //
 // Platform:      Dell Precision T7400, Win 7 Pro SP1                      //
 // Application:   Code Analysis Research                                   //
@@ -16,6 +16,11 @@
   is an application specific type designed to hold whatever information you
   need to stack.
 
+  Elements are held in a std::vector, so pushing and popping reuse its
+  storage instead of allocating a list node per element.  Rules that only
+  need to know how deep they are, or what the innermost scope is, use
+  size() and top() on the stack itself rather than copying it.
+
   Public Interface:
   =================
   ScopeStack<element> stack;
@@ -23,6 +28,8 @@
   element elem;
   stack.push(elem);
   element popped = stack.pop();
+  const element& inner = stack.top();   // innermost element, not copied
+  size_t depth = stack.size();
 
   Required Files:
   ===============
@@ -31,9 +38,14 @@
   Build Command:
   ==============
   devenv ScopeStack.sln /rebuild debug
+  cl /EHsc /O2 /DBENCH_SCOPESTACK ScopeStack.cpp
 
   Maintenance History:
   ====================
+  ver 2.2 : 17 Oct 26
+  - elements are held in a std::vector instead of a std::list
+  - added top(), and const size(), for reading the stack without copying it
+  - added BENCH_SCOPESTACK stub
   ver 2.1 : 02 Jun 11
   - changed ScopeStack type to single template argument intended to be
     an application specific type (usually a struct that holds whatever
@@ -43,7 +55,7 @@
   ver 1.0 : 31 Jan 11
   - first release
 */
-#include <list>
+#include <vector>
 
 // element is a application specific type.  It must provide a function:
 // std::string show() that returns a string display of its parts. see
@@ -52,18 +64,22 @@
 template<typename element>
 class ScopeStack {
 public:
-  typename typedef std::list<element>::iterator iterator;
+  typename typedef std::vector<element>::iterator iterator;
   void push(const element& item);
   element pop();
-  size_t size();
+  const element& top() const;
+  size_t size() const;
   iterator begin();
   iterator end();
 private:
-  std::list<element> stack;
+  std::vector<element> stack;
 };
 
 template<typename element>
-typename inline size_t ScopeStack<element>::size() { return stack.size(); }
+typename inline size_t ScopeStack<element>::size() const { return stack.size(); }
+
+template<typename element>
+typename inline const element& ScopeStack<element>::top() const { return stack.back(); }
 
 template<typename element>
 typename inline ScopeStack<element>::iterator ScopeStack<element>::begin() { return stack.begin(); }
@@ -0,0 +1,326 @@
+///////////////////////////////////////////////////////////////
+// SemiCache.cpp - recorded semi-expression streams          //
+// Ver 1.4                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include <sstream>
+#include <cstdlib>
+#include "SemiCache.h"
+#include "SemiStore.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+//----< move to a 64 bit offset of a file >--------------------------
+
+static bool seekTo(FILE* pFile, unsigned long long offset)
+{
+#ifdef _MSC_VER
+	return _fseeki64(pFile, (__int64)offset, SEEK_SET) == 0;
+#else
+	return fseeko(pFile, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+//----< empty recording >--------------------------------------------
+
+SemiRecording::SemiRecording() : complete(false), spilled(false), spillOffset(0) {}
+
+SemiRecording::~SemiRecording() {}
+
+//----< append a frame, the tokens collected by one get() >----------
+
+void SemiRecording::add(const TokId* ids, size_t numToks, int lines, Ending ending)
+{
+	Frame f;
+	f.numToks = (unsigned)numToks;
+	f.lines = lines;
+	f.ending = ending;
+	firstTok.push_back(toks.size());
+	frames.push_back(f);
+	toks.insert(toks.end(), ids, ids + numToks);
+	if(ending == noMoreTokens)
+		complete = true;
+}
+//----< remove all frames, keeping memory for the next ones >-------
+
+void SemiRecording::clear()
+{
+	spilled = false;
+	toks.clear();
+	frames.clear();
+	firstTok.clear();
+	complete = false;
+}
+//----< memory used, counting tokens even while spilled >------------
+
+size_t SemiRecording::bytes() const
+{
+	return numTokens() * sizeof(TokId) + frames.size() * (sizeof(Frame) + sizeof(size_t));
+}
+//----< write tokens at offset of the spill file, false if it can't >
+
+bool SemiRecording::spill(FILE* pFile, unsigned long long offset)
+{
+	if(spilled || toks.size() == 0 || pFile == 0)
+		return false;
+	if(!seekTo(pFile, offset) ||
+		fwrite(&toks[0], sizeof(TokId), toks.size(), pFile) != toks.size())
+		return false;
+	spilled = true;
+	spillOffset = offset;
+	std::vector<TokId>().swap(toks);
+	return true;
+}
+//----< read spilled tokens back, false if that fails >--------------
+
+bool SemiRecording::load(FILE* pFile)
+{
+	if(!spilled)
+		return true;
+	std::vector<TokId> ids(numTokens());
+	bool ok = pFile != 0 && seekTo(pFile, spillOffset) &&
+		fread(&ids[0], sizeof(TokId), ids.size(), pFile) == ids.size();
+	spilled = false;
+	if(!ok)
+	{
+		// can't replay, so drop the stream
+		frames.clear();
+		firstTok.clear();
+		complete = false;
+		return false;
+	}
+	toks.swap(ids);
+	return true;
+}
+
+//----< cache that keeps up to maxBytesInMemory of recordings >------
+
+SemiCache::SemiCache(size_t maxBytesInMemory)
+	: pStore(0), maxBytes(maxBytesInMemory), memBytes(0), spilled(0),
+	  pSpillFile(0), spillEnd(0), spillFailed(false) {}
+
+//----< destructor deletes all recordings, and the spill file >------
+
+SemiCache::~SemiCache()
+{
+	std::map<std::string, SemiRecording*>::iterator it;
+	for(it = recordings.begin(); it != recordings.end(); ++it)
+		delete it->second;
+	if(pSpillFile)
+	{
+		fclose(pSpillFile);
+		std::remove(spillPath.c_str());
+	}
+}
+//----< file spilled tokens go to, made on first use, or 0 >---------
+/*
+ *  In the store's directory, where we know we can write, or else in
+ *  the temporary directory.  The name is unique to the process and
+ *  the cache.
+ */
+FILE* SemiCache::spillFile()
+{
+	if(pSpillFile || spillFailed)
+		return pSpillFile;
+	std::string dir;
+	if(pStore)
+		dir = pStore->directory();
+	else
+	{
+#ifdef _WIN32
+		char temp[MAX_PATH + 1];
+		DWORD len = GetTempPathA(sizeof(temp), temp);
+		if(len > 0 && len < sizeof(temp))
+			dir.assign(temp, len);
+#else
+		const char* temp = getenv("TMPDIR");
+		dir = temp ? temp : "/tmp";
+#endif
+	}
+	if(dir.size() > 0 && dir[dir.size() - 1] != '\\' && dir[dir.size() - 1] != '/')
+		dir += '/';
+	std::ostringstream name;
+	name << dir << "semispill_" << getpid() << "_" << (const void*)this << ".tmp";
+	spillPath = name.str();
+	pSpillFile = fopen(spillPath.c_str(), "w+b");
+	if(pSpillFile == 0)
+		spillFailed = true;
+	return pSpillFile;
+}
+//----< new recording for a file, replacing any earlier one >--------
+
+SemiRecording* SemiCache::startRecording(const std::string& fileName)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	drop(fileName);
+	SemiRecording* pRec = new SemiRecording;
+	recordings[fileName] = pRec;
+	return pRec;
+}
+//----< keep recording if complete, spilling it if memory is full >--
+/*
+ *  New recordings are also saved in the store, if there is one.
+ */
+void SemiCache::endRecording(const std::string& fileName)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	std::map<std::string, SemiRecording*>::iterator it = recordings.find(fileName);
+	if(it == recordings.end())
+		return;
+	SemiRecording* pRec = it->second;
+	if(!pRec->isComplete())
+	{
+		delete pRec;
+		recordings.erase(it);
+		restored.erase(fileName);
+		return;
+	}
+	if(pStore && restored.erase(fileName) == 0)
+		pStore->save(fileName, *pRec);
+	if(memBytes + pRec->bytes() > maxBytes && pRec->spill(spillFile(), spillEnd))
+	{
+		spillEnd += pRec->numTokens() * sizeof(TokId);
+		++spilled;
+	}
+	else
+		memBytes += pRec->bytes();
+}
+//----< complete recording of a file, in memory, or 0 >--------------
+
+SemiRecording* SemiCache::find(const std::string& fileName)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	std::map<std::string, SemiRecording*>::iterator it = recordings.find(fileName);
+	if(it == recordings.end() || !it->second->isComplete())
+		return 0;
+	SemiRecording* pRec = it->second;
+	if(pRec->isSpilled())
+	{
+		if(!pRec->load(pSpillFile))
+			return 0;
+		memBytes += pRec->bytes();
+	}
+	return pRec;
+}
+//----< drop a file's recording >------------------------------------
+
+void SemiCache::erase(const std::string& fileName)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	drop(fileName);
+}
+//----< erase(), with the lock held >--------------------------------
+
+void SemiCache::drop(const std::string& fileName)
+{
+	std::map<std::string, SemiRecording*>::iterator it = recordings.find(fileName);
+	if(it == recordings.end())
+		return;
+	// restored recordings aren't counted until endRecording()
+	bool counted = restored.erase(fileName) == 0;
+	if(counted && it->second->isComplete() && !it->second->isSpilled())
+		memBytes -= it->second->bytes();
+	delete it->second;
+	recordings.erase(it);
+}
+//----< use store's recording of an unchanged file, or return 0 >----
+/*
+ *  Call endRecording() after replaying it, as for a new recording.
+ */
+SemiRecording* SemiCache::restore(const std::string& fileName)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	if(pStore == 0)
+		return 0;
+	SemiRecording* pRec = pStore->load(fileName);
+	if(pRec == 0)
+		return 0;
+	drop(fileName);
+	recordings[fileName] = pRec;
+	restored.insert(fileName);
+	return pRec;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_SEMICACHE
+
+#include <iostream>
+
+int main()
+{
+	std::cout << "\n  Testing SemiCache class\n "
+		<< std::string(25,'=') << std::endl;
+
+	// record two files' streams in a cache that holds about one
+
+	SemiCache cache(200);
+	const char* files[] = { "one.cpp", "two.cpp" };
+	for(int f=0; f<2; ++f)
+	{
+		SemiRecording* pRec = cache.startRecording(files[f]);
+		TokId frame[] = { tok_class, internTok("Widget"), tok_lbrace };
+		for(int i=0; i<5; ++i)
+			pRec->add(frame, 3, i + 1, SemiRecording::atTerminator);
+		pRec->add(frame, 0, 6, SemiRecording::noMoreTokens);
+		cache.endRecording(files[f]);
+	}
+	std::cout << "\n  " << cache.bytesInMemory() << " bytes in memory, "
+		<< cache.numSpilled() << " recording spilled";
+
+	// incomplete recordings aren't kept
+
+	cache.startRecording("three.cpp");
+	cache.endRecording("three.cpp");
+	std::cout << "\n  three.cpp " << (cache.find("three.cpp") ? "was" : "wasn't") << " kept";
+
+	for(int f=0; f<2; ++f)
+	{
+		SemiRecording* pRec = cache.find(files[f]);
+		std::cout << "\n  " << files[f] << ": " << pRec->numFrames() << " frames, first is";
+		const TokId* ids = pRec->tokens(0);
+		for(size_t i=0; i<pRec->frame(0).numToks; ++i)
+			std::cout << " " << TokenPool::instance().text(ids[i]);
+		std::cout << ", line " << pRec->frame(0).lines;
+	}
+
+	// more spilled recordings than the CRT has streams, all in one file
+
+	SemiCache small(200);
+	const size_t numFiles = 2000;
+	for(size_t f=0; f<numFiles; ++f)
+	{
+		std::ostringstream name;
+		name << "file" << f << ".cpp";
+		SemiRecording* pRec = small.startRecording(name.str());
+		TokId frame[] = { tok_class, internTok(name.str()), tok_lbrace };
+		pRec->add(frame, 3, 1, SemiRecording::atTerminator);
+		pRec->add(frame, 0, 2, SemiRecording::noMoreTokens);
+		small.endRecording(name.str());
+	}
+	size_t replayed = 0;
+	for(size_t f=numFiles; f>0; --f)
+	{
+		std::ostringstream name;
+		name << "file" << f - 1 << ".cpp";
+		SemiRecording* pRec = small.find(name.str());
+		if(pRec && pRec->numTokens() == 3 && TokenPool::instance().text(pRec->tokens(0)[1]) == name.str())
+			++replayed;
+	}
+	std::cout << "\n  " << numFiles << " recordings, " << small.numSpilled()
+		<< " spilled, " << replayed << " read back intact";
+	std::cout << "\n\n";
+}
+
+#endif
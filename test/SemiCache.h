@@ -0,0 +1,201 @@
+#ifndef SEMICACHE_H
+#define SEMICACHE_H
+///////////////////////////////////////////////////////////////
+// SemiCache.h - recorded semi-expression streams            //
+// Ver 1.4                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+The executive parses every file twice, once to find types and once
+to find their relationships, and both passes collect the same
+semi-expressions.  This module lets the first pass record them, so
+the second pass can replay them without reading or tokenizing the
+file again.
+
+A SemiRecording holds one file's stream in compact form: the TokId
+of every token, and for each call of SemiExp::get() the number of
+tokens it collected, the toker's line count, and how the call ended.
+Token text stays in the TokenPool.  SemiExp::record() fills a
+recording and SemiExp::replay() plays it back.  clear() empties a
+recording but keeps its memory, so it can be filled again, e.g., with
+the next batch of a SemiPipe.
+
+A SemiCache holds the recordings of all files, by file name.  When
+recordings take more memory than the cache is allowed, the tokens of
+further ones are appended to one spill file, and read back when
+replayed; each spilled recording keeps its offset in the file.  Space
+of recordings read back isn't reused.  The
+spill file is made, when first needed, in the SemiStore's directory,
+if the cache uses one, or else in the user's temporary directory, and
+removed by the cache's destructor.
+
+A SemiCache may also use a SemiStore, which keeps recordings on disk
+from one run to the next.  restore() then loads a file's recording,
+if the file hasn't changed since it was saved, and endRecording()
+saves each new recording there.
+
+A SemiCache may be shared by parsers on several threads, e.g., the
+workers of a ParserPool.  Each call takes the cache's lock, and a
+recording belongs to the thread that started or found it.
+
+Public Interface:
+=================
+SemiCache cache(64 << 20);                 // keep up to 64 MB in memory
+SemiRecording* pRec = cache.startRecording(fileName);
+se.record(pRec);                           // pass 1: get() records
+...
+cache.endRecording(fileName);              // keep it if se reached end
+SemiRecording* pPlay = cache.find(fileName);  // 0 if not recorded
+if(pPlay)
+  se.replay(pPlay);                        // pass 2: get() replays
+size_t n = cache.numSpilled();             // recordings on disk
+cache.useStore(&store);                    // keep recordings between runs
+SemiRecording* pOld = cache.restore(fileName); // last run's, or 0
+
+Build Process:
+==============
+Required files
+- SemiCache.h, SemiCache.cpp, SemiStore.h, SemiStore.cpp,
+FileMap.h, FileMap.cpp, TokenPool.h, TokenPool.cpp, StrView.h, StrView.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_SEMICACHE SemiCache.cpp SemiStore.cpp FileMap.cpp \
+TokenPool.cpp StrView.cpp
+
+Maintenance History:
+====================
+ver 1.4 : 17 Oct 26
+- recordings spill to one file per cache, in a writable directory,
+instead of a tmpfile() each, and keep their offsets in it
+ver 1.3 : 17 Oct 26
+- calls are serialized by a mutex, so parser threads can share a cache
+ver 1.2 : 17 Oct 26
+- added SemiRecording::clear(), for recordings that are reused
+ver 1.1 : 17 Oct 26
+- added useStore() and restore(), to keep recordings between runs
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdio>
+#include <mutex>
+#include "TokenPool.h"
+
+///////////////////////////////////////////////////////////////
+// SemiRecording: one file's semi-expression stream
+
+class SemiRecording
+{
+public:
+	enum Ending { noMoreTokens, atFileEnd, atTerminator };
+
+	// one call of SemiExp::get()
+	struct Frame
+	{
+		unsigned numToks;
+		int lines;           // Toker::lines() when get() returned
+		Ending ending;
+	};
+
+	SemiRecording();
+	~SemiRecording();
+	void add(const TokId* ids, size_t numToks, int lines, Ending ending);
+	void clear();
+	bool isComplete() const;
+	size_t numFrames() const;
+	const Frame& frame(size_t n) const;
+	const TokId* tokens(size_t n) const;  // first token of frame n
+	size_t numTokens() const;             // even while spilled
+	size_t bytes() const;
+	bool spill(FILE* pFile, unsigned long long offset);  // at offset of pFile
+	bool load(FILE* pFile);
+	bool isSpilled() const;
+
+private:
+	std::vector<TokId> toks;
+	std::vector<Frame> frames;
+	std::vector<size_t> firstTok;         // index in toks of each frame
+	bool complete;                        // last frame ended stream
+	bool spilled;                         // toks are in the spill file
+	unsigned long long spillOffset;       // where, in bytes
+
+	// prohibit copying and assignment
+	SemiRecording(const SemiRecording&);
+	SemiRecording& operator=(const SemiRecording&);
+};
+
+inline bool SemiRecording::isComplete() const { return complete; }
+
+inline size_t SemiRecording::numFrames() const { return frames.size(); }
+
+inline const SemiRecording::Frame& SemiRecording::frame(size_t n) const { return frames[n]; }
+
+inline const TokId* SemiRecording::tokens(size_t n) const
+{
+	return toks.size() == 0 ? 0 : &toks[0] + firstTok[n];
+}
+
+inline size_t SemiRecording::numTokens() const
+{
+	return frames.size() == 0 ? 0 : firstTok.back() + frames.back().numToks;
+}
+
+inline bool SemiRecording::isSpilled() const { return spilled; }
+
+class SemiStore;
+
+///////////////////////////////////////////////////////////////
+// SemiCache: recordings of many files, by file name
+
+class SemiCache
+{
+public:
+	SemiCache(size_t maxBytesInMemory = 64 << 20);
+	~SemiCache();
+	SemiRecording* startRecording(const std::string& fileName);
+	void endRecording(const std::string& fileName);
+	SemiRecording* find(const std::string& fileName);
+	void erase(const std::string& fileName);
+	void useStore(SemiStore* pStore);
+	SemiRecording* restore(const std::string& fileName);
+	size_t bytesInMemory() const;
+	size_t numSpilled() const;
+
+private:
+	void drop(const std::string& fileName);
+	FILE* spillFile();
+
+	std::mutex mtx;                       // guards everything below
+	std::map<std::string, SemiRecording*> recordings;
+	std::set<std::string> restored;       // loaded from pStore, not recorded
+	SemiStore* pStore;
+	size_t maxBytes;
+	size_t memBytes;
+	size_t spilled;
+	FILE* pSpillFile;                     // made by the first spill
+	std::string spillPath;
+	unsigned long long spillEnd;          // bytes written to it
+	bool spillFailed;                     // couldn't make it
+
+	// prohibit copying and assignment
+	SemiCache(const SemiCache&);
+	SemiCache& operator=(const SemiCache&);
+};
+
+inline void SemiCache::useStore(SemiStore* pStore_) { pStore = pStore_; }
+
+inline size_t SemiCache::bytesInMemory() const { return memBytes; }
+
+inline size_t SemiCache::numSpilled() const { return spilled; }
+
+#endif
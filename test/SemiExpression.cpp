@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  SemiExpression.cpp - Collects tokens for code analysis         //
-//  ver 2.1                                                        //
+//  ver 3.0                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -11,29 +11,69 @@
 
 #include <algorithm>
 #include "SemiExpression.h"
+#include "SemiCache.h"
+#include "SemiPipe.h"
 
 //----< construct SemiExp instance >---------------------------
 
-SemiExp::SemiExp(Toker* pTokr) : pToker(pTokr), Verbose(false),
+SemiExp::SemiExp(Toker* pTokr) : pToker(pTokr),
+                                 pRecording(0), pReplay(0), replayFrame(0), pPipe(0), start(0),
+                                 summarized(false), Verbose(false),
                                  commentIsSemiExp(false), doReturnNewLines(true)
 {
 }
+//----< copy constructor, copy owns all of its tokens >-------
+//
+//  copies neither record, replay, nor pipe
+
+SemiExp::SemiExp(const SemiExp& se)
+  : pToker(se.pToker),
+    pRecording(0), pReplay(0), replayFrame(0), pPipe(0),
+    ids(se.ids.begin() + se.start, se.ids.end()), start(0), summarized(false),
+    Verbose(se.Verbose),
+    commentIsSemiExp(se.commentIsSemiExp), doReturnNewLines(se.doReturnNewLines)
+{
+  for(size_t i=se.start; i<se.toks.size(); ++i)
+    toks.push_back(own(se.toks[i]));
+}
+//----< assignment, target owns all of its tokens >------------
+
+SemiExp& SemiExp::operator=(const SemiExp& se)
+{
+  if(this == &se)
+    return *this;
+  pToker = se.pToker;
+  Verbose = se.Verbose;
+  commentIsSemiExp = se.commentIsSemiExp;
+  doReturnNewLines = se.doReturnNewLines;
+  clear();
+  for(size_t i=se.start; i<se.toks.size(); ++i)
+    toks.push_back(own(se.toks[i]));
+  ids.assign(se.ids.begin() + se.start, se.ids.end());
+  return *this;
+}
 //----< destructor >-------------------------------------------
 
 SemiExp::~SemiExp()
 {
 }
+//----< keep a copy of token's text that lives as long as se >-
+
+StrView SemiExp::own(const StrView& tok)
+{
+  return owned.copy(tok);
+}
 //----< is this a terminating token? >-------------------------
 
-bool SemiExp::isTerminator(std::string tok)
+bool SemiExp::isTerminator(const StrView& tok, TokId id)
 {
-  if(tok.length() == 0)
+  if(id == tok_empty)
     return false;
-  if(tok == "{" || tok == "}" || tok == ";")
+  if(id == tok_lbrace || id == tok_rbrace || id == tok_semicolon)
     return true;
-  if(tok == "\n")
+  if(id == tok_newline)
   {
-    size_t n = find("#");
+    size_t n = find(tok_hash);
     if(n < length())
       return true;
   }
@@ -46,18 +86,30 @@ bool SemiExp::isTerminator(std::string tok)
 
 bool SemiExp::get(bool clear)
 {
+  if(pReplay || pPipe)
+    return replayGet(clear);
   if(clear)
-    toks.clear();
-  std::string tok;
+    this->clear();
+  summarized = false;
+  size_t first = ids.size();      // first token this call collects
+  StrView tok;
+  TokId id;
   do
   {
     if(pToker->isFileEnd())
     {
       if(length() > 0)
+      {
+        if(pRecording)
+          pRecording->add(ids.data() + first, ids.size() - first, pToker->lines(),
+                          SemiRecording::atFileEnd);
         return true;
+      }
+      if(pRecording)
+        pRecording->add(0, 0, pToker->lines(), SemiRecording::noMoreTokens);
       return false;
     }
-    tok = pToker->getTok();
+    tok = pToker->getTokView();
     if(Verbose)
     {
       if(tok != "\n")
@@ -65,15 +117,72 @@ bool SemiExp::get(bool clear)
       else
         std::cout << "\n--tok=newline\n";
     }
-    if(tok != "\n" || doReturnNewLines)
+    id = internTok(tok);
+    if(id != tok_newline || doReturnNewLines)
+    {
+      if(pToker->isTransient(tok))
+        tok = own(tok);
       toks.push_back(tok);
-  } while(!isTerminator(tok));
+      ids.push_back(id);
+    }
+  } while(!isTerminator(tok, id));
+  if(pRecording)
+    pRecording->add(ids.data() + first, ids.size() - first, pToker->lines(),
+                    SemiRecording::atTerminator);
   trimFront();
   return true;
 }
+//----< return next recorded semi-expression, as get() did >--
+//
+//  a piped SemiExp replays one batch after another, giving each
+//  back to the pipe when it starts the next
+
+bool SemiExp::replayGet(bool clear)
+{
+  if(clear)
+    this->clear();
+  summarized = false;
+  if(pPipe && (pReplay == 0 || replayFrame == pReplay->numFrames()))
+  {
+    if(pReplay)
+      pPipe->release();
+    pReplay = 0;                   // released, even if acquire() throws
+    pReplay = pPipe->acquire();
+    replayFrame = 0;
+    if(pReplay == 0)
+      return false;
+  }
+  if(replayFrame == pReplay->numFrames())
+    return false;
+  const SemiRecording::Frame& frame = pReplay->frame(replayFrame);
+  const TokId* pIds = pReplay->tokens(replayFrame);
+  ++replayFrame;
+  TokenPool& pool = TokenPool::instance();
+  for(size_t i=0; i<frame.numToks; ++i)
+  {
+    toks.push_back(pool.text(pIds[i]));  // pool text lives as long as the pool
+    ids.push_back(pIds[i]);
+  }
+  pToker->lines() = frame.lines;
+  if(pRecording)
+    pRecording->add(pIds, frame.numToks, frame.lines, frame.ending);
+  if(frame.ending == SemiRecording::noMoreTokens)
+  {
+    if(pPipe)
+    {
+      pPipe->release();
+      pPipe->finish();
+      pReplay = 0;
+    }
+    return false;
+  }
+  if(frame.ending == SemiRecording::atTerminator)
+    trimFront();
+  return true;
+}
 //----< is this token a comment? >-----------------------------
 
-bool SemiExp::isComment(const std::string& tok)
+bool SemiExp::isComment(const StrView& tok)
 {
   if(tok.length() < 2) return false;
   if(tok[0] != '/') return false;
@@ -82,67 +191,107 @@ bool SemiExp::isComment(const std::string& tok)
 }
 //----< index operator >---------------------------------------
 
-std::string& SemiExp::operator[](int n)
+StrView SemiExp::operator[](int n)
+{
+  if(n < 0 || length() <= (size_t)n)
+    throw std::exception("SemiExp index out of range");
+  return toks[start + n];
+}
+//----< TokId of token at index >------------------------------
+
+TokId SemiExp::id(int n)
 {
-  if(n < 0 || toks.size() <= (size_t)n)
+  if(n < 0 || length() <= (size_t)n)
     throw std::exception("SemiExp index out of range");
-  return toks[n];
+  return ids[start + n];
 }
 //----< collect semi-expression as space-seperated string >----
 
 std::string SemiExp::show(bool showNewLines)
 {
-  if(toks.size() == 0)
+  if(length() == 0)
     return "";
   std::string temp;
-  for(size_t i=0; i<toks.size(); ++i)
+  for(size_t i=start; i<toks.size(); ++i)
     if(toks[i] != "\n" || showNewLines)
-      temp.append(" ").append(toks[i]);
+      temp.append(" ").append(toks[i].data(), toks[i].length());
   return temp;
 }
 //
 //----< is tok found in semi-expression? >---------------------
 
-size_t SemiExp::find(const std::string& tok)
+size_t SemiExp::find(const StrView& tok)
 {
-  for(size_t i=0; i<length(); ++i)
+  for(size_t i=start; i<toks.size(); ++i)
     if(tok == toks[i])
-      return i;
+      return i - start;
   return length();
 }
-//----< remove tok if found in semi-expression >---------------
+//----< is token with this id found in semi-expression? >------
+
+size_t SemiExp::find(TokId id)
+{
+  for(size_t i=start; i<ids.size(); ++i)
+    if(id == ids[i])
+      return i - start;
+  return length();
+}
+//----< positions of punctuators and keywords >----------------
+//
+//  rebuilt in one pass over ids only if the SemiExp has changed
 
-bool SemiExp::remove(const std::string& tok)
+const TokSummary& SemiExp::summary()
 {
-  std::vector<std::string>::iterator it;
-  it = std::find(toks.begin(),toks.end(),tok);
-  if(it != toks.end())
+  if(!summarized)
   {
-    toks.erase(it);
-    return true;
+    summ.clear(length());
+    for(size_t i=start; i<ids.size(); ++i)
+      summ.note(ids[i], i - start);
+    summarized = true;
   }
+  return summ;
+}
+//----< remove tok if found in semi-expression >---------------
+
+bool SemiExp::remove(const StrView& tok)
+{
+  size_t i = find(tok);
+  if(i < length())
+    return remove(i);
   return false;
 }
 //----< remove tok at specified indes >------------------------
+//
+//  the first token is removed by moving start past it
 
 bool SemiExp::remove(size_t i)
 {
-  if(i<0 || toks.size()<=i)
+  if(length()<=i)
     return false;
-  std::vector<std::string>::iterator it = toks.begin();
-    toks.erase(it+i);
+  summarized = false;
+  if(i == 0)
+  {
+    ++start;
+    return true;
+  }
+  toks.erase(toks.begin()+start+i);
+  ids.erase(ids.begin()+start+i);
   return true;
 }
 //----< merge from firstTok to token before secondTok >--------
 
-bool SemiExp::merge(const std::string& firstTok, const std::string& secondTok)
+bool SemiExp::merge(const StrView& firstTok, const StrView& secondTok)
 {
   size_t first = find(firstTok);
   size_t second = find(secondTok);
   if(first < length() && second < length())
   {
-    for(size_t i=first+1; i<second; ++i)
-      (*this)[first] += (*this)[i];
+    summarized = false;
+    std::string merged = toks[start+first];
+    for(size_t i=start+first+1; i<start+second; ++i)
+      merged.append(toks[i].data(), toks[i].length());
+    toks[start+first] = own(merged);
+    ids[start+first] = internTok(merged);
     for(size_t i=first+1; i<second; ++i)
       remove(first+1);
     return true;
@@ -153,19 +302,27 @@ bool SemiExp::merge(const std::string& firstTok, const std::string& secondTok)
 
 void SemiExp::trimFront()
 {
-  while(toks.size() > 0 && (toks[0] == "\n" || toks[0] == ""))
-    remove(0);
+  summarized = false;
+  while(start < ids.size() && (ids[start] == tok_newline || ids[start] == tok_empty))
+    ++start;
 }
-//----< make tokens lowercase >--------------------------------
+//----< make tokens lowercase, copying only changed tokens >---
 
 void SemiExp::toLower()
 {
-  for(size_t i=0; i<length(); ++i)
+  summarized = false;
+  for(size_t i=start; i<toks.size(); ++i)
   {
-    for(size_t j=0; j<(*this)[i].length(); ++j)
-    {
-      (*this)[i][j] = tolower((*this)[i][j]);
-    }
+    size_t j = 0;
+    while(j < toks[i].length() && isupper((unsigned char)toks[i][j]) == 0)
+      ++j;
+    if(j == toks[i].length())
+      continue;
+    std::string lower = toks[i];
+    for(; j<lower.length(); ++j)
+      lower[j] = tolower((unsigned char)lower[j]);
+    toks[i] = own(lower);
+    ids[i] = internTok(lower);
   }
 }
 
@@ -285,6 +442,123 @@ int main(int argc, char* argv[])
       std::cout << "\n  " << ex.what() << "\n\n";
     }
   }
+
+  // a replayed recording must return the same semi-expressions and lines
+
+  for(int i=1; i<argc; ++i)
+  {
+    try
+    {
+      Toker toker(argv[i]), replayToker;
+      SemiExp se(&toker), replayed(&replayToker);
+      SemiRecording recording;
+      se.record(&recording);
+      std::vector<std::string> shown;
+      std::vector<int> lines;
+      while(se.get())
+      {
+        shown.push_back(se.show(true));
+        lines.push_back(toker.lines());
+      }
+      replayed.replay(&recording);
+      size_t n = 0;
+      bool same = recording.isComplete();
+      for(; same && replayed.get(); ++n)
+        same = n < shown.size() && replayed.show(true) == shown[n] &&
+               replayToker.lines() == lines[n];
+      same = same && n == shown.size();
+      std::cout << "\n  replay of " << argv[i] << (same ? " matches" : " differs")
+                << " after " << n << " semi-expressions, "
+                << recording.bytes() << " bytes recorded\n";
+    }
+    catch(std::exception ex)
+    {
+      std::cout << "\n  " << ex.what() << "\n\n";
+    }
+  }
+}
+
+#endif
+
+//----< benchmark stub >---------------------------------------
+
+#ifdef BENCH_SEMIEXPRESSION
+
+#include <cstdlib>
+#include <new>
+#include "Timer.h"
+
+// every allocation made by this program is counted
+
+static size_t numAllocs = 0;
+
+void* operator new(size_t size)
+{
+  ++numAllocs;
+  void* p = malloc(size > 0 ? size : 1);
+  if(p == 0)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p)
+{
+  free(p);
+}
+//----< collect a file's semi-expressions, counting allocations >
+
+void measure(const char* file, bool mapped)
+{
+  Toker toker;
+  if(mapped)
+    toker.mapInput();
+  toker.returnComments();
+  if(!toker.attach(file))
+  {
+    std::cout << "\n    can't open file";
+    return;
+  }
+  SemiExp se(&toker);
+  se.makeCommentSemiExp();
+
+  // the first semi-expressions grow the token vectors and arena
+
+  const size_t warmUp = 100;
+  size_t numSemis = 0, warmUpAllocs = 0;
+  size_t start = numAllocs;
+  Timer timer;
+  while(se.get())
+    if(++numSemis == warmUp)
+      warmUpAllocs = numAllocs - start;
+  double secs = timer.elapsed();
+  size_t allocs = numAllocs - start;
+  std::cout << "\n    " << (mapped ? "mapped input: " : "stream input: ")
+            << numSemis << " semi-expressions in " << secs << " sec, ";
+  if(numSemis <= warmUp)
+    std::cout << (double)allocs / (numSemis > 0 ? numSemis : 1) << " allocations each";
+  else
+    std::cout << (double)warmUpAllocs / warmUp << " allocations each for the first "
+              << warmUp << ", " << (double)(allocs - warmUpAllocs) / (numSemis - warmUp)
+              << " after";
+}
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Benchmarking SemiExp allocations\n "
+            << std::string(34,'=') << std::endl;
+  if(argc < 2)
+  {
+    std::cout 
+      << "\n  please enter names of files to process on command line\n\n";
+    return 1;
+  }
+  for(int i=1; i<argc; ++i)
+  {
+    std::cout << "\n  Processing file " << argv[i];
+    measure(argv[i], false);
+    measure(argv[i], true);
+  }
+  std::cout << "\n\n";
 }
 
 #endif
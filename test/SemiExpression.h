@@ -2,7 +2,7 @@
 #define SEMIEXPRESSION_H
 /////////////////////////////////////////////////////////////////////
 //  SemiExpression.h - Collects tokens for code analysis           //
-//  ver 2.1                                                        //
+//  ver 3.0                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -25,9 +25,39 @@
   to complete the detection process.  This simplifies the design of code
   analysis tools.
 
-  Note that assignment and copying of SemiExp instances is supported, using
-  the default operations provided by the C++ language.  Copies and assignments
-  result in both source and target SemiExp instances sharing the same toker.
+  Tokens are held as StrViews.  Those that the toker can show as views into
+  its mapped source are not copied at all.  Only tokens the toker can't
+  show that way, or that SemiExp builds itself, e.g., with merge, toLower,
+  or push_back, are copied into a TextArena owned by the SemiExp.  The
+  arena, and the token vectors, are reused each time the SemiExp is
+  cleared, so in steady state collecting a semi-expression allocates
+  nothing.  Tokens removed from the front, e.g., by trimFront(), are
+  skipped by advancing a start index instead of being erased.
+
+  Each token's TokId, from the TokenPool, is kept alongside it, so
+  find(TokId) and id(n) compare integers rather than text.  summary()
+  notes where each punctuator and keyword occurs, in one pass over the
+  ids, and keeps that until the SemiExp changes, so the parser and all
+  its rules share one scan of each semi-expression.
+
+  A SemiExp can record() the tokens each get() collects, and the line
+  count after it, in a SemiRecording, see the SemiCache module.  Another
+  SemiExp can replay() that recording, returning the same semi-
+  expressions without reading or tokenizing the file again.  Its toker's
+  lines() is set as each one is returned.  Verbose output isn't replayed.
+
+  A SemiExp can also take its semi-expressions from a SemiPipe, whose
+  producer thread collects them with its own Toker and SemiExp, and
+  hands them over in recorded batches.  A piped SemiExp replays each
+  batch, records the frames it replays, if asked to, and sets its
+  toker's lines(), so rules see what they would see without the pipe.
+
+  SemiExp is final, so calls through a SemiExp, rather than an
+  ITokCollection, need no virtual dispatch, see StaticParser.
+
+  Note that assignment and copying of SemiExp instances is supported.
+  Copies and assignments result in both source and target SemiExp instances
+  sharing the same toker.  The target owns copies of all its tokens.
 
   Public Interface:
   =================
@@ -36,22 +66,65 @@
   if(se.get())                              // collect a semiExpression
     std::cout << se.showSemiExp().c_str();  // show it
   int n = se.length();                      // number of tokens in se
-  std::string tok = se[2] = "a change";     // indexed read and write
+  std::string tok = se[2];                  // indexed read
   if(se.find("aTok") < se.length())         // search for a token
     std::cout << "found aTok";  
+  if(se.find(tok_lparen) < se.length())     // search by TokId, faster
+    std::cout << "found (";
+  if(se.id(0) == tok_class)                 // TokId of first token
+    std::cout << "starts with class";
+  const TokSummary& ts = se.summary();      // positions of punctuators
+  if(ts.first(tok_lparen) < ts.length())    //   and keywords, O(1) lookup
+    std::cout << "found (";
   se.clear();                               // remove all tokens
+  se.record(pRecording);                    // get() records tokens
+  se.replay(pRecording);                    // get() replays them, 0 stops
+  se.pipe(&pipe);                           // get() takes them from pipe
 
   Build Process:
   ==============
   Required files
-    - SemiExpression.h, SemiExpression.cpp, Tokenizer.h, Tokenizer.cpp
+    - SemiExpression.h, SemiExpression.cpp, Tokenizer.h, Tokenizer.cpp,
+      FileMap.h, FileMap.cpp, StrView.h, StrView.cpp, ScanKernel.h,
+      ScanKernel.cpp, TokenPool.h, TokenPool.cpp, ChunkLexer.h,
+      ChunkLexer.cpp, SemiCache.h, SemiCache.cpp, SemiStore.h,
+      SemiStore.cpp, TextArena.h, TextArena.cpp, SemiPipe.h, SemiPipe.cpp,
+      TokSummary.h, TokSummary.cpp
   Build commands (either one)
     - devenv Project1HelpS06.sln
     - cl /EHsc /DTEST_SEMIEXPRESSION SemiExpression.cpp Tokenizer.cpp \
+         FileMap.cpp StrView.cpp ScanKernel.cpp TokenPool.cpp ChunkLexer.cpp \
+         SemiCache.cpp SemiStore.cpp TextArena.cpp SemiPipe.cpp TokSummary.cpp \
          /link setargv.obj
+    - cl /EHsc /O2 /DBENCH_SEMIEXPRESSION SemiExpression.cpp Tokenizer.cpp \
+         FileMap.cpp StrView.cpp ScanKernel.cpp TokenPool.cpp ChunkLexer.cpp \
+         SemiCache.cpp SemiStore.cpp TextArena.cpp SemiPipe.cpp TokSummary.cpp \
+         Timer.cpp
 
   Maintenance History:
   ====================
+  ver 3.0 : 17 Oct 26
+  - constructors initialize members in the order they are declared
+  ver 2.9 : 17 Oct 26
+  - a piped SemiExp holds no batch when the pipe's acquire() throws
+  ver 2.8 : 17 Oct 26
+  - SemiExp is final
+  ver 2.7 : 17 Oct 26
+  - added summary(), rebuilt only after the SemiExp changes
+  ver 2.6 : 17 Oct 26
+  - added pipe(), to take semi-expressions from a SemiPipe
+  ver 2.5 : 17 Oct 26
+  - owned token text is kept in a TextArena, reset by clear(), and
+    trimFront() and remove(0) advance a start index instead of erasing
+  - added BENCH_SEMIEXPRESSION stub, counting allocations per semi-expression
+  ver 2.4 : 17 Oct 26
+  - added record() and replay(), so a second pass over a file can
+    replay the semi-expressions collected by the first
+  ver 2.3 : 16 Oct 26
+  - keeps the TokId of each token, added id(n) and find(TokId)
+  ver 2.2 : 16 Oct 26
+  - tokens are collected with Toker::getTokView() and held as StrViews.
+    Tokens are copied into SemiExp-owned strings only when needed.
   ver 2.1 : 09 Jun 11
   - added support for selecting whether to return newlines (true by default)
   ver 2.0 : 02 Jun 11
@@ -82,20 +155,29 @@
 #include <vector>
 #include "ITokCollection.h"
 #include "tokenizer.h"
+#include "TextArena.h"
+
+class SemiRecording;
+class SemiPipe;
 
-class SemiExp : public ITokCollection
+class SemiExp final : public ITokCollection
 {
 public:
   SemiExp(Toker* pTokr);
+  SemiExp(const SemiExp& se);
+  SemiExp& operator=(const SemiExp& se);
   ~SemiExp();
   bool get(bool clear=true);
   size_t length();
-  std::string& operator[](int n);
-  size_t find(const std::string& tok);
-  void push_back(const std::string& tok);
-  bool remove(const std::string& tok);
+  StrView operator[](int n);
+  TokId id(int n);
+  size_t find(const StrView& tok);
+  size_t find(TokId id);
+  const TokSummary& summary();
+  void push_back(const StrView& tok);
+  bool remove(const StrView& tok);
   bool remove(size_t i);
-  bool merge(const std::string& firstTok, const std::string& secondTok);
+  bool merge(const StrView& firstTok, const StrView& secondTok);
   void toLower();
   void trimFront();
   void clear();
@@ -103,18 +185,32 @@ public:
   void verbose(bool v = true);
   void makeCommentSemiExp(bool commentIsSE = true);
   void returnNewLines(bool doReturnNewLines = true);
-  bool isComment(const std::string& tok);
+  bool isComment(const StrView& tok);
+  void record(SemiRecording* pRec);
+  void replay(SemiRecording* pRec);
+  void pipe(SemiPipe* pPipe);
 
 private:
   Toker* pToker;
-  std::vector<std::string> toks;
-  bool isTerminator(std::string tok);
+  SemiRecording* pRecording;      // get() appends to this, if not null
+  SemiRecording* pReplay;         // get() replays this, if not null
+  size_t replayFrame;             // next frame of pReplay
+  SemiPipe* pPipe;                // get() replays batches from this, if not null
+  bool replayGet(bool clear);
+  std::vector<StrView> toks;
+  std::vector<TokId> ids;         // ids[i] is TokId of toks[i]
+  size_t start;                   // tokens before start were removed
+  TextArena owned;                // text of tokens not viewed in source
+  TokSummary summ;
+  bool summarized;                // summ is up to date
+  StrView own(const StrView& tok);
+  bool isTerminator(const StrView& tok, TokId id);
   bool Verbose;
   bool commentIsSemiExp;
   bool doReturnNewLines;
 };
 
-inline size_t SemiExp::length() { return toks.size(); }
+inline size_t SemiExp::length() { return toks.size() - start; }
 
 inline void SemiExp::verbose(bool v) { Verbose = v; }
 
@@ -125,11 +221,36 @@ inline void SemiExp::makeCommentSemiExp(bool commentIsSE)
 
 inline void SemiExp::returnNewLines(bool doReturn) { doReturnNewLines = doReturn; }
 
-inline void SemiExp::clear() { toks.clear(); }
+inline void SemiExp::record(SemiRecording* pRec) { pRecording = pRec; }
+
+inline void SemiExp::replay(SemiRecording* pRec)
+{
+  pReplay = pRec;
+  replayFrame = 0;
+  pPipe = 0;
+}
+
+inline void SemiExp::pipe(SemiPipe* pPipe_)
+{
+  pReplay = 0;
+  replayFrame = 0;
+  pPipe = pPipe_;
+}
+
+inline void SemiExp::clear()
+{
+  summarized = false;
+  toks.clear();
+  ids.clear();
+  start = 0;
+  owned.reset();
+}
 
-inline void SemiExp::push_back(const std::string& tok)
+inline void SemiExp::push_back(const StrView& tok)
 {
-  toks.push_back(tok);
+  summarized = false;
+  toks.push_back(own(tok));
+  ids.push_back(internTok(tok));
 }
 
 #endif
@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////
+// SemiPipe.cpp - semi-expressions from a producer thread    //
+// Ver 1.1                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include "SemiPipe.h"
+#include "SemiCache.h"
+#include "SemiExpression.h"
+#include "Tokenizer.h"
+
+//----< pipe from producer's toker and SemiExp >---------------------
+
+SemiPipe::SemiPipe(Toker* pToker_, SemiExp* pSemi_, size_t numSlots, size_t batchSize_)
+	: pToker(pToker_), pSemi(pSemi_), batchSize(batchSize_ > 0 ? batchSize_ : 1),
+	  head(0), tail(0), done(true), stopping(false), running(false),
+	  files(0), batches(0), run(0), prodTime(0), prodBlocked(0), consWaiting(0)
+{
+	if(numSlots < 2)
+		numSlots = 2;
+	for(size_t i=0; i<numSlots; ++i)
+		slots.push_back(new SemiRecording);
+}
+//----< destructor stops producer and frees slots >------------------
+
+SemiPipe::~SemiPipe()
+{
+	stop();
+	for(size_t i=0; i<slots.size(); ++i)
+		delete slots[i];
+}
+//----< attach producer's toker to file and start producer >---------
+
+bool SemiPipe::start(const std::string& fileName)
+{
+	stop();
+	if(!pToker->attach(fileName))
+		return false;
+	head.store(0);
+	tail.store(0);
+	error = nullptr;
+	done.store(false);
+	stopping.store(false);
+	runTimer.restart();
+	producer = std::thread(&SemiPipe::produce, this);
+	running = true;
+	++files;
+	return true;
+}
+//----< ask producer to quit, if consumer didn't finish file >-------
+
+void SemiPipe::stop()
+{
+	if(!running)
+		return;
+	stopping.store(true);
+	join();
+}
+//----< wait for producer, then count time the file took >-----------
+
+void SemiPipe::join()
+{
+	producer.join();
+	run += runTimer.elapsed();
+	running = false;
+}
+//----< producer: fill slots with batches of semi-expressions >------
+/*
+ *  The last batch holds the noMoreTokens frame that get() records
+ *  when it runs out of tokens.  If get() throws, the batch holds the
+ *  semi-expressions before the throw, and the exception is kept for
+ *  acquire() to rethrow on the parser's thread once it has taken them,
+ *  where the parser would have met it without the pipe.
+ */
+void SemiPipe::produce()
+{
+	Timer timer;
+	bool more = true;
+	while(more && !stopping.load(std::memory_order_relaxed))
+	{
+		size_t t = tail.load(std::memory_order_relaxed);
+		if(t - head.load(std::memory_order_acquire) == slots.size())
+		{
+			// ring is full, parser is behind
+			Timer wait;
+			while(t - head.load(std::memory_order_acquire) == slots.size() &&
+				!stopping.load(std::memory_order_relaxed))
+				std::this_thread::yield();
+			prodBlocked += wait.elapsed();
+			continue;
+		}
+		SemiRecording* pBatch = slots[t % slots.size()];
+		try
+		{
+			pBatch->clear();
+			pSemi->record(pBatch);
+			for(size_t n=0; more && n<batchSize; ++n)
+				more = pSemi->get();
+		}
+		catch(...)
+		{
+			error = std::current_exception();
+			more = false;
+		}
+		pSemi->record(0);
+		++batches;
+		tail.store(t + 1, std::memory_order_release);
+	}
+	prodTime += timer.elapsed();
+	done.store(true, std::memory_order_release);
+}
+//----< consumer: next filled batch, or 0 if there are no more >-----
+/*
+ *  Waits while the ring is empty.  Call release() when done with the
+ *  batch, before calling acquire() again.  Once the batches run out,
+ *  rethrows what the producer's get() threw, if anything.
+ */
+SemiRecording* SemiPipe::acquire()
+{
+	size_t h = head.load(std::memory_order_relaxed);
+	if(h == tail.load(std::memory_order_acquire))
+	{
+		// ring is empty, lexing is behind, or finished
+		Timer wait;
+		while(h == tail.load(std::memory_order_acquire))
+		{
+			if(done.load(std::memory_order_acquire) && h == tail.load(std::memory_order_acquire))
+			{
+				consWaiting += wait.elapsed();
+				if(error)
+				{
+					std::exception_ptr thrown = error;
+					error = nullptr;
+					finish();
+					std::rethrow_exception(thrown);
+				}
+				return 0;
+			}
+			std::this_thread::yield();
+		}
+		consWaiting += wait.elapsed();
+	}
+	return slots[h % slots.size()];
+}
+//----< consumer: hand batch from acquire() back to producer >-------
+
+void SemiPipe::release()
+{
+	head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+//----< consumer: took the last batch, producer has finished >-------
+
+void SemiPipe::finish()
+{
+	if(running)
+		join();
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_SEMIPIPE
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Testing SemiPipe class\n "
+		<< std::string(24,'=') << std::endl;
+	if(argc < 2)
+	{
+		std::cout << "\n  please enter names of files to process on command line\n\n";
+		return 1;
+	}
+
+	// tiny ring and batches, so both sides wait, and the default ones
+
+	const size_t sizes[][2] = { { 2, 1 }, { 8, 64 } };
+	for(size_t s=0; s<2; ++s)
+	{
+		Toker producerToker;
+		SemiExp producerSemi(&producerToker);
+		SemiPipe pipe(&producerToker, &producerSemi, sizes[s][0], sizes[s][1]);
+		std::cout << "\n  " << sizes[s][0] << " slots of " << sizes[s][1] << " semi-expressions";
+		for(int i=1; i<argc; ++i)
+		{
+			Toker toker, consumerToker;
+			SemiExp serial(&toker), piped(&consumerToker);
+			if(!toker.attach(argv[i]) || !pipe.start(argv[i]))
+			{
+				std::cout << "\n    can't open " << argv[i];
+				continue;
+			}
+			piped.pipe(&pipe);
+			size_t n = 0;
+			bool same = true;
+			while(same)
+			{
+				bool more = serial.get();
+				same = more == piped.get() && serial.show(true) == piped.show(true) &&
+					toker.lines() == consumerToker.lines();
+				if(!more)
+					break;
+				++n;
+			}
+			std::cout << "\n    " << argv[i] << ": " << (same ? "matches" : "differs from")
+				<< " serial SemiExp after " << n << " semi-expressions";
+		}
+		std::cout << "\n    " << pipe.numBatches() << " batches, producer blocked "
+			<< pipe.producerBlocked() << " sec, consumer waited "
+			<< pipe.consumerWaiting() << " sec of " << pipe.runTime() << " sec";
+	}
+	std::cout << "\n\n";
+}
+
+#endif
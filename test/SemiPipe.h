@@ -0,0 +1,150 @@
+#ifndef SEMIPIPE_H
+#define SEMIPIPE_H
+///////////////////////////////////////////////////////////////
+// SemiPipe.h - semi-expressions from a producer thread      //
+// Ver 1.1                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+Without a pipe, Parser::next() calls SemiExp::get(), which reads and
+tokenizes the file, so reading, lexing and rule evaluation all take
+turns on one thread.  A SemiPipe moves reading and lexing to a
+producer thread, with its own Toker and SemiExp, while the parser's
+SemiExp takes the finished semi-expressions, see SemiExp::pipe().
+
+Semi-expressions are handed over in batches.  Each batch is a
+SemiRecording of up to batchSize get() calls, the same form pass 2
+replays, so the parser sees exactly the tokens and line counts it
+would have seen without the pipe.  Batches live in a ring of numSlots
+slots, shared by one producer and one consumer without locks: the
+producer only writes tail, the consumer only writes head.  When all
+slots are full the producer waits, so numSlots * batchSize bounds how
+far lexing can run ahead of parsing.  Slots are reused, so a running
+pipe doesn't allocate.
+
+An exception thrown while lexing, e.g., std::bad_alloc, doesn't end
+the producer thread, and the program with it.  The producer keeps it
+and stops, and acquire() rethrows it on the parser's thread, after
+the semi-expressions lexed before it, so the parser's caller catches
+and reports it as it would without the pipe.
+
+The pipe times both sides.  Over all files it has run, it reports
+how long the producer waited for a free slot, i.e., the parser was
+the bottleneck, and how long the consumer waited for a full one,
+i.e., lexing was the bottleneck.
+
+Public Interface:
+=================
+Toker toker;                                // producer's toker
+SemiExp producer(&toker);                   // and SemiExp, configured
+SemiPipe pipe(&toker, &producer, 8, 64);    // 8 slots of 64 semi-exps
+SemiExp se(&consumerToker);                 // parser's SemiExp
+if(pipe.start(fileName))                    // false if can't open file
+{
+  se.pipe(&pipe);                           // get() takes from pipe
+  while(se.get())
+    parse(se);
+}
+double busy = pipe.producerBusy() / pipe.runTime();
+double wait = pipe.consumerWaiting() / pipe.runTime();
+
+Build Process:
+==============
+Required files
+- SemiPipe.h, SemiPipe.cpp, SemiCache.h, SemiCache.cpp,
+SemiExpression.h, SemiExpression.cpp, Tokenizer.h, Tokenizer.cpp,
+Timer.h, and the files they require
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /O2 /DTEST_SEMIPIPE SemiPipe.cpp SemiCache.cpp SemiStore.cpp \
+SemiExpression.cpp Tokenizer.cpp FileMap.cpp StrView.cpp ScanKernel.cpp \
+TokenPool.cpp ChunkLexer.cpp TextArena.cpp TokSummary.cpp /link setargv.obj
+
+Maintenance History:
+====================
+ver 1.1 : 17 Oct 26
+- exceptions thrown on the producer thread are rethrown by acquire()
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <exception>
+#include "Timer.h"
+
+class Toker;
+class SemiExp;
+class SemiRecording;
+
+class SemiPipe
+{
+public:
+	SemiPipe(Toker* pToker, SemiExp* pSemi, size_t numSlots = 8, size_t batchSize = 64);
+	~SemiPipe();
+	bool start(const std::string& fileName);
+	void stop();
+
+	// consumer
+	SemiRecording* acquire();
+	void release();
+	void finish();
+
+	// statistics, over all files, in seconds
+	size_t numFiles() const;
+	size_t numBatches() const;
+	double runTime() const;
+	double producerBusy() const;
+	double producerBlocked() const;
+	double consumerWaiting() const;
+
+private:
+	void produce();
+	void join();
+
+	Toker* pToker;
+	SemiExp* pSemi;
+	std::vector<SemiRecording*> slots;
+	size_t batchSize;
+	std::atomic<size_t> head;      // next slot to consume, written by consumer
+	std::atomic<size_t> tail;      // next slot to fill, written by producer
+	std::atomic<bool> done;        // producer has filled its last slot
+	std::atomic<bool> stopping;    // consumer asks producer to quit
+	std::exception_ptr error;      // thrown by producer, set before done
+	std::thread producer;
+	bool running;
+	Timer runTimer;
+
+	size_t files;
+	size_t batches;                // written by producer
+	double run;
+	double prodTime;               // written by producer
+	double prodBlocked;            // written by producer
+	double consWaiting;
+
+	// prohibit copying and assignment
+	SemiPipe(const SemiPipe&);
+	SemiPipe& operator=(const SemiPipe&);
+};
+
+inline size_t SemiPipe::numFiles() const { return files; }
+
+inline size_t SemiPipe::numBatches() const { return batches; }
+
+inline double SemiPipe::runTime() const { return run; }
+
+inline double SemiPipe::producerBusy() const { return prodTime - prodBlocked; }
+
+inline double SemiPipe::producerBlocked() const { return prodBlocked; }
+
+inline double SemiPipe::consumerWaiting() const { return consWaiting; }
+
+#endif
@@ -0,0 +1,460 @@
+///////////////////////////////////////////////////////////////
+// SemiStore.cpp - semi-expression recordings kept on disk   //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "SemiStore.h"
+#include "FileMap.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// entry files start with this, then a version, bumped if layout changes
+static const char entryMagic[4] = { 'S', 'E', 'M', 'I' };
+static const unsigned entryVersion = 1;
+
+//----< write 32 and 64 bit values, in the machine's byte order >----
+
+static bool put32(FILE* pFile, unsigned value)
+{
+	return fwrite(&value, sizeof(value), 1, pFile) == 1;
+}
+
+static bool put64(FILE* pFile, unsigned long long value)
+{
+	return fwrite(&value, sizeof(value), 1, pFile) == 1;
+}
+//----< read values written by put32 and put64 >---------------------
+
+static bool get32(FILE* pFile, unsigned& value)
+{
+	return fread(&value, sizeof(value), 1, pFile) == 1;
+}
+
+static bool get64(FILE* pFile, unsigned long long& value)
+{
+	return fread(&value, sizeof(value), 1, pFile) == 1;
+}
+//----< write a recording, with the text of each distinct token >----
+/*
+ *  Layout: magic, version, file size, content hash, path, token
+ *  texts, frames, then each frame's tokens as indices of its text.
+ */
+static bool writeEntry(FILE* pFile, const std::string& fileName,
+	unsigned long long size, unsigned long long hash, const SemiRecording& rec)
+{
+	std::map<TokId, unsigned> local;
+	std::vector<TokId> texts;
+	std::vector<unsigned> toks;
+	for(size_t f=0; f<rec.numFrames(); ++f)
+	{
+		const TokId* pIds = rec.tokens(f);
+		for(size_t i=0; i<rec.frame(f).numToks; ++i)
+		{
+			std::map<TokId, unsigned>::iterator it = local.find(pIds[i]);
+			if(it == local.end())
+			{
+				it = local.insert(std::make_pair(pIds[i], (unsigned)texts.size())).first;
+				texts.push_back(pIds[i]);
+			}
+			toks.push_back(it->second);
+		}
+	}
+	bool ok = fwrite(entryMagic, sizeof(entryMagic), 1, pFile) == 1 &&
+		put32(pFile, entryVersion) && put64(pFile, size) && put64(pFile, hash) &&
+		put32(pFile, (unsigned)fileName.size()) &&
+		fwrite(fileName.data(), 1, fileName.size(), pFile) == fileName.size() &&
+		put32(pFile, (unsigned)texts.size());
+	for(size_t i=0; ok && i<texts.size(); ++i)
+	{
+		StrView text = TokenPool::instance().text(texts[i]);
+		ok = put32(pFile, (unsigned)text.size()) &&
+			fwrite(text.data(), 1, text.size(), pFile) == text.size();
+	}
+	ok = ok && put32(pFile, (unsigned)rec.numFrames());
+	for(size_t f=0; ok && f<rec.numFrames(); ++f)
+	{
+		const SemiRecording::Frame& frame = rec.frame(f);
+		ok = put32(pFile, frame.numToks) && put32(pFile, (unsigned)frame.lines) &&
+			put32(pFile, (unsigned)frame.ending);
+	}
+	if(ok && toks.size() > 0)
+		ok = fwrite(&toks[0], sizeof(unsigned), toks.size(), pFile) == toks.size();
+	return ok;
+}
+//----< read a recording written by writeEntry, 0 if it won't do >---
+/*
+ *  Counts are checked against the entry's size, so a damaged entry
+ *  is a miss instead of a huge allocation.
+ */
+static SemiRecording* readEntry(FILE* pFile, size_t entryBytes,
+	const std::string& fileName, unsigned long long size, unsigned long long hash)
+{
+	char magic[sizeof(entryMagic)];
+	unsigned version, pathLen, numTexts, numFrames;
+	unsigned long long entrySize, entryHash;
+	if(fread(magic, sizeof(magic), 1, pFile) != 1 || memcmp(magic, entryMagic, sizeof(magic)) ||
+		!get32(pFile, version) || version != entryVersion ||
+		!get64(pFile, entrySize) || entrySize != size ||
+		!get64(pFile, entryHash) || entryHash != hash ||
+		!get32(pFile, pathLen) || pathLen != fileName.size())
+		return 0;
+	std::string path(pathLen, ' ');
+	if(pathLen > 0 && fread(&path[0], 1, pathLen, pFile) != pathLen)
+		return 0;
+	if(path != fileName || !get32(pFile, numTexts) || numTexts > entryBytes)
+		return 0;
+
+	std::vector<TokId> ids(numTexts);
+	std::string text;
+	for(unsigned i=0; i<numTexts; ++i)
+	{
+		unsigned len;
+		if(!get32(pFile, len) || len > entryBytes)
+			return 0;
+		text.resize(len);
+		if(len > 0 && fread(&text[0], 1, len, pFile) != len)
+			return 0;
+		ids[i] = internTok(text);
+	}
+	if(!get32(pFile, numFrames) || numFrames > entryBytes)
+		return 0;
+	std::vector<unsigned> frames(3 * (size_t)numFrames);
+	if(numFrames > 0 && fread(&frames[0], sizeof(unsigned), frames.size(), pFile) != frames.size())
+		return 0;
+
+	SemiRecording* pRec = new SemiRecording;
+	std::vector<unsigned> toks;
+	std::vector<TokId> frameIds;
+	for(size_t f=0; f<numFrames; ++f)
+	{
+		unsigned numToks = frames[3*f];
+		unsigned ending = frames[3*f + 2];
+		bool ok = numToks <= entryBytes && ending <= SemiRecording::atTerminator;
+		if(ok)
+		{
+			toks.resize(numToks);
+			frameIds.resize(numToks);
+			ok = numToks == 0 || fread(&toks[0], sizeof(unsigned), numToks, pFile) == numToks;
+		}
+		for(unsigned i=0; ok && i<numToks; ++i)
+		{
+			ok = toks[i] < numTexts;
+			if(ok)
+				frameIds[i] = ids[toks[i]];
+		}
+		if(!ok)
+		{
+			delete pRec;
+			return 0;
+		}
+		pRec->add(numToks == 0 ? 0 : &frameIds[0], numToks, (int)frames[3*f + 1],
+			(SemiRecording::Ending)ending);
+	}
+	if(!pRec->isComplete())
+	{
+		delete pRec;
+		return 0;
+	}
+	return pRec;
+}
+
+//----< open, making it if need be, a cache directory >--------------
+
+SemiStore::SemiStore(const std::string& dir_, size_t maxBytesOnDisk)
+	: dir(dir_), maxBytes(maxBytesOnDisk), diskBytes(0), useCount(0),
+	  nHits(0), nMisses(0), nEvicted(0), open(false)
+{
+#ifdef _WIN32
+	_mkdir(dir.c_str());
+#else
+	mkdir(dir.c_str(), 0777);
+#endif
+	// usable only if we can write there
+	FILE* pIndex = fopen(indexFile().c_str(), "ab");
+	if(pIndex == 0)
+		return;
+	fclose(pIndex);
+	open = true;
+	readIndex();
+	evict();
+}
+//----< destructor saves index, for the next run >-------------------
+
+SemiStore::~SemiStore()
+{
+	if(open)
+		writeIndex();
+}
+//----< path of a key's entry, and of the index >--------------------
+
+std::string SemiStore::entryFile(const std::string& key) const
+{
+	return dir + "/" + key + ".semi";
+}
+
+std::string SemiStore::indexFile() const
+{
+	return dir + "/index.txt";
+}
+//----< hash of file's bytes, FNV-1a, taken eight bytes at a time >--
+
+unsigned long long SemiStore::contentHash(const char* pData, size_t len)
+{
+	const unsigned long long prime = 1099511628211ULL;
+	unsigned long long hash = 14695981039346656037ULL;
+	size_t i = 0;
+	for(; i + 8 <= len; i += 8)
+	{
+		unsigned long long word;
+		memcpy(&word, pData + i, sizeof(word));
+		hash = (hash ^ word) * prime;
+	}
+	for(; i < len; ++i)
+		hash = (hash ^ (unsigned char)pData[i]) * prime;
+	return hash;
+}
+//----< entry name of a file: hash of its path, in hex >-------------
+
+std::string SemiStore::keyOf(const std::string& fileName)
+{
+	char key[17];
+	sprintf(key, "%016llx", contentHash(fileName.data(), fileName.size()));
+	return key;
+}
+//----< size and content hash of a file, false if can't read it >---
+
+bool SemiStore::hashFile(const std::string& fileName,
+	unsigned long long& size, unsigned long long& hash)
+{
+	FileMap file;
+	if(!file.open(fileName))
+		return false;
+	size = file.size();
+	hash = contentHash(file.begin(), file.size());
+	return true;
+}
+//----< recording of an unchanged file, or 0 >-----------------------
+/*
+ *  The caller owns the returned recording.
+ */
+SemiRecording* SemiStore::load(const std::string& fileName)
+{
+	unsigned long long size, hash;
+	if(!open || !hashFile(fileName, size, hash))
+	{
+		++nMisses;
+		return 0;
+	}
+	seen[fileName] = std::make_pair(size, hash);
+	std::string key = keyOf(fileName);
+	std::map<std::string, Entry>::iterator it = entries.find(key);
+	SemiRecording* pRec = 0;
+	if(it != entries.end())
+	{
+		FILE* pFile = fopen(entryFile(key).c_str(), "rb");
+		if(pFile)
+		{
+			pRec = readEntry(pFile, it->second.bytes, fileName, size, hash);
+			fclose(pFile);
+		}
+	}
+	if(pRec == 0)
+	{
+		++nMisses;
+		return 0;
+	}
+	it->second.lastUse = ++useCount;
+	++nHits;
+	return pRec;
+}
+//----< write a complete, unspilled recording of a file >------------
+/*
+ *  The file is hashed again unless load() already looked for it.
+ */
+bool SemiStore::save(const std::string& fileName, const SemiRecording& rec)
+{
+	if(!open || !rec.isComplete() || rec.isSpilled())
+		return false;
+	unsigned long long size, hash;
+	std::map<std::string, std::pair<unsigned long long, unsigned long long> >::iterator
+		it = seen.find(fileName);
+	if(it != seen.end())
+	{
+		size = it->second.first;
+		hash = it->second.second;
+		seen.erase(it);
+	}
+	else if(!hashFile(fileName, size, hash))
+		return false;
+
+	std::string key = keyOf(fileName);
+	remove(key);
+	std::string path = entryFile(key);
+	FILE* pFile = fopen(path.c_str(), "wb");
+	if(pFile == 0)
+		return false;
+	bool ok = writeEntry(pFile, fileName, size, hash, rec);
+	long bytes = ftell(pFile);
+	ok = fclose(pFile) == 0 && ok && bytes > 0;
+	if(!ok)
+	{
+		std::remove(path.c_str());
+		return false;
+	}
+	Entry entry;
+	entry.bytes = (size_t)bytes;
+	entry.lastUse = ++useCount;
+	entries[key] = entry;
+	diskBytes += entry.bytes;
+	evict();
+	return true;
+}
+//----< delete an entry, if there is one >---------------------------
+
+void SemiStore::remove(const std::string& key)
+{
+	std::map<std::string, Entry>::iterator it = entries.find(key);
+	if(it == entries.end())
+		return;
+	std::remove(entryFile(key).c_str());
+	diskBytes -= it->second.bytes;
+	entries.erase(it);
+}
+//----< delete least recently used entries until under the cap >-----
+
+void SemiStore::evict()
+{
+	while(diskBytes > maxBytes && entries.size() > 0)
+	{
+		std::map<std::string, Entry>::iterator it, oldest = entries.begin();
+		for(it = entries.begin(); it != entries.end(); ++it)
+			if(it->second.lastUse < oldest->second.lastUse)
+				oldest = it;
+		remove(oldest->first);
+		++nEvicted;
+	}
+}
+//----< read index: one "key bytes lastUse" line per entry >---------
+
+void SemiStore::readIndex()
+{
+	std::ifstream in(indexFile().c_str());
+	std::string line;
+	while(std::getline(in, line))
+	{
+		std::istringstream fields(line);
+		std::string key;
+		Entry entry;
+		if(!(fields >> key >> entry.bytes >> entry.lastUse))
+			continue;
+		entries[key] = entry;
+		diskBytes += entry.bytes;
+		if(entry.lastUse > useCount)
+			useCount = entry.lastUse;
+	}
+}
+//----< write index, replacing the last one >------------------------
+
+void SemiStore::writeIndex()
+{
+	std::ofstream out(indexFile().c_str());
+	std::map<std::string, Entry>::iterator it;
+	for(it = entries.begin(); it != entries.end(); ++it)
+		out << it->first << " " << it->second.bytes << " " << it->second.lastUse << "\n";
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_SEMISTORE
+
+#include <iostream>
+
+//----< record a stream that looks like the file's tokens >----------
+
+SemiRecording* makeRecording(const char* name)
+{
+	SemiRecording* pRec = new SemiRecording;
+	TokId frame[] = { tok_class, internTok(name), tok_lbrace };
+	for(int i=0; i<5; ++i)
+		pRec->add(frame, 3, i + 1, SemiRecording::atTerminator);
+	pRec->add(frame, 0, 6, SemiRecording::noMoreTokens);
+	return pRec;
+}
+
+int main()
+{
+	std::cout << "\n  Testing SemiStore class\n "
+		<< std::string(25,'=') << std::endl;
+
+	const char* files[] = { "SemiStoreTest1.cpp", "SemiStoreTest2.cpp" };
+	const char* names[] = { "Widget", "Gadget" };
+	for(int f=0; f<2; ++f)
+		std::ofstream(files[f]) << "class " << names[f] << " { };\n";
+
+	// first run: misses, then saves
+
+	{
+		SemiStore store("SemiStoreTest", 1 << 20);
+		for(int f=0; f<2; ++f)
+		{
+			SemiRecording* pRec = store.load(files[f]);
+			if(pRec == 0)
+			{
+				pRec = makeRecording(names[f]);
+				store.save(files[f], *pRec);
+			}
+			delete pRec;
+		}
+		std::cout << "\n  first run:  " << store.hits() << " hits, " << store.misses()
+			<< " misses, " << store.bytesOnDisk() << " bytes on disk";
+	}
+
+	// second run: hits for the unchanged file, a miss for the edited one
+
+	std::ofstream(files[1], std::ios::app) << "// edited\n";
+	{
+		SemiStore store("SemiStoreTest", 1 << 20);
+		for(int f=0; f<2; ++f)
+		{
+			SemiRecording* pRec = store.load(files[f]);
+			if(pRec)
+			{
+				std::cout << "\n  " << files[f] << ": " << pRec->numFrames() << " frames, first is";
+				const TokId* ids = pRec->tokens(0);
+				for(size_t i=0; i<pRec->frame(0).numToks; ++i)
+					std::cout << " " << TokenPool::instance().text(ids[i]);
+			}
+			else
+				std::cout << "\n  " << files[f] << ": changed, not loaded";
+			delete pRec;
+		}
+		std::cout << "\n  second run: " << store.hits() << " hits, " << store.misses() << " misses";
+	}
+
+	// shrinking the cap evicts entries, least recently used first
+
+	{
+		SemiStore store("SemiStoreTest", 1);
+		std::cout << "\n  tiny store: " << store.evictions() << " evicted, "
+			<< store.bytesOnDisk() << " bytes on disk";
+	}
+	for(int f=0; f<2; ++f)
+		std::remove(files[f]);
+	std::cout << "\n\n";
+}
+
+#endif
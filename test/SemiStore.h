@@ -0,0 +1,131 @@
+#ifndef SEMISTORE_H
+#define SEMISTORE_H
+///////////////////////////////////////////////////////////////
+// SemiStore.h - semi-expression recordings kept on disk     //
+// Ver 1.1                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+A SemiCache lets pass 2 replay pass 1's semi-expressions, but every
+run still tokenizes every file once.  Most files don't change from
+one run to the next, so this module keeps each file's SemiRecording
+in a cache directory, where the next run can find it.
+
+Each entry is keyed by the file's path, and is only used if the
+file still has the same size and content hash as when the entry was
+written.  The hash is a 64 bit FNV-1a hash of the file's bytes, taken
+eight at a time from a FileMap, which costs far less than tokenizing
+them again.  TokIds are only valid in the process that interned them,
+so entries hold the text of each distinct token, and load() interns
+that text again.
+
+The store holds at most maxBytesOnDisk of entries.  It remembers
+when each entry was last written or loaded, in an index file in the
+cache directory, and when it grows past its cap it removes the
+least recently used entries first.
+
+Public Interface:
+=================
+SemiStore store("C:\\temp\\semicache", 256 << 20); // at most 256 MB
+SemiRecording* pRec = store.load(fileName);    // new recording, 0 on miss
+if(pRec == 0)
+  store.save(fileName, *pComplete);            // after tokenizing file
+size_t h = store.hits(), m = store.misses();   // lookup counters
+size_t e = store.evictions();                  // entries removed for space
+
+Build Process:
+==============
+Required files
+- SemiStore.h, SemiStore.cpp, SemiCache.h, SemiCache.cpp,
+FileMap.h, FileMap.cpp, TokenPool.h, TokenPool.cpp,
+StrView.h, StrView.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_SEMISTORE SemiStore.cpp SemiCache.cpp FileMap.cpp \
+TokenPool.cpp StrView.cpp
+
+Maintenance History:
+====================
+ver 1.1 : 17 Oct 26
+- added directory(), where a SemiCache using the store spills
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include <string>
+#include <map>
+#include "SemiCache.h"
+
+///////////////////////////////////////////////////////////////
+// SemiStore: recordings of files, in a cache directory
+
+class SemiStore
+{
+public:
+	SemiStore(const std::string& dir, size_t maxBytesOnDisk = 256 << 20);
+	~SemiStore();
+	bool isOpen() const;
+	const std::string& directory() const;
+	SemiRecording* load(const std::string& fileName);
+	bool save(const std::string& fileName, const SemiRecording& rec);
+	size_t hits() const;
+	size_t misses() const;
+	size_t evictions() const;
+	size_t bytesOnDisk() const;
+	static unsigned long long contentHash(const char* pData, size_t len);
+
+private:
+	// index entry of one cached file
+	struct Entry
+	{
+		size_t bytes;                  // size of entry file
+		unsigned long long lastUse;    // larger is more recent
+	};
+
+	static std::string keyOf(const std::string& fileName);
+	std::string entryFile(const std::string& key) const;
+	std::string indexFile() const;
+	static bool hashFile(const std::string& fileName, unsigned long long& size,
+		unsigned long long& hash);
+	void readIndex();
+	void writeIndex();
+	void remove(const std::string& key);
+	void evict();
+
+	std::string dir;
+	size_t maxBytes;
+	size_t diskBytes;
+	unsigned long long useCount;
+	std::map<std::string, Entry> entries;
+
+	// size and hash of each file when load() looked for it, used by save()
+	std::map<std::string, std::pair<unsigned long long, unsigned long long> > seen;
+	size_t nHits;
+	size_t nMisses;
+	size_t nEvicted;
+	bool open;
+
+	// prohibit copying and assignment
+	SemiStore(const SemiStore&);
+	SemiStore& operator=(const SemiStore&);
+};
+
+inline bool SemiStore::isOpen() const { return open; }
+
+inline const std::string& SemiStore::directory() const { return dir; }
+
+inline size_t SemiStore::hits() const { return nHits; }
+
+inline size_t SemiStore::misses() const { return nMisses; }
+
+inline size_t SemiStore::evictions() const { return nEvicted; }
+
+inline size_t SemiStore::bytesOnDisk() const { return diskBytes; }
+
+#endif
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////
+// StaticParser.cpp - parser with a compile time rule list   //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include "StaticParser.h"
+
+//----< benchmark stub >---------------------------------------------
+/*
+ *  Runs both passes over the files named on the command line, once
+ *  with the builders' Parsers and once with their StaticParsers,
+ *  and checks that both build the same graph.  Console output of
+ *  the actions is discarded while timing.
+ */
+#ifdef BENCH_STATICPARSER
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include "ConfigureParser.h"
+#include "ConfigureParserRelat.h"
+#include "GraphSingleton.h"
+#include "Timer.h"
+
+//----< parse all files, returning seconds taken >-------------------
+
+template<class Config, class P>
+double parseFiles(Config& configure, P* pParser, std::vector<std::string>& files)
+{
+	Timer timer;
+	for(size_t i=0; i<files.size(); ++i)
+	{
+		try
+		{
+			if(!configure.Attach(files[i]))
+				continue;
+			GraphSingleton::getInstance()->setCurrentFilename(files[i]);
+			while(pParser->next())
+				pParser->parse();
+		}
+		catch(std::exception&) {}
+	}
+	return timer.elapsed();
+}
+//----< graph's edges by vertex value, independent of vertex ids >---
+
+std::string edgeList()
+{
+	graph& g = GraphSingleton::getInstance()->getGraph();
+	std::vector<std::string> edges;
+	for(graph::iterator iter = g.begin(); iter != g.end(); ++iter)
+	{
+		vertex& v = *iter;
+		edges.push_back(v.value().payload);
+		for(size_t i=0; i<v.size(); ++i)
+			edges.push_back(v.value().payload + " " + v[i].second.name() + " " + g[v[i].first].value().payload);
+	}
+	std::sort(edges.begin(), edges.end());
+	std::string list;
+	for(size_t i=0; i<edges.size(); ++i)
+		list += edges[i] + "\n";
+	return list;
+}
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Benchmarking StaticParser against Parser\n "
+		<< std::string(42,'=') << std::endl;
+	if(argc < 2)
+	{
+		std::cout << "\n  please enter names of files to process on command line\n\n";
+		return 1;
+	}
+	std::vector<std::string> files(argv + 1, argv + argc);
+	const int numRuns = 3;
+	const char* names[] = { "Parser", "StaticParser" };
+	double best[2][2] = { { 1e9, 1e9 }, { 1e9, 1e9 } };
+	std::string graphs[2];
+	std::ostringstream sink;
+	std::streambuf* pCout = std::cout.rdbuf();
+
+	for(int run=0; run<numRuns; ++run)
+	{
+		for(int s=0; s<2; ++s)
+		{
+			GraphSingleton::getInstance()->clear();
+			std::cout.rdbuf(sink.rdbuf());
+			double t[2];
+			if(s == 0)
+			{
+				ConfigParseToConsole pass1;
+				t[0] = parseFiles(pass1, pass1.Build(), files);
+				ConfigParseToConsoleRelat pass2;
+				t[1] = parseFiles(pass2, pass2.Build(), files);
+			}
+			else
+			{
+				ConfigParseToConsole pass1;
+				t[0] = parseFiles(pass1, pass1.BuildStatic(), files);
+				ConfigParseToConsoleRelat pass2;
+				t[1] = parseFiles(pass2, pass2.BuildStatic(), files);
+			}
+			std::cout.rdbuf(pCout);
+			sink.str("");
+			for(int pass=0; pass<2; ++pass)
+				best[s][pass] = std::min(best[s][pass], t[pass]);
+			graphs[s] = edgeList();
+		}
+	}
+	for(int s=0; s<2; ++s)
+		std::cout << "\n  " << names[s] << ": pass 1 " << best[s][0] << " sec, pass 2 "
+			<< best[s][1] << " sec, best of " << numRuns;
+	std::cout << "\n  graphs are " << (graphs[0] == graphs[1] ? "identical" : "DIFFERENT")
+		<< "\n\n";
+}
+
+#endif
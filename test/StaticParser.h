@@ -0,0 +1,173 @@
+#ifndef STATICPARSER_H
+#define STATICPARSER_H
+///////////////////////////////////////////////////////////////
+// StaticParser.h - parser with a compile time rule list     //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+This module defines a StaticParser class template.  Like Parser, it
+collects semi-expressions and applies rules to each, and rules that
+match invoke their actions.  Parser holds rules and actions as
+IRule* and IAction* and calls them, and the collection, through
+virtual functions.  A StaticParser's rules and actions are part of
+its type, and it calls them with its concrete collection type, e.g.,
+SemiExp, so the compiler can inline each rule test and action into
+the parse loop.
+
+The rules are a list of StaticRule<Rule, Action> types, built from
+RuleList<Head, Tail> nodes and ended by NoRules.  A Rule provides
+test(tc, act), which calls act.act(tc) if it matches, an Action
+provides act(tc), and both provide a constructor taking the single
+argument the StaticParser was given, e.g., a Repository*.  The rules
+and actions of the ActionsAndRules module are written that way, see
+Pass1Rules in the ConfigureParser module.  Rules are applied in list
+order, and only when their triggers are in the collection's summary,
+as Parser does, so both parsers invoke the same actions.
+
+Visual C++ 2012 has no variadic templates, so the list is nested
+rather than a parameter pack.
+
+Public Interface:
+=================
+typedef RuleList<StaticRule<ClassDefinition, PushClass>,
+        RuleList<StaticRule<EndOfScope, HandlePop>,
+        NoRules> > MyRules;
+StaticParser<SemiExp, MyRules> parser(&se, pRepo); // se is a SemiExp
+parser.addFoldingRules(&foldingRules);             // optional
+while(parser.next())                               // get, fold, and
+  parser.parse();                                  //   apply rules
+
+Build Process:
+==============
+Required files
+- StaticParser.h, StaticParser.cpp, Parser.h, Parser.cpp, and, for
+the benchmark, the files Submission.sln builds
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /O2 /DBENCH_STATICPARSER StaticParser.cpp, and the other
+.cpp files Submission.vcxproj compiles, except Executive.cpp,
+/link setargv.obj
+
+Maintenance History:
+====================
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include "Parser.h"
+
+///////////////////////////////////////////////////////////////
+// end of a rule list
+
+struct NoRules
+{
+	template<class Arg> NoRules(Arg) {}
+	template<class TC> bool parse(TC&) { return false; }
+};
+
+///////////////////////////////////////////////////////////////
+// a rule and the action it invokes on a match
+
+template<class Rule, class Action>
+class StaticRule
+{
+public:
+	template<class Arg> StaticRule(Arg arg) : rule(arg), action(arg) {}
+	template<class TC> bool parse(TC& tc)
+	{
+		const TokSet& trigs = rule.triggers();
+		if((trigs & tc.summary().present()) != trigs)
+			return false;
+		return rule.test(tc, action);
+	}
+private:
+	Rule rule;
+	Action action;
+};
+
+///////////////////////////////////////////////////////////////
+// first rule, then the rest of the list
+
+template<class Head, class Tail>
+class RuleList
+{
+public:
+	template<class Arg> RuleList(Arg arg) : head(arg), tail(arg) {}
+	template<class TC> bool parse(TC& tc)
+	{
+		bool succeeded = head.parse(tc);
+		if(tail.parse(tc))
+			succeeded = true;
+		return succeeded;
+	}
+private:
+	Head head;
+	Tail tail;
+};
+
+///////////////////////////////////////////////////////////////
+// parser applying Rules to semi-expressions in a Coll
+
+template<class Coll, class Rules>
+class StaticParser
+{
+public:
+	template<class Arg> StaticParser(Coll* pColl, Arg arg);
+	void addFoldingRules(FoldingRules* pRules);
+	bool next();
+	bool parse();
+private:
+	Coll* pColl;
+	Rules rules;
+	FoldingRules* pFoldingRules;
+
+	// prohibit copying and assignment
+	StaticParser(const StaticParser&);
+	StaticParser& operator=(const StaticParser&);
+};
+
+//----< parser of pColl, with rules and actions made from arg >------
+
+template<class Coll, class Rules>
+template<class Arg>
+StaticParser<Coll, Rules>::StaticParser(Coll* pColl_, Arg arg)
+	: pColl(pColl_), rules(arg), pFoldingRules(0) {}
+
+//----< fold semi-expressions before rules see them >----------------
+
+template<class Coll, class Rules>
+void StaticParser<Coll, Rules>::addFoldingRules(FoldingRules* pRules)
+{
+	pFoldingRules = pRules;
+}
+//----< get next semi-expression, folded and summarized >------------
+
+template<class Coll, class Rules>
+bool StaticParser<Coll, Rules>::next()
+{
+	if(!pColl->get())
+		return false;
+	if(pFoldingRules)
+	{
+		ITokCollection* pTc = pColl;
+		pFoldingRules->doFold(pTc);
+	}
+	pColl->summary();
+	return true;
+}
+//----< apply rules to the semi-expression, in list order >----------
+
+template<class Coll, class Rules>
+bool StaticParser<Coll, Rules>::parse()
+{
+	return rules.parse(*pColl);
+}
+
+#endif
@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////
+// StrView.cpp - non-owning view of a range of characters    //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include "StrView.h"
+
+//----< lexicographic comparison, like std::string::compare >--------
+
+int StrView::compare(const StrView& other) const
+{
+	size_t n = len < other.len ? len : other.len;
+	int result = n > 0 ? memcmp(pData, other.pData, n) : 0;
+	if(result != 0)
+		return result;
+	if(len < other.len)
+		return -1;
+	return len > other.len ? 1 : 0;
+}
+//----< write viewed characters to stream >--------------------------
+
+std::ostream& operator<<(std::ostream& out, const StrView& view)
+{
+	out.write(view.data(), view.length());
+	return out;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_STRVIEW
+
+int main()
+{
+	std::cout << "\n  Testing StrView class\n "
+		<< std::string(23,'=') << std::endl;
+
+	std::string source = "class Widget : public Base {";
+	StrView whole(source);
+	StrView name(source.data() + 6, 6);
+	std::cout << "\n  source: " << whole;
+	std::cout << "\n  name:   " << name;
+	std::cout << "\n  name == \"Widget\": " << (name == "Widget" ? "true" : "false");
+	std::cout << "\n  name != \"Base\":   " << (name != "Base" ? "true" : "false");
+	std::cout << "\n  name < \"Wisp\":    " << (name < "Wisp" ? "true" : "false");
+
+	std::string copy = name;
+	copy += "Factory";
+	std::cout << "\n  owning copy, changed: " << copy;
+	std::cout << "\n  view is unchanged:    " << name << "\n\n";
+}
+
+#endif
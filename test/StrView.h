@@ -0,0 +1,123 @@
+#ifndef STRVIEW_H
+#define STRVIEW_H
+///////////////////////////////////////////////////////////////
+// StrView.h - non-owning view of a range of characters      //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+This module defines a StrView class.  Its instances refer to a
+contiguous range of characters owned by someone else, e.g., the
+mapped source file scanned by a Toker, so tokens can be passed
+around and compared without allocating a std::string for each one.
+
+A StrView converts implicitly from a C string or std::string, and
+to a std::string, so code written against std::string tokens, e.g.,
+tok == "{" or std::string name = tc[i], keeps working unchanged.
+Converting to std::string makes an owning copy.
+
+A view is only valid while the characters it refers to are alive
+and unchanged.  Clients that need a token to outlive its source
+must copy it into a std::string.
+
+Public Interface:
+=================
+StrView v("a token");           // view of a C string
+StrView w(someString);          // view of a std::string's text
+if(v == "a token")              // compare text, not addresses
+  std::cout << v;               // write text to a stream
+size_t n = v.length();          // number of characters in view
+std::string s = v;              // owning copy
+
+Build Process:
+==============
+Required files
+- StrView.h, StrView.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_STRVIEW StrView.cpp
+
+Maintenance History:
+====================
+ver 1.0 : 16 Oct 26
+- first release
+*/
+
+#include <string>
+#include <cstring>
+#include <iosfwd>
+
+class StrView
+{
+public:
+	StrView();
+	StrView(const char* pStr);
+	StrView(const char* pStr, size_t len);
+	StrView(const std::string& str);
+	const char* data() const;
+	size_t length() const;
+	size_t size() const;
+	bool empty() const;
+	char operator[](size_t i) const;
+	const char* begin() const;
+	const char* end() const;
+	std::string str() const;
+	operator std::string() const;
+	int compare(const StrView& other) const;
+
+private:
+	const char* pData;
+	size_t len;
+};
+
+inline StrView::StrView() : pData(""), len(0) {}
+
+inline StrView::StrView(const char* pStr) : pData(pStr), len(strlen(pStr)) {}
+
+inline StrView::StrView(const char* pStr, size_t n) : pData(pStr), len(n) {}
+
+inline StrView::StrView(const std::string& s) : pData(s.data()), len(s.size()) {}
+
+inline const char* StrView::data() const { return pData; }
+
+inline size_t StrView::length() const { return len; }
+
+inline size_t StrView::size() const { return len; }
+
+inline bool StrView::empty() const { return len == 0; }
+
+inline char StrView::operator[](size_t i) const { return pData[i]; }
+
+inline const char* StrView::begin() const { return pData; }
+
+inline const char* StrView::end() const { return pData + len; }
+
+inline std::string StrView::str() const { return std::string(pData, len); }
+
+inline StrView::operator std::string() const { return std::string(pData, len); }
+
+inline bool operator==(const StrView& lhs, const StrView& rhs)
+{
+	return lhs.length() == rhs.length() &&
+		(lhs.length() == 0 || memcmp(lhs.data(), rhs.data(), lhs.length()) == 0);
+}
+
+inline bool operator!=(const StrView& lhs, const StrView& rhs)
+{
+	return !(lhs == rhs);
+}
+
+inline bool operator<(const StrView& lhs, const StrView& rhs)
+{
+	return lhs.compare(rhs) < 0;
+}
+
+std::ostream& operator<<(std::ostream& out, const StrView& view);
+
+#endif
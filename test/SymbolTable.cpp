@@ -27,5 +27,20 @@ int main()
     std::cout << "\n  ::Foobar is defined in " << symbols.lookUpFile("Foobar", "::");
   else
     std::cout << "\n  ::Foobar not defined";
+
+  symbols.freeze();
+  std::cout << "\n  frozen:";
+  std::cout << "\n  ::X is defined in " << symbols.lookUpFile("X", "::");
+  std::cout << "\n  B::X is defined in " << symbols.lookUpFile("X", "B::");
+  std::cout << "\n  A::Y is defined in " << symbols.lookUpFile("Y", "A::");
+  if(!symbols.containsType("Foobar"))
+    std::cout << "\n  ::Foobar not defined";
+  const SymbolTable::LookupCounts& counts = symbols.lookupCounts();
+  std::cout << "\n  filter rejected " << counts.rejected << ", looked up " << counts.lookedUp
+            << ", " << counts.falsePositives << " false positives";
+  symbols.freeze();
+  std::cout << "\n  frozen again, looked up " << counts.lookedUp;
+  symbols.resetLookupCounts();
+  std::cout << ", after reset " << counts.lookedUp;
   std::cout << "\n\n";
 }
\ No newline at end of file
@@ -4,8 +4,11 @@
 #include <unordered_map>
 #include <string>
 #include <list>
+#include <vector>
+#include <cstring>
 #include <iostream>
 #include "Utility.h"
+#include "StrView.h"
 
 typedef std::string Namespace;
 typedef std::string SourceFile;
@@ -14,11 +17,41 @@ typedef std::list<NamespaceInfo> Namespaces;
 typedef std::string TypeName;
 typedef std::unordered_map<TypeName, Namespaces> Symbols;
 
-
+/*
+ *  Pass 1 fills the table, pass 2 only looks types up in it.  freeze()
+ *  then copies it into a flat, open addressing table: names, namespaces
+ *  and files in one string, each type's namespace entries side by side,
+ *  so lookups neither allocate nor follow list nodes.  lookUpFile()
+ *  returns a view of the file name, valid until the table changes.
+ *  Add() on a frozen table thaws it.
+ *
+ *  Most names looked up aren't types at all, e.g., locals and std
+ *  names.  A frozen table has a Bloom filter in front, three bits per
+ *  name in 16 bits per type, keyed by the same hash as the slots, so
+ *  most of those are rejected by reading one word, without probing the
+ *  slots or comparing names.  lookupCounts() tells how many lookups the
+ *  filter rejected, how many went on to the slots, and how many of
+ *  those found nothing, to size the filter by.  The counts add up over
+ *  every frozen lookup until resetLookupCounts(), and freezing a table
+ *  that is already frozen changes nothing.
+ */
 class SymbolTable {
 public:
+  struct LookupCounts
+  {
+    size_t rejected;         // by the filter
+    size_t lookedUp;         // in the slots
+    size_t falsePositives;   // looked up, but not a type
+  };
+  SymbolTable() : frozen(false)
+  {
+    LookupCounts none = { 0, 0, 0 };
+    counts = none;
+  }
   void Add(TypeName t, Namespace ns, SourceFile f)
   {
+    if(frozen)
+      thaw();
     NamespaceInfo info;
     info.first = ns;
     info.second = f;
@@ -34,22 +67,173 @@ public:
       symbols[t] = nsp;
     }
   }
-  bool containsType(const TypeName& type)
+  bool containsType(const StrView& type)
   {
-    return symbols.find(type) != symbols.end();
+    if(frozen)
+      return findFrozen(type) != 0;
+    return symbols.find(type.str()) != symbols.end();
   }
-  SourceFile lookUpFile(const TypeName& type, const Namespace& ns)
+  StrView lookUpFile(const StrView& type, const StrView& ns)
   {
-    Symbols::iterator iter = symbols.find(type);
+    if(frozen)
+    {
+      const Slot* pSlot = findFrozen(type);
+      if(pSlot == 0)
+        return StrView();
+      for(size_t i = pSlot->first; i < pSlot->first + pSlot->count; ++i)
+        if(text(infos[i].ns, infos[i].nsLen) == ns)
+          return text(infos[i].file, infos[i].fileLen);
+      return StrView();
+    }
+    Symbols::iterator iter = symbols.find(type.str());
     if(iter == symbols.end())
-      return "";
-    for(auto info : iter->second)
-      if(info.first == ns)
-        return info.second;
-    return "";
+      return StrView();
+    for(Namespaces::iterator info = iter->second.begin(); info != iter->second.end(); ++info)
+      if(info->first == ns)
+        return info->second;
+    return StrView();
+  }
+  void freeze()
+  {
+    if(frozen)
+      return;
+    size_t numSlots = 1;
+    while(numSlots < 2 * symbols.size())
+      numSlots <<= 1;
+    Slot empty = { 0, 0, 0, 0, 0 };
+    slots.assign(numSlots, empty);
+    infos.clear();
+    blob.clear();
+    size_t numBits = 64;
+    while(numBits < 16 * symbols.size())
+      numBits <<= 1;
+    filter.assign(numBits / 32, 0);
+    std::unordered_map<std::string, unsigned> stored;  // namespaces and files, once each
+    for(Symbols::iterator iter = symbols.begin(); iter != symbols.end(); ++iter)
+    {
+      Slot slot;
+      slot.hash = hashOf(iter->first);
+      slot.name = store(iter->first);
+      slot.nameLen = (unsigned)iter->first.size();
+      slot.first = (unsigned)infos.size();
+      slot.count = (unsigned)iter->second.size();
+      for(Namespaces::iterator info = iter->second.begin(); info != iter->second.end(); ++info)
+      {
+        Info flat = { storeOnce(stored, info->first), (unsigned)info->first.size(),
+          storeOnce(stored, info->second), (unsigned)info->second.size() };
+        infos.push_back(flat);
+      }
+      for(int k = 0; k < 3; ++k)
+      {
+        size_t bit = filterBit(slot.hash, k);
+        filter[bit / 32] |= 1u << (bit % 32);
+      }
+      size_t pos = slot.hash & (numSlots - 1);
+      while(slots[pos].count != 0)
+        pos = (pos + 1) & (numSlots - 1);
+      slots[pos] = slot;
+    }
+    frozen = true;
+  }
+  bool isFrozen() const
+  {
+    return frozen;
+  }
+  const LookupCounts& lookupCounts() const  // since resetLookupCounts()
+  {
+    return counts;
+  }
+  void resetLookupCounts()
+  {
+    LookupCounts none = { 0, 0, 0 };
+    counts = none;
+  }
+  void addLookupCounts(const LookupCounts& other)  // e.g., of a copy
+  {
+    counts.rejected += other.rejected;
+    counts.lookedUp += other.lookedUp;
+    counts.falsePositives += other.falsePositives;
   }
 private:
+  struct Slot          // a type, count is 0 in empty slots
+  {
+    size_t hash;
+    unsigned name, nameLen;
+    unsigned first, count;   // its Infos
+  };
+  struct Info          // offsets and lengths in blob
+  {
+    unsigned ns, nsLen;
+    unsigned file, fileLen;
+  };
+  static size_t hashOf(const StrView& s)  // FNV-1a
+  {
+    size_t h = 2166136261u;
+    for(size_t i = 0; i < s.size(); ++i)
+      h = (h ^ (unsigned char)s[i]) * 16777619u;
+    return h;
+  }
+  size_t filterBit(size_t h, int k) const  // k-th of a name's bits
+  {
+    size_t step = ((h >> 16) | (h << 16)) | 1;
+    return (h + k * step) & (filter.size() * 32 - 1);
+  }
+  const Slot* findFrozen(const StrView& type) const
+  {
+    size_t h = hashOf(type);
+    for(int k = 0; k < 3; ++k)
+    {
+      size_t bit = filterBit(h, k);
+      if((filter[bit / 32] & (1u << (bit % 32))) == 0)
+      {
+        ++counts.rejected;
+        return 0;
+      }
+    }
+    ++counts.lookedUp;
+    size_t mask = slots.size() - 1;
+    for(size_t pos = h & mask; slots[pos].count != 0; pos = (pos + 1) & mask)
+    {
+      const Slot& slot = slots[pos];
+      if(slot.hash == h && slot.nameLen == type.size()
+        && memcmp(blob.data() + slot.name, type.data(), type.size()) == 0)
+        return &slot;
+    }
+    ++counts.falsePositives;
+    return 0;
+  }
+  StrView text(unsigned pos, unsigned len) const
+  {
+    return StrView(blob.data() + pos, len);
+  }
+  unsigned store(const std::string& s)
+  {
+    unsigned pos = (unsigned)blob.size();
+    blob += s;
+    return pos;
+  }
+  unsigned storeOnce(std::unordered_map<std::string, unsigned>& stored, const std::string& s)
+  {
+    std::unordered_map<std::string, unsigned>::iterator iter = stored.find(s);
+    if(iter != stored.end())
+      return iter->second;
+    return stored[s] = store(s);
+  }
+  void thaw()
+  {
+    frozen = false;
+    slots.clear();
+    infos.clear();
+    blob.clear();
+    filter.clear();
+  }
   std::unordered_map<TypeName, Namespaces> symbols;
+  bool frozen;
+  std::string blob;          // type names, namespaces and files
+  std::vector<Slot> slots;   // power of 2 in size, at most half full
+  std::vector<Info> infos;
+  std::vector<unsigned> filter;   // Bloom filter of frozen names
+  mutable LookupCounts counts;
 };
 
 #endif // !SYMBOLTABLE_H
\ No newline at end of file
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////
+// TextArena.cpp - bump allocator for short lived token text //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include "TextArena.h"
+
+//----< empty arena, blocks are allocated as text is copied >--------
+
+TextArena::TextArena(size_t blockSize_)
+	: blockSize(blockSize_ > 0 ? blockSize_ : 1), current(0), used(0) {}
+
+//----< destructor frees all blocks >--------------------------------
+
+TextArena::~TextArena()
+{
+	for(size_t i=0; i<blocks.size(); ++i)
+		delete [] blocks[i].pMem;
+}
+//----< room for len chars, in first block with room to spare >------
+
+char* TextArena::allocate(size_t len)
+{
+	for(; current < blocks.size(); ++current, used = 0)
+	{
+		if(used + len <= blocks[current].size)
+		{
+			char* p = blocks[current].pMem + used;
+			used += len;
+			return p;
+		}
+	}
+	Block block;
+	block.size = len > blockSize ? len : blockSize;
+	block.pMem = new char[block.size];
+	blocks.push_back(block);
+	current = blocks.size() - 1;
+	used = len;
+	return block.pMem;
+}
+//----< copy of text, valid until reset() >--------------------------
+
+StrView TextArena::copy(const StrView& text)
+{
+	if(text.empty())
+		return StrView();
+	char* p = allocate(text.length());
+	memcpy(p, text.data(), text.length());
+	return StrView(p, text.length());
+}
+//----< drop all copies, keeping blocks for reuse >------------------
+
+void TextArena::reset()
+{
+	current = 0;
+	used = 0;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_TEXTARENA
+
+#include <iostream>
+#include <string>
+
+int main()
+{
+	std::cout << "\n  Testing TextArena class\n "
+		<< std::string(25,'=') << std::endl;
+
+	TextArena arena(16);
+	StrView a = arena.copy("class");
+	StrView b = arena.copy("Widget");
+	StrView c = arena.copy("\"a quote longer than a block\"");
+	std::cout << "\n  copies: " << a << " " << b << " " << c;
+	std::cout << "\n  " << arena.numBlocks() << " blocks after copies";
+
+	// after reset the same copies fit in the blocks already held
+
+	for(int i=0; i<1000; ++i)
+	{
+		arena.reset();
+		a = arena.copy("class");
+		b = arena.copy("Widget");
+		c = arena.copy("\"a quote longer than a block\"");
+	}
+	std::cout << "\n  " << arena.numBlocks() << " blocks after 1000 resets";
+	std::cout << "\n  copies: " << a << " " << b << " " << c << "\n\n";
+}
+
+#endif
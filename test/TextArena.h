@@ -0,0 +1,80 @@
+#ifndef TEXTARENA_H
+#define TEXTARENA_H
+///////////////////////////////////////////////////////////////
+// TextArena.h - bump allocator for short lived token text   //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+This module defines a TextArena class.  It copies text into large
+blocks, one copy after another, and frees all of it at once with
+reset().  A SemiExp keeps the text of tokens it owns in an arena,
+and resets it each time it is cleared.
+
+reset() doesn't free the blocks, it only starts filling them again
+from the first one, so once an arena has grown to hold its largest
+semi-expression, copying text into it allocates no more memory.
+Text longer than a block gets a block of its own.
+
+Views returned by copy() are valid until the next reset().
+
+Public Interface:
+=================
+TextArena arena;                  // blocks of 4 KB
+StrView v = arena.copy(someView); // copy text into arena
+arena.reset();                    // v is no longer valid
+size_t n = arena.numBlocks();     // blocks held, used or not
+
+Build Process:
+==============
+Required files
+- TextArena.h, TextArena.cpp, StrView.h, StrView.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_TEXTARENA TextArena.cpp StrView.cpp
+
+Maintenance History:
+====================
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include <vector>
+#include "StrView.h"
+
+class TextArena
+{
+public:
+	TextArena(size_t blockSize = 4096);
+	~TextArena();
+	StrView copy(const StrView& text);
+	void reset();
+	size_t numBlocks() const;
+
+private:
+	struct Block
+	{
+		char* pMem;
+		size_t size;
+	};
+	char* allocate(size_t len);
+
+	std::vector<Block> blocks;
+	size_t blockSize;
+	size_t current;     // index of block being filled
+	size_t used;        // bytes used in current block
+
+	// prohibit copying and assignment
+	TextArena(const TextArena&);
+	TextArena& operator=(const TextArena&);
+};
+
+inline size_t TextArena::numBlocks() const { return blocks.size(); }
+
+#endif
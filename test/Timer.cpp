@@ -0,0 +1,34 @@
+///////////////////////////////////////////////////////////////
+// Timer.cpp - elapsed time for benchmark stubs              //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_TIMER
+
+#include <iostream>
+#include <string>
+#include "Timer.h"
+
+int main()
+{
+	std::cout << "\n  Testing Timer class\n "
+		<< std::string(21,'=') << std::endl;
+
+	Timer t;
+	volatile double sum = 0;
+	for(int i=0; i<10000000; ++i)
+		sum = sum + i;
+	std::cout << "\n  10 million additions took " << t.elapsed() * 1000.0 << " msec";
+
+	t.restart();
+	std::cout << "\n  restarted, elapsed is " << t.elapsed() * 1000.0 << " msec\n\n";
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef TIMER_H
+#define TIMER_H
+///////////////////////////////////////////////////////////////
+// Timer.h - elapsed time for benchmark stubs                //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+This module defines a Timer class used by the benchmark stubs of
+other modules, e.g., BENCH_TOKENIZER in Tokenizer.cpp.  A Timer
+starts when constructed or restarted, and reports the time since
+then in seconds.
+
+Public Interface:
+=================
+Timer t;                        // start timing
+doWork();
+double secs = t.elapsed();      // seconds since start
+t.restart();                    // start timing again
+
+Build Process:
+==============
+Required files
+- Timer.h, Timer.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_TIMER Timer.cpp
+
+Maintenance History:
+====================
+ver 1.0 : 16 Oct 26
+- first release
+*/
+
+#include <chrono>
+
+class Timer
+{
+public:
+	Timer();
+	void restart();
+	double elapsed() const;
+
+private:
+	std::chrono::high_resolution_clock::time_point start;
+};
+
+inline Timer::Timer() : start(std::chrono::high_resolution_clock::now()) {}
+
+inline void Timer::restart() { start = std::chrono::high_resolution_clock::now(); }
+
+inline double Timer::elapsed() const
+{
+	std::chrono::duration<double> secs = std::chrono::high_resolution_clock::now() - start;
+	return secs.count();
+}
+
+#endif
@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////////////////
+// TokSummary.cpp - positions of predefined tokens           //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include "TokSummary.h"
+
+//----< summary of an empty collection >-----------------------------
+
+TokSummary::TokSummary() : len(0) {}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_TOKSUMMARY
+
+#include <iostream>
+#include <string>
+
+int main()
+{
+	std::cout << "\n  Testing TokSummary class\n "
+		<< std::string(26,'=') << std::endl;
+
+	const char* toks[] = { "class", "Widget", ":", "public", "Base", "{" };
+	const size_t n = sizeof(toks) / sizeof(toks[0]);
+	TokSummary ts;
+	ts.clear(n);
+	std::cout << "\n ";
+	for(size_t i=0; i<n; ++i)
+	{
+		ts.note(internTok(toks[i]), i);
+		std::cout << " " << toks[i];
+	}
+	std::cout << "\n  first class: " << ts.first(tok_class);
+	std::cout << "\n  first {:     " << ts.first(tok_lbrace);
+	std::cout << "\n  first ::     " << ts.first(tok_scope) << " (absent, so length)";
+	std::cout << "\n  has public:  " << (ts.has(tok_public) ? "yes" : "no");
+	std::cout << "\n  has Widget:  " << (ts.has(internTok("Widget")) ? "yes" : "no")
+		<< " (not a predefined token)";
+	std::cout << "\n  " << ts.present().count() << " predefined tokens present\n\n";
+}
+
+#endif
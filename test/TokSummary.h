@@ -0,0 +1,114 @@
+#ifndef TOKSUMMARY_H
+#define TOKSUMMARY_H
+///////////////////////////////////////////////////////////////
+// TokSummary.h - positions of predefined tokens             //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+This module defines a TokSummary class.  It holds, for one token
+collection, which predefined tokens, i.e., punctuators and keywords,
+occur in it, and the first and last position of each.  It is built
+in a single pass over the collection's TokIds, after which finding
+"(" or "class" takes constant time instead of a scan.
+
+Positions of absent tokens are reported as length(), as find() does,
+so rules can use first(id) wherever they used find(id).  Only
+predefined tokens are summarized, use find() for other tokens.
+
+ITokCollection::summary() returns the summary of a collection.  The
+parser asks for it once, after folding, and rules share that copy.
+
+Public Interface:
+=================
+TokSummary ts;
+ts.clear(n);                       // summary of n tokens, none noted
+ts.note(tok_lparen, 3);            // note tokens, in position order
+if(ts.has(tok_lparen))             // is "(" present?
+  size_t i = ts.first(tok_lparen); // position of first "("
+size_t j = ts.last(tok_lbrace);    // last "{", or ts.length()
+const TokSet& s = ts.present();    // all predefined tokens present
+
+Build Process:
+==============
+Required files
+- TokSummary.h, TokSummary.cpp, TokenPool.h, TokenPool.cpp,
+StrView.h, StrView.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_TOKSUMMARY TokSummary.cpp TokenPool.cpp StrView.cpp
+
+Maintenance History:
+====================
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include <bitset>
+#include "TokenPool.h"
+
+///////////////////////////////////////////////////////////////
+// set of predefined tokens, indexed by TokId
+
+typedef std::bitset<numPredefinedToks> TokSet;
+
+///////////////////////////////////////////////////////////////
+// first and last positions of predefined tokens
+
+class TokSummary
+{
+public:
+	TokSummary();
+	void clear(size_t length);
+	void note(TokId id, size_t pos);
+	bool has(TokId id) const;
+	size_t first(TokId id) const;
+	size_t last(TokId id) const;
+	size_t length() const;
+	const TokSet& present() const;
+
+private:
+	TokSet seen;
+	size_t len;
+	size_t firstPos[numPredefinedToks];  // valid only where seen
+	size_t lastPos[numPredefinedToks];
+};
+
+inline void TokSummary::clear(size_t length)
+{
+	seen.reset();
+	len = length;
+}
+
+inline void TokSummary::note(TokId id, size_t pos)
+{
+	if(id >= numPredefinedToks)
+		return;
+	if(!seen.test(id))
+	{
+		seen.set(id);
+		firstPos[id] = pos;
+	}
+	lastPos[id] = pos;
+}
+
+inline bool TokSummary::has(TokId id) const
+{
+	return id < numPredefinedToks && seen.test(id);
+}
+
+inline size_t TokSummary::first(TokId id) const { return has(id) ? firstPos[id] : len; }
+
+inline size_t TokSummary::last(TokId id) const { return has(id) ? lastPos[id] : len; }
+
+inline size_t TokSummary::length() const { return len; }
+
+inline const TokSet& TokSummary::present() const { return seen; }
+
+#endif
@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////
+// TokenKind.cpp - classifies predefined tokens              //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include "TokenKind.h"
+
+//----< predefined tokens with any of kinds' flags >-----------------
+
+TokSet tokensOfKind(unsigned kinds)
+{
+	TokSet set;
+	for(TokId id=0; id<numPredefinedToks; ++id)
+		if(isTokenKind(id, kinds))
+			set.set(id);
+	return set;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_TOKENKIND
+
+#include <iostream>
+
+int main()
+{
+	std::cout << "\n  Testing TokenKind\n "
+		<< std::string(19,'=') << std::endl;
+
+	TokenPool& pool = TokenPool::instance();
+	const char* toks[] = { "class", "int", "while", "nullptr", "{", "::", "Widget", "42" };
+	for(size_t i=0; i<sizeof(toks)/sizeof(toks[0]); ++i)
+	{
+		unsigned kind = tokenKind(pool.intern(toks[i]));
+		std::cout << "\n  " << toks[i] << ":";
+		if(kind == tk_other)
+			std::cout << " other";
+		if(kind & tk_punctuator)
+			std::cout << " punctuator";
+		if(kind & tk_keyword)
+			std::cout << " keyword";
+		if(kind & tk_builtinType)
+			std::cout << " builtinType";
+		if(kind & tk_control)
+			std::cout << " control";
+		if(kind & tk_cpp11)
+			std::cout << " cpp11";
+	}
+	std::cout << "\n\n  " << tokensOfKind(tk_keyword).count() << " keywords, "
+		<< tokensOfKind(tk_punctuator).count() << " punctuators, "
+		<< tokensOfKind(tk_control).count() << " control keywords\n\n";
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef TOKENKIND_H
+#define TOKENKIND_H
+///////////////////////////////////////////////////////////////
+// TokenKind.h - classifies predefined tokens                //
+// Ver 1.0                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+Rules used to tell keywords from names by comparing each token with
+a list of keyword strings.  The TokenPool already maps every token
+to an id when it is collected, and gives each punctuator and keyword
+a fixed id, so the id is a perfect hash of the keywords: this module
+classifies ids instead, with a switch the compiler turns into a jump
+table.
+
+tokenKind() returns TokenKind flags: whether the token is a
+punctuator or a keyword, and for keywords, whether it names a built
+in type, begins a control statement with a parenthesized head, e.g.,
+"for" or "catch", or was added by C++11.  Names, literals and other
+tokens the pool wasn't given in advance are tk_other.
+
+tokensOfKind() returns the set of predefined tokens with any of the
+given flags, as a TokSet, so a rule can test a whole semi-expression
+with its TokSummary's present() set instead of looking at each token.
+
+Public Interface:
+=================
+if(tokenKind(tc.id(i)) & tk_keyword)     // is token i a keyword?
+if(isTokenKind(id, tk_control))          // for, while, switch, if, catch
+TokSet keys = tokensOfKind(tk_keyword);  // all keywords
+if((ts.present() & keys).any())          // semi-expression has one?
+
+Build Process:
+==============
+Required files
+- TokenKind.h, TokenKind.cpp, TokSummary.h, TokSummary.cpp,
+TokenPool.h, TokenPool.cpp, StrView.h, StrView.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_TOKENKIND TokenKind.cpp TokSummary.cpp TokenPool.cpp \
+StrView.cpp
+
+Maintenance History:
+====================
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include "TokSummary.h"
+
+enum TokenKind
+{
+	tk_other       = 0,        // names, literals, anything not predefined
+	tk_punctuator  = 1 << 0,
+	tk_keyword     = 1 << 1,
+	tk_builtinType = 1 << 2,   // keyword naming a built in type, e.g., int
+	tk_control     = 1 << 3,   // keyword followed by a parenthesized head
+	tk_cpp11       = 1 << 4    // keyword added by C++11
+};
+
+//----< TokenKind flags of a token's id >----------------------------
+
+inline unsigned tokenKind(TokId id)
+{
+	if(id >= numPredefinedToks || id == tok_empty)
+		return tk_other;
+	if(id < tok_alignas)           // punctuators are registered first
+		return tk_punctuator;
+	switch(id)
+	{
+	case tok_bool: case tok_char: case tok_double: case tok_float: case tok_int:
+	case tok_long: case tok_short: case tok_signed: case tok_unsigned: case tok_void:
+	case tok_wchar_t:
+		return tk_keyword | tk_builtinType;
+	case tok_char16_t: case tok_char32_t:
+		return tk_keyword | tk_builtinType | tk_cpp11;
+	case tok_for: case tok_while: case tok_switch: case tok_if: case tok_catch:
+		return tk_keyword | tk_control;
+	case tok_alignas: case tok_alignof: case tok_constexpr: case tok_decltype:
+	case tok_final: case tok_noexcept: case tok_nullptr: case tok_override:
+	case tok_static_assert: case tok_thread_local:
+		return tk_keyword | tk_cpp11;
+	default:
+		return tk_keyword;
+	}
+}
+//----< has token any of kinds' flags? >-----------------------------
+
+inline bool isTokenKind(TokId id, unsigned kinds)
+{
+	return (tokenKind(id) & kinds) != 0;
+}
+
+TokSet tokensOfKind(unsigned kinds);
+
+#endif
@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////
+// TokenPool.cpp - maps token text to dense integer ids      //
+// Ver 1.2                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include "TokenPool.h"
+
+namespace
+{
+#define TOKENPOOL_TEXT(name, text) text,
+	const char* const predefinedText[] =
+	{
+		TOKENPOOL_PUNCTUATORS(TOKENPOOL_TEXT)
+		TOKENPOOL_KEYWORDS(TOKENPOOL_TEXT)
+	};
+#undef TOKENPOOL_TEXT
+}
+
+//----< the one pool >-----------------------------------------------
+
+TokenPool& TokenPool::instance()
+{
+	static TokenPool pool;
+	return pool;
+}
+
+// Visual C++ 2012 doesn't make the first call of instance() thread
+// safe, so make that call during static initialization, before main
+
+namespace
+{
+	TokenPool& poolBuiltAtStartup = TokenPool::instance();
+}
+
+//----< register predefined tokens, in list order >------------------
+
+TokenPool::TokenPool() : fixedSlots(512, noTok)
+{
+	for(TokId id=0; id<numPredefinedToks; ++id)
+	{
+		StrView text(predefinedText[id]);
+		fixedTexts.push_back(text);
+		fixedSlots[probe(fixedSlots, fixedTexts, text, hash(text))] = id;
+	}
+}
+
+TokenPool::Shard::Shard() : slots(256, noTok) {}
+
+//----< FNV-1a hash of token text >----------------------------------
+
+size_t TokenPool::hash(const StrView& tok)
+{
+	unsigned h = 2166136261u;
+	for(size_t i=0; i<tok.length(); ++i)
+	{
+		h ^= (unsigned char)tok[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+//----< slot holding tok's id, or empty slot where it belongs >------
+
+size_t TokenPool::probe(const std::vector<TokId>& slots, const std::vector<StrView>& texts,
+	const StrView& tok, size_t h)
+{
+	size_t mask = slots.size() - 1;
+	for(size_t i = h & mask; ; i = (i + 1) & mask)
+	{
+		TokId id = slots[i];
+		if(id == noTok || texts[id] == tok)
+			return i;
+	}
+}
+//----< id of token text, adding text if not seen before >-----------
+/*
+ *  The hash's high bits pick the shard, its low bits the slot.  A
+ *  run time id is numPredefinedToks + index in shard * numShards +
+ *  shard, so ids of different shards never collide.
+ */
+TokId TokenPool::intern(const StrView& tok)
+{
+	size_t h = hash(tok);
+	TokId id = fixedSlots[probe(fixedSlots, fixedTexts, tok, h)];
+	if(id != noTok)
+		return id;
+
+	size_t shardNum = (h >> (32 - shardBits)) & (numShards - 1);
+	Shard& shard = shards[shardNum];
+	std::lock_guard<std::mutex> lock(shard.mtx);
+	size_t slot = probe(shard.slots, shard.texts, tok, h);
+	TokId index = shard.slots[slot];
+	if(index == noTok)
+	{
+		shard.store.push_back(std::string(tok.data(), tok.length()));
+		index = (TokId)shard.texts.size();
+		shard.texts.push_back(StrView(shard.store.back()));
+		shard.slots[slot] = index;
+		if(2 * shard.texts.size() > shard.slots.size())
+			grow(shard);
+	}
+	return numPredefinedToks + (index << shardBits) + (TokId)shardNum;
+}
+//----< double shard's table size, keeping it at most half full >----
+
+void TokenPool::grow(Shard& shard)
+{
+	std::vector<TokId> bigger(2 * shard.slots.size(), noTok);
+	for(TokId index=0; index<(TokId)shard.texts.size(); ++index)
+		bigger[probe(bigger, shard.texts, shard.texts[index], hash(shard.texts[index]))] = index;
+	shard.slots.swap(bigger);
+}
+//----< text of an id, empty if id is not in use >-------------------
+
+StrView TokenPool::text(TokId id)
+{
+	if(id < numPredefinedToks)
+		return fixedTexts[id];
+	if(id == noTok)
+		return StrView();
+	TokId runTime = id - numPredefinedToks;
+	Shard& shard = shards[runTime & (numShards - 1)];
+	TokId index = runTime >> shardBits;
+	std::lock_guard<std::mutex> lock(shard.mtx);
+	if(index >= shard.texts.size())
+		return StrView();
+	return shard.texts[index];
+}
+//----< number of ids in use >---------------------------------------
+
+size_t TokenPool::size()
+{
+	size_t n = numPredefinedToks;
+	for(size_t i=0; i<numShards; ++i)
+	{
+		std::lock_guard<std::mutex> lock(shards[i].mtx);
+		n += shards[i].texts.size();
+	}
+	return n;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_TOKENPOOL
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+int main()
+{
+	std::cout << "\n  Testing TokenPool class\n "
+		<< std::string(25,'=') << std::endl;
+
+	TokenPool& pool = TokenPool::instance();
+	std::cout << "\n  " << pool.size() << " predefined tokens";
+	size_t mismatches = 0;
+	for(TokId id=0; id<numPredefinedToks; ++id)
+		if(pool.intern(predefinedText[id]) != id)
+			++mismatches;
+	std::cout << "\n  " << mismatches << " predefined tokens with unexpected ids";
+	std::cout << "\n  \"(\" is " << pool.intern("(") << ", tok_lparen is " << tok_lparen;
+	std::cout << "\n  \"class\" is " << pool.intern("class") << ", tok_class is " << tok_class;
+
+	TokId widget = pool.intern("Widget");
+	std::cout << "\n  \"Widget\" is " << widget << ", again " << pool.intern(std::string("Widget"))
+		<< ", text of " << widget << " is " << pool.text(widget);
+
+	for(int i=0; i<10000; ++i)
+	{
+		std::ostringstream name;
+		name << "name" << i;
+		pool.intern(name.str());
+	}
+	std::cout << "\n  after adding 10000 names, \"Widget\" is still " << pool.intern("Widget")
+		<< ", pool holds " << pool.size() << " tokens";
+
+	// threads interning the same names, each in its own order, must
+	// agree on every id, and each id's text must be its name
+
+	const int numThreads = 4, numNames = 20000;
+	std::vector<std::vector<TokId> > ids(numThreads, std::vector<TokId>(numNames));
+	std::vector<std::thread> threads;
+	for(int t=0; t<numThreads; ++t)
+	{
+		threads.push_back(std::thread([&ids, t]()
+		{
+			for(int n=0; n<numNames; ++n)
+			{
+				int i = (t % 2) ? numNames - 1 - n : n;
+				std::ostringstream name;
+				name << "shared" << i;
+				ids[t][i] = internTok(name.str());
+			}
+		}));
+	}
+	for(size_t t=0; t<threads.size(); ++t)
+		threads[t].join();
+	size_t disagree = 0, wrongText = 0;
+	for(int i=0; i<numNames; ++i)
+	{
+		std::ostringstream name;
+		name << "shared" << i;
+		for(int t=1; t<numThreads; ++t)
+			if(ids[t][i] != ids[0][i])
+				++disagree;
+		if(pool.text(ids[0][i]) != name.str())
+			++wrongText;
+	}
+	std::cout << "\n  " << numThreads << " threads interned " << numNames << " shared names: "
+		<< disagree << " ids disagree, " << wrongText << " texts wrong, pool holds "
+		<< pool.size() << " tokens\n\n";
+}
+
+#endif
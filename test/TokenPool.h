@@ -0,0 +1,161 @@
+#ifndef TOKENPOOL_H
+#define TOKENPOOL_H
+///////////////////////////////////////////////////////////////
+// TokenPool.h - maps token text to dense integer ids        //
+// Ver 1.2                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+This module defines a TokenPool class.  Its single instance interns
+token text: every distinct text gets a TokId, and the same text
+always gets the same id.  Rules can then
+look for tokens by comparing integers instead of strings.
+
+Punctuators, single char tokens, and C++ keywords are registered
+before any other text, in the order of the lists below, so their
+ids are compile time constants, e.g., tok_lparen for "(" and
+tok_class for "class".  Other text is added when first interned.
+
+intern() and text() may be called from several threads.  Lookups of
+predefined tokens take no lock.  Other text is spread over shards by
+its hash, each shard a table with its own mutex, so -j workers, the
+pipe's producer, and ChunkLexer threads interning different names
+rarely wait for one another.  A run time id names its shard in its
+low bits, so text() locks only that shard.  Run time ids are unique,
+but not dense.
+
+Public Interface:
+=================
+TokenPool& pool = TokenPool::instance();
+TokId id = pool.intern("Widget");       // id of text, added if new
+if(pool.intern("(") == tok_lparen)      // predefined ids are constants
+  std::cout << pool.text(id);           // text of an id
+size_t n = pool.size();                 // number of ids in use
+TokId id2 = internTok(someView);        // shorthand for instance().intern
+
+Build Process:
+==============
+Required files
+- TokenPool.h, TokenPool.cpp, StrView.h, StrView.cpp
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_TOKENPOOL TokenPool.cpp StrView.cpp
+
+Maintenance History:
+====================
+ver 1.2 : 17 Oct 26
+- run time text is interned in shards, each with its own lock, in
+  place of one lock for the whole pool
+ver 1.1 : 17 Oct 26
+- text() of predefined ids takes no lock, for replayed semi-expressions
+ver 1.0 : 16 Oct 26
+- first release
+*/
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include "StrView.h"
+
+typedef unsigned int TokId;
+
+const TokId noTok = 0xFFFFFFFF;
+
+///////////////////////////////////////////////////////////////
+// predefined tokens: X(id name, token text)
+
+#define TOKENPOOL_PUNCTUATORS(X) \
+	X(tok_empty, "") X(tok_lparen, "(") X(tok_rparen, ")") X(tok_lbracket, "[") \
+	X(tok_rbracket, "]") X(tok_lbrace, "{") X(tok_rbrace, "}") X(tok_semicolon, ";") \
+	X(tok_dot, ".") X(tok_newline, "\n") X(tok_lt, "<") X(tok_gt, ">") \
+	X(tok_bang, "!") X(tok_scope, "::") X(tok_colon, ":") X(tok_comma, ",") \
+	X(tok_assign, "=") X(tok_hash, "#") X(tok_hashhash, "##") X(tok_star, "*") \
+	X(tok_amp, "&") X(tok_ampamp, "&&") X(tok_arrow, "->") X(tok_arrowstar, "->*") \
+	X(tok_plus, "+") X(tok_minus, "-") X(tok_slash, "/") X(tok_percent, "%") \
+	X(tok_caret, "^") X(tok_bar, "|") X(tok_barbar, "||") X(tok_tilde, "~") \
+	X(tok_question, "?") X(tok_inc, "++") X(tok_dec, "--") X(tok_shl, "<<") \
+	X(tok_shr, ">>") X(tok_eq, "==") X(tok_ne, "!=") X(tok_le, "<=") \
+	X(tok_ge, ">=") X(tok_plusassign, "+=") X(tok_minusassign, "-=") X(tok_starassign, "*=") \
+	X(tok_slashassign, "/=") X(tok_percentassign, "%=") X(tok_caretassign, "^=") X(tok_barassign, "|=") \
+	X(tok_ampassign, "&=") X(tok_shlassign, "<<=") X(tok_shrassign, ">>=") X(tok_lineComment, "//") \
+	X(tok_blockComment, "/*")
+
+#define TOKENPOOL_KEYWORDS(X) \
+	X(tok_alignas, "alignas") X(tok_alignof, "alignof") X(tok_asm, "asm") X(tok_auto, "auto") \
+	X(tok_bool, "bool") X(tok_break, "break") X(tok_case, "case") X(tok_catch, "catch") \
+	X(tok_char, "char") X(tok_char16_t, "char16_t") X(tok_char32_t, "char32_t") X(tok_class, "class") \
+	X(tok_const, "const") X(tok_const_cast, "const_cast") X(tok_constexpr, "constexpr") X(tok_continue, "continue") \
+	X(tok_decltype, "decltype") X(tok_default, "default") X(tok_delete, "delete") X(tok_do, "do") \
+	X(tok_double, "double") X(tok_dynamic_cast, "dynamic_cast") X(tok_else, "else") X(tok_enum, "enum") \
+	X(tok_explicit, "explicit") X(tok_export, "export") X(tok_extern, "extern") X(tok_false, "false") \
+	X(tok_final, "final") X(tok_float, "float") X(tok_for, "for") X(tok_friend, "friend") \
+	X(tok_goto, "goto") X(tok_if, "if") X(tok_inline, "inline") X(tok_int, "int") \
+	X(tok_long, "long") X(tok_mutable, "mutable") X(tok_namespace, "namespace") X(tok_new, "new") \
+	X(tok_noexcept, "noexcept") X(tok_nullptr, "nullptr") X(tok_operator, "operator") X(tok_override, "override") \
+	X(tok_private, "private") X(tok_protected, "protected") X(tok_public, "public") X(tok_register, "register") \
+	X(tok_reinterpret_cast, "reinterpret_cast") X(tok_return, "return") X(tok_short, "short") X(tok_signed, "signed") \
+	X(tok_sizeof, "sizeof") X(tok_static, "static") X(tok_static_assert, "static_assert") X(tok_static_cast, "static_cast") \
+	X(tok_struct, "struct") X(tok_switch, "switch") X(tok_template, "template") X(tok_this, "this") \
+	X(tok_thread_local, "thread_local") X(tok_throw, "throw") X(tok_true, "true") X(tok_try, "try") \
+	X(tok_typedef, "typedef") X(tok_typeid, "typeid") X(tok_typename, "typename") X(tok_union, "union") \
+	X(tok_unsigned, "unsigned") X(tok_using, "using") X(tok_virtual, "virtual") X(tok_void, "void") \
+	X(tok_volatile, "volatile") X(tok_wchar_t, "wchar_t") X(tok_while, "while")
+
+#define TOKENPOOL_ENUM(name, text) name,
+enum PredefinedTokId
+{
+	TOKENPOOL_PUNCTUATORS(TOKENPOOL_ENUM)
+	TOKENPOOL_KEYWORDS(TOKENPOOL_ENUM)
+	numPredefinedToks
+};
+#undef TOKENPOOL_ENUM
+
+///////////////////////////////////////////////////////////////
+// TokenPool: single, process wide, token interner
+
+class TokenPool
+{
+public:
+	static TokenPool& instance();
+	TokId intern(const StrView& tok);
+	StrView text(TokId id);
+	size_t size();
+
+private:
+	enum { shardBits = 4, numShards = 1 << shardBits };
+
+	struct Shard
+	{
+		Shard();
+		std::mutex mtx;                 // guards everything below
+		std::vector<TokId> slots;       // open addressing table of the shard's ids
+		std::vector<StrView> texts;     // text of each id, by index within shard
+		std::deque<std::string> store;  // text of ids added at run time
+		char pad[64];                   // keeps shards' locks off each other's cache lines
+	};
+
+	TokenPool();
+	static size_t hash(const StrView& tok);
+	static size_t probe(const std::vector<TokId>& slots, const std::vector<StrView>& texts,
+		const StrView& tok, size_t h);
+	static void grow(Shard& shard);
+
+	std::vector<TokId> fixedSlots;    // predefined ids, never changed after construction
+	std::vector<StrView> fixedTexts;
+	Shard shards[numShards];
+
+	// prohibit copying and assignment
+	TokenPool(const TokenPool&);
+	TokenPool& operator=(const TokenPool&);
+};
+
+inline TokId internTok(const StrView& tok) { return TokenPool::instance().intern(tok); }
+
+#endif
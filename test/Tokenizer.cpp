@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  Tokenizer.cpp - Reads words from a file                        //
-//  ver 2.1                                                        //
+//  ver 2.6                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -10,18 +10,60 @@
 /////////////////////////////////////////////////////////////////////
 
 #include <cctype>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <assert.h>
 #include "Tokenizer.h"
+#include "FileMap.h"
+#include "ScanKernel.h"
+#include "ChunkLexer.h"
 
+//----< classify all byte values for given token settings >---
+
+void CharClasses::build(const std::string& singleCharToks, bool singleQuotes)
+{
+  for(int ch=0; ch<256; ++ch)
+  {
+    unsigned char cls = 0;
+    if(ch < 128 && isspace(ch))
+      cls |= space;
+    if(ch < 128 && (isalpha(ch) || ch == '_' || isdigit(ch)))
+      cls |= ident;
+    table[ch] = cls;
+  }
+  for(size_t i=0; i<singleCharToks.length(); ++i)
+    table[(unsigned char)singleCharToks[i]] |= singleChar;
+  table[(unsigned char)'\"'] |= quoteStart;
+  if(singleQuotes)
+    table[(unsigned char)'\''] |= quoteStart;
+  table[(unsigned char)'/'] |= commentStart;
+
+  // bulk scans may be used only where they agree with the table
+  kernelMatch = true;
+  for(int ch=0; ch<256; ++ch)
+  {
+    bool blank = (ch == ' ' || ch == '\t' || ch == '\v' || ch == '\f');
+    bool identCh = (ch < 128 && (isalnum(ch) || ch == '_'));
+    if(blank != ((table[ch] & space) && ch != '\n' && ch != '\r'))
+      kernelMatch = false;
+    if(identCh != ((table[ch] & ident) != 0))
+      kernelMatch = false;
+    if(identCh && (table[ch] & (singleChar | quoteStart | commentStart)))
+      kernelMatch = false;
+  }
+}
 //----< constructor may be called with no argument >-----------
 
 Toker::Toker(const std::string& src, bool isFile) 
      : prevprevChar(0), prevChar(0), currChar(0), nextChar(0),
        doReturnComments(false), doReturnSingleQuotesAsToken(true),
-       numLines(0), braceCount(0), pIn(0),
+       numLines(0), braceCount(0), pIn(0), pMap(0), doMapInput(false), doFastScan(true),
+       fromBuffer(false), bufferEof(false), pBegin(0), pNext(0), pEnd(0),
+       pChunks(0), doParallelLex(false), minChunkBytes(1<<20), chunkLines(0),
+       chunkWorker(false), workerBailed(false),
        _state(default_state), EndQuoteCounter(false)
 {
   if(src.length() > 0)
@@ -35,6 +77,7 @@ Toker::Toker(const std::string& src, bool isFile)
   scTok = "()[]{};.\n";
   if(_mode == xml)
     scTok = "<>!" + scTok;
+  classes.build(scTok, doReturnSingleQuotesAsToken);
 }
 //----< destructor >-------------------------------------------
 
@@ -50,6 +93,8 @@ Toker::~Toker()
     }
     delete pIn;
   }
+  delete pChunks;
+  delete pMap;
 }
 //----< set mode for collecting single quoted strings >--------
 
@@ -57,6 +102,7 @@ void Toker::returnSingleQuotedStringAsToken(bool doReturn)
 { 
   doReturnSingleQuotesAsToken = doReturn; 
   scTok += "\'";
+  classes.build(scTok, doReturnSingleQuotesAsToken);
 }
 
 //----< set mode of tokenizing, e.g., code or xml >------------
@@ -67,6 +113,7 @@ void Toker::setMode(Toker::mode md)
   scTok = "()[]{};.\n";
   if(_mode == xml)
     scTok = "<>!" + scTok;
+  classes.build(scTok, doReturnSingleQuotesAsToken);
 }
 //----< set mode of tokenizing, e.g., code or xml >------------
 
@@ -74,6 +121,7 @@ void Toker::setSingleCharTokens(std::string tokChars)
 { 
   _mode = custom; 
   scTok = tokChars;
+  classes.build(scTok, doReturnSingleQuotesAsToken);
 }
 //----< attach tokenizer to a source file or string >----------
 
@@ -81,6 +129,9 @@ bool Toker::attach(const std::string& name, bool srcIsFile)
 {
   prevprevChar = prevChar = currChar = nextChar = 0;
   numLines = braceCount = 0;
+  fromBuffer = false;
+  delete pChunks;
+  pChunks = 0;
 
   if(pIn && srcIsFile)
   {
@@ -91,21 +142,79 @@ bool Toker::attach(const std::string& name, bool srcIsFile)
       pFs->close();
     }
   }
+  if(doMapInput)
+  {
+    if(srcIsFile)
+    {
+      if(pMap == 0)
+        pMap = new FileMap;
+      if(!pMap->open(name))
+        return false;
+      attachBuffer(pMap->begin(), pMap->end());
+    }
+    else
+    {
+      srcText = name.c_str();
+      attachBuffer(srcText.data(), srcText.data() + srcText.size());
+    }
+    if(doParallelLex)
+      startChunks();
+    return true;
+  }
   if(srcIsFile)
     pIn = new std::ifstream(name.c_str());
   else
     pIn = new std::istringstream(name.c_str());
   return pIn->good();
 }
+//----< scan a contiguous range of characters >----------------
+
+void Toker::attachBuffer(const char* pFirst, const char* pLast)
+{
+  fromBuffer = true;
+  bufferEof = false;
+  pBegin = pNext = pFirst;
+  pEnd = pLast;
+#ifdef _WIN32
+  // text mode streams stop at ctrl-Z
+  const void* pCtrlZ = memchr(pFirst, 0x1A, pLast - pFirst);
+  if(pCtrlZ)
+    pEnd = static_cast<const char*>(pCtrlZ);
+#endif
+}
+//----< lex attached buffer in chunks, if it's large enough >--
+
+void Toker::startChunks()
+{
+  pChunks = new ChunkLexer(*this, minChunkBytes);
+  chunkLines = 0;
+  if(!pChunks->lex())
+  {
+    delete pChunks;
+    pChunks = 0;
+  }
+}
 //----< peek function that works with multiple putbacks >------
 
 int Toker::peek()
 {
   if(putbacks.size() > 0)
     return putbacks[putbacks.size()-1];
-  else
-    return pIn->peek();
-
+  if(fromBuffer)
+  {
+    if(pNext == pEnd)
+    {
+      bufferEof = true;
+      return EOF;
+    }
+#ifdef _WIN32
+    // text mode streams read "\r\n" as "\n"
+    if(*pNext == '\r' && pNext + 1 != pEnd && pNext[1] == '\n')
+      return '\n';
+#endif
+    return (unsigned char)*pNext;
+  }
+  return pIn->peek();
 }
 //----< multiple putBack that won't break peek >---------------
 
@@ -126,8 +235,29 @@ int Toker::get()
     putbacks.pop_back();
     return ch;
   }
+  if(fromBuffer)
+  {
+    if(pNext == pEnd)
+    {
+      bufferEof = true;
+      return EOF;
+    }
+#ifdef _WIN32
+    if(*pNext == '\r' && pNext + 1 != pEnd && pNext[1] == '\n')
+      ++pNext;
+#endif
+    return (unsigned char)*pNext++;
+  }
   return pIn->get();
 }
+//----< is attached source still readable? >-------------------
+
+bool Toker::inputGood()
+{
+  if(fromBuffer)
+    return !bufferEof;
+  return pIn->good();
+}
 //
 //----< extract character from attached stream >---------------
 
@@ -145,15 +275,44 @@ bool Toker::getChar()
     ++braceCount;
   if(currChar == '}' && _state == default_state)
     --braceCount;
+  if(fromBuffer)
+    return !bufferEof;
   return !pIn->eof();
 }
+//----< can characters be consumed straight from buffer? >----
+
+bool Toker::canSkip()
+{
+  return doFastScan && fromBuffer && putbacks.size() == 0 && pNext != pEnd;
+}
+//----< consume count chars from buffer, as getChar would >----
+//
+//  Caller guarantees that [pNext, pNext+count) holds no '\r', so
+//  no "\r\n" translation is needed.
+
+void Toker::skip(size_t count)
+{
+  const char* pLast = pNext + count;
+  if(count >= 3)
+    prevprevChar = pLast[-3];
+  else
+    prevprevChar = (count == 2) ? currChar : prevChar;
+  prevChar = (count >= 2) ? pLast[-2] : currChar;
+  currChar = pLast[-1];
+  numLines += (int)ScanKernel::count(pNext, pLast, '\n');
+  if(_state == default_state)
+  {
+    braceCount += (int)ScanKernel::count(pNext, pLast, '{');
+    braceCount -= (int)ScanKernel::count(pNext, pLast, '}');
+  }
+  pNext = pLast;
+  nextChar = this->peek();
+}
 //----< is this char a single char token? >--------------------
 
 bool Toker::isSingleCharTok(char ch)
 {
-  if(scTok.find(ch) < scTok.length())
-    return true;
-  return false;
+  return (classes[ch] & CharClasses::singleChar) != 0;
 }
 //----< remove contiguous white space except for newline >-----
 
@@ -161,8 +320,17 @@ void Toker::stripWhiteSpace()
 {
   if(nextChar == '\n')
     return;
-  while(isspace(nextChar) && nextChar != '\n')
+  while((classes[nextChar] & CharClasses::space) && nextChar != '\n')
   {
+    if(canSkip() && classes.matchesScanKernel())
+    {
+      size_t count = ScanKernel::skipBlanks(pNext, pEnd) - pNext;
+      if(count > 0)
+      {
+        skip(count);
+        continue;
+      }
+    }
     getChar();
   }
 }
@@ -170,21 +338,19 @@ void Toker::stripWhiteSpace()
 
 bool Toker::isIdentifierChar(char ch)
 {
-  if(isalpha(ch) || ch == '_' || isdigit(ch))
-    return true;
-  return false;
+  return (classes[ch] & CharClasses::ident) != 0;
 }
 //----< is this the end of a token? >--------------------------
 
 bool Toker::isTokEnd()
 {
-  if(isspace(nextChar))
-    return true;
-  if(isSingleCharTok(nextChar) || isSingleCharTok(currChar))
+  unsigned char next = classes[nextChar];
+  unsigned char curr = classes[currChar];
+  if(next & CharClasses::space)
     return true;
-  if(isIdentifierChar(currChar) && !isIdentifierChar(nextChar))
+  if((next | curr) & CharClasses::singleChar)
     return true;
-  if(!isIdentifierChar(currChar) && isIdentifierChar(nextChar))
+  if((next & CharClasses::ident) != (curr & CharClasses::ident))  // entering or leaving identifier
     return true;
   if(isFileEnd())
     return true;
@@ -216,14 +382,26 @@ bool Toker::isEndComment()
     return true;
   return false;
 }
-//----< return comment as a token >----------------------------
+//----< append comment to token >------------------------------
 
-std::string Toker::eatComment()
+void Toker::eatComment(std::string& tok)
 {
   _state = comment_state;
-  std::string tok(1,currChar);
-  while(!isEndComment() && pIn->good())
+  tok.assign(1,currChar);
+  while(!isEndComment() && inputGood())
   {
+    // a comment can't end before the next newline, or the next '*'
+    if(canSkip())
+    {
+      const char* pStop = ScanKernel::findFirstOf(pNext, pEnd,
+        aCppComment ? '\n' : '*', '\r', '\r');
+      if(pStop != pNext)
+      {
+        tok.append(pNext, pStop - pNext);
+        skip(pStop - pNext);
+        continue;
+      }
+    }
     getChar();
     tok.append(1,currChar);
   }
@@ -234,7 +412,6 @@ std::string Toker::eatComment()
     tok.append(1,currChar);
   }
   _state = default_state;
-  return tok;
 }
 //----< is this the beginning of a quote? >--------------------
 
@@ -281,70 +458,154 @@ bool Toker::isEndQuote()
   }
   return false;
 }
-//----< return single or double quote as token >---------------
+//----< append single or double quote to token >---------------
 
-std::string Toker::eatQuote()
+void Toker::eatQuote(std::string& tok)
 {
   _state = quote_state;
-  std::string tok(1,currChar);
+  tok.assign(1,currChar);
   while(!isEndQuote())
   {
+    // a chunk may end inside a quote, where the serial scan would
+    // be waiting for the close quote
+    if(chunkWorker && !inputGood())
+    {
+      workerBailed = true;
+      break;
+    }
+    // quote can't end before the next quote char, escapes are scanned singly
+    if(canSkip())
+    {
+      const char* pStop = ScanKernel::findFirstOf(pNext, pEnd,
+        aSingleQuote ? '\'' : '\"', '\\', '\r');
+      if(pStop != pNext)
+      {
+        tok.append(pNext, pStop - pNext);
+        skip(pStop - pNext);
+        continue;
+      }
+    }
     getChar();
     tok.append(1,currChar);
   }
   getChar();
   tok.append(1,currChar);
   _state = default_state;
-  return tok;
 }
 //----< read token from attached file >------------------------
 
 std::string Toker::getTok()
 {
-  std::string tok = "";
+  if(pChunks)
+    return chunkTok().str();
+  scanTok(tokBuf);
+  return tokBuf;
+}
+//----< read token, returned as view of source if possible >---
+
+StrView Toker::getTokView()
+{
+  if(pChunks)
+    return chunkTok();
+  scanTok(tokBuf);
+  return sourceView(tokBuf);
+}
+//----< next stitched token of a file lexed in chunks >--------
+
+StrView Toker::chunkTok()
+{
+  ChunkLexer::Tok tok;
+  if(!pChunks->next(tok))
+  {
+    // at end of file the serial scan returns empty tokens
+    tokBuf.clear();
+    return StrView();
+  }
+  numLines += tok.lines - chunkLines;
+  chunkLines = tok.lines;
+  braceCount = tok.braces;
+  nextChar = tok.nextChar;
+  if(tok.inSource)
+    return tok.text;
+  tokBuf.assign(tok.text.data(), tok.text.length());
+  return StrView(tokBuf);
+}
+//----< find token's characters in mapped source >-------------
+
+StrView Toker::sourceView(const std::string& tok)
+{
+  if(tok.length() == 0)
+    return StrView();
+  if(fromBuffer)
+  {
+    // token ends just before any characters that were put back
+    size_t unread = putbacks.size();
+    if((size_t)(pNext - pBegin) >= tok.length() + unread)
+    {
+      const char* pTok = pNext - unread - tok.length();
+      if(memcmp(pTok, tok.data(), tok.length()) == 0)
+        return StrView(pTok, tok.length());
+    }
+  }
+  return StrView(tok);
+}
+//----< scan next token into tok >-----------------------------
+
+void Toker::scanTok(std::string& tok)
+{
+  tok.clear();
   stripWhiteSpace();
   if(isSingleCharTok(nextChar))
   {
     getChar();
     tok.append(1,currChar);
-    return tok;
+    return;
   }
   do
   {
     if(isFileEnd())
-      return tok;
+      return;
 
     getChar();
-    if(isBeginComment())
+    unsigned char curr = classes[currChar];
+    if((curr & CharClasses::commentStart) && isBeginComment())
     {
       if(tok.length() > 0)
       {
         this->putback(currChar);
-        return tok;
+        return;
       }
-      tok = eatComment();
+      eatComment(tok);
       if(doReturnComments)
-        return tok;
+        return;
       else
       {
-        tok = "";
+        tok.clear();
         continue;
       }
     }
-    if(isBeginQuote())
+    if((curr & CharClasses::quoteStart) && isBeginQuote())
     {
       if(tok.length() > 0)
       {
         this->putback(currChar);
-        return tok;
+        return;
       }
-      tok = eatQuote();
-      return tok;
+      eatQuote(tok);
+      return;
     }
-    if(!isspace(currChar))
+    if(!(curr & CharClasses::space))
       tok.append(1,currChar);
+    if((curr & CharClasses::ident) && canSkip() && classes.matchesScanKernel())
+    {
+      size_t count = ScanKernel::skipIdent(pNext, pEnd) - pNext;
+      if(count > 0)
+      {
+        tok.append(pNext, count);
+        skip(count);
+      }
+    }
   }  while(!isTokEnd() || tok.length() == 0);
-  return tok;
 }
 //----< test stub >--------------------------------------------
 
@@ -409,6 +670,87 @@ int main(int argc, char* argv[])
         else
           std::cout << "newline\n";
       } while(temp != "");
+
+      // mapped views must return the same tokens, lines, and brace levels
+
+      Toker streamed, mapped;
+      mapped.mapInput();
+      streamed.returnComments();
+      mapped.returnComments();
+      if(streamed.attach(argv[i]) && mapped.attach(argv[i]))
+      {
+        size_t numToks = 0, numCopied = 0;
+        bool same = true;
+        do
+        {
+          temp = streamed.getTok();
+          StrView view = mapped.getTokView();
+          ++numToks;
+          if(mapped.isTransient(view))
+            ++numCopied;
+          if(temp != view || streamed.lines() != mapped.lines() ||
+             streamed.braceLevel() != mapped.braceLevel())
+            same = false;
+        } while(same && temp != "");
+        std::cout << "\n  mapped input " << (same ? "matches" : "differs from")
+                  << " stream input after " << numToks << " tokens, "
+                  << numCopied << " not viewed in source\n";
+      }
+
+      // bulk scans, at each level, must match the one-at-a-time scan
+
+      for(int lvl=ScanKernel::scalar; lvl<=ScanKernel::supportedLevel(); ++lvl)
+      {
+        ScanKernel::setLevel((ScanKernel::Level)lvl);
+        Toker single, bulk;
+        single.mapInput();
+        single.fastScan(false);
+        bulk.mapInput();
+        single.returnComments();
+        bulk.returnComments();
+        if(!single.attach(argv[i]) || !bulk.attach(argv[i]))
+          break;
+        size_t numToks = 0;
+        bool same = true;
+        do
+        {
+          temp = single.getTok();
+          ++numToks;
+          if(temp != bulk.getTokView() || single.lines() != bulk.lines() ||
+             single.braceLevel() != bulk.braceLevel())
+            same = false;
+        } while(same && temp != "");
+        std::cout << "  " << ScanKernel::levelName((ScanKernel::Level)lvl)
+                  << " bulk scan " << (same ? "matches" : "differs from")
+                  << " single char scan after " << numToks << " tokens\n";
+      }
+      ScanKernel::setLevel(ScanKernel::supportedLevel());
+
+      // chunks lexed on worker threads must stitch to the serial scan,
+      // small chunks make sure even small files are split
+
+      Toker serial, chunked;
+      serial.mapInput();
+      chunked.mapInput();
+      chunked.lexInParallel(true, 256);
+      serial.returnComments();
+      chunked.returnComments();
+      if(serial.attach(argv[i]) && chunked.attach(argv[i]))
+      {
+        size_t numToks = 0;
+        bool same = true;
+        do
+        {
+          temp = serial.getTok();
+          ++numToks;
+          if(temp != chunked.getTokView() || serial.lines() != chunked.lines() ||
+             serial.braceLevel() != chunked.braceLevel() ||
+             serial.isFileEnd() != chunked.isFileEnd())
+            same = false;
+        } while(same && temp != "");
+        std::cout << "  chunked scan " << (same ? "matches" : "differs from")
+                  << " serial scan after " << numToks << " tokens\n";
+      }
     }
     catch(std::exception& ex)
     {
@@ -418,3 +760,98 @@ int main(int argc, char* argv[])
 }
 
 #endif
+
+//----< classification benchmark >-----------------------------
+
+#ifdef BENCH_TOKENIZER
+
+#include "Timer.h"
+
+// token end test as written before ver 2.4, kept for comparison
+
+static const std::string legacyScTok = "()[]{};.\n";
+
+static bool legacyIsIdentifierChar(char ch)
+{
+  return isalpha((unsigned char)ch) || ch == '_' || isdigit((unsigned char)ch);
+}
+
+static bool legacyIsTokEnd(char curr, char next)
+{
+  if(isspace((unsigned char)next))
+    return true;
+  if(legacyScTok.find(next) < legacyScTok.length() ||
+     legacyScTok.find(curr) < legacyScTok.length())
+    return true;
+  if(legacyIsIdentifierChar(curr) && !legacyIsIdentifierChar(next))
+    return true;
+  if(!legacyIsIdentifierChar(curr) && legacyIsIdentifierChar(next))
+    return true;
+  return false;
+}
+
+static bool tableIsTokEnd(const CharClasses& classes, char curr, char next)
+{
+  unsigned char n = classes[next];
+  unsigned char c = classes[curr];
+  if(n & CharClasses::space)
+    return true;
+  if((n | c) & CharClasses::singleChar)
+    return true;
+  return (n & CharClasses::ident) != (c & CharClasses::ident);
+}
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Benchmarking Toker character classification\n "
+            << std::string(45,'=') << std::endl;
+  if(argc < 2)
+  {
+    std::cout 
+      << "\n  please enter names of files to process on command line\n\n";
+    return 1;
+  }
+
+  std::string text;
+  for(int i=1; i<argc; ++i)
+  {
+    FileMap fm;
+    if(fm.open(argv[i]))
+      text.append(fm.begin(), fm.end());
+  }
+  if(text.size() < 2)
+  {
+    std::cout << "\n  no text to classify\n\n";
+    return 1;
+  }
+
+  CharClasses classes;
+  classes.build(legacyScTok, true);
+  const int passes = 20;
+  size_t legacyEnds = 0, tableEnds = 0;
+
+  Timer timer;
+  for(int pass=0; pass<passes; ++pass)
+    for(size_t i=1; i<text.size(); ++i)
+      legacyEnds += legacyIsTokEnd(text[i-1], text[i]);
+  double legacyTime = timer.elapsed();
+
+  timer.restart();
+  for(int pass=0; pass<passes; ++pass)
+    for(size_t i=1; i<text.size(); ++i)
+      tableEnds += tableIsTokEnd(classes, text[i-1], text[i]);
+  double tableTime = timer.elapsed();
+
+  double bytes = (double)passes * (text.size() - 1);
+  std::cout << "\n  " << argc - 1 << " files, " << text.size() << " bytes, "
+            << passes << " passes";
+  std::cout << "\n  scTok.find and <cctype>: " << std::setw(7) << std::fixed
+            << std::setprecision(3) << 1.0e9 * legacyTime / bytes << " nsec/byte";
+  std::cout << "\n  class table:             " << std::setw(7)
+            << 1.0e9 * tableTime / bytes << " nsec/byte";
+  std::cout << "\n  token ends found: " << legacyEnds << " and " << tableEnds
+            << (legacyEnds == tableEnds ? ", same" : ", DIFFERENT") << "\n\n";
+  return legacyEnds == tableEnds ? 0 : 1;
+}
+
+#endif
@@ -2,7 +2,7 @@
 #define TOKENIZER_H
 /////////////////////////////////////////////////////////////////////
 //  Tokenizer.h - Reads words from a file                          //
-//  ver 2.1                                                        //
+//  ver 2.6                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -27,6 +27,30 @@
     You can turn off collecting single quoted strings as tokens by calling
     Toker::returnSingleQuotedStringsAsTokens(false).  That is needed if 
     you are parsing text with single quotes, as possessives, for example.
+  - Files are read through a std::ifstream by default.  Calling
+    Toker::mapInput() before attach makes the tokenizer map the whole
+    file read-only and scan its bytes directly.  Sources that can't be
+    mapped, e.g., pipes, are read into a buffer with block reads.
+  - Toker::getTokView() returns a token as a StrView.  With mapped input
+    the view usually refers straight into the source, so no string is
+    built for the caller.  Otherwise it refers to an internal buffer that
+    the next call overwrites; isTransient(view) reports that case.
+  - Characters are classified with a 256 entry table, rebuilt whenever
+    the mode or single char tokens change, rather than by searching the
+    single char token string and calling the locale dependent <cctype>
+    functions for every character.  Bytes above 127 are never white space
+    or identifier characters, as in the "C" locale.
+  - With mapped input, runs of blanks, identifier characters, and comment
+    and quote bodies are skipped in bulk with the vectorized scans in the
+    ScanKernel module.  Lines and brace levels are counted for the skipped
+    bytes, so results are the same as the one-character-at-a-time scan,
+    which Toker::fastScan(false) selects.
+  - Toker::lexInParallel() makes attach split a large mapped file into
+    chunks, lex them on worker threads with the ChunkLexer module, and
+    stitch the tokens back together.  getTok(), lines(), braceLevel(),
+    and isFileEnd() then return what the serial scan would.  Settings
+    must be made before attach, and peek() and putback() don't apply
+    to the stitched tokens.
   A tokenizer is an important part of a scanner, used to read and interpret
   source code or XML.
 
@@ -34,21 +58,56 @@
   =================
   Toker t;                        // create tokenizer instance
   returnComments();               // request comments return as tokens
+  mapInput();                     // scan mapped file instead of stream
+  fastScan(false);                // no bulk scans, e.g., for testing
+  lexInParallel();                // lex large mapped files on threads
   if(t.attach(someFileName))      // select file for tokenizing
     string tok = t.getTok();      // extract first token
+  StrView v = t.getTokView();     // token as view, copy if transient
+  bool copy = t.isTransient(v);   // true if next getTok overwrites v
   int numLines = t.lines();       // return number of lines encountered
   t.lines() = 0;                  // reset line count
 
   Build Process:
   ==============
   Required files
-    - tokenizer.h, tokenizer.cpp
+    - tokenizer.h, tokenizer.cpp, FileMap.h, FileMap.cpp,
+      StrView.h, StrView.cpp, ScanKernel.h, ScanKernel.cpp,
+      ChunkLexer.h, ChunkLexer.cpp
   Build commands (either one)
     - devenv Project1HelpS06.sln
-    - cl /EHsc /DTEST_TOKENIZER tokenizer.cpp /link setargv.obj
+    - cl /EHsc /O2 /DBENCH_TOKENIZER tokenizer.cpp FileMap.cpp StrView.cpp \
+         ScanKernel.cpp ChunkLexer.cpp \
+         /link setargv.obj            (classification benchmark, uses Timer.h)
+    - cl /EHsc /DTEST_TOKENIZER tokenizer.cpp FileMap.cpp StrView.cpp \
+         ScanKernel.cpp ChunkLexer.cpp \
+         /link setargv.obj
 
   Maintenance History:
   ====================
+  ver 2.6 : 16 Oct 26
+  - added lexInParallel(), which has ChunkLexer lex large mapped files
+    in chunks, on worker threads, and replays the stitched tokens
+  - test stub compares tokens from chunked and serial scans
+  ver 2.5 : 16 Oct 26
+  - with mapped input, stripWhiteSpace, eatComment, eatQuote, and the
+    identifier part of getTok skip runs of bytes with ScanKernel scans.
+    Added fastScan(bool) to turn that off.
+  - test stub compares tokens from the bulk and one-at-a-time scans
+  ver 2.4 : 16 Oct 26
+  - replaced scTok.find and isspace/isalpha/isdigit tests with a class
+    table built by setMode, setSingleCharTokens, and
+    returnSingleQuotedStringAsToken
+  - added BENCH_TOKENIZER stub, comparing per byte cost of the old and
+    new classification on files named on the command line
+  ver 2.3 : 16 Oct 26
+  - added getTokView() and isTransient(), which return tokens as views
+    into the mapped source.  getTok() and getTokView() now scan into a
+    reused buffer, and eatComment() and eatQuote() append to it.
+  ver 2.2 : 16 Oct 26
+  - added mapInput(), which scans a mapped (or block-read) copy of the
+    source instead of pulling each character through the istream.
+    getTok(), lines(), and braceLevel() behave as with stream input.
   ver 2.1 : 28 Jan 13
   - fixed bug reported by Sam Savage in Toker::attach.
     re-initialized prevprevChar, prevChar, currChar, nextChar, 
@@ -95,6 +154,28 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include "StrView.h"
+
+class FileMap;
+class ChunkLexer;
+
+///////////////////////////////////////////////////////////////
+// CharClasses: class bits for every byte value, used by Toker
+
+class CharClasses
+{
+public:
+  enum bits { space = 1, ident = 2, singleChar = 4, quoteStart = 8, commentStart = 16 };
+  void build(const std::string& singleCharToks, bool singleQuotes);
+  unsigned char operator[](char ch) const;
+  bool matchesScanKernel() const;
+private:
+  unsigned char table[256];
+  bool kernelMatch;   // ScanKernel blank and identifier scans agree with table
+};
+
+///////////////////////////////////////////////////////////////
+// Toker: returns tokens from an attached file or string
 
 class Toker
 {
@@ -104,10 +185,15 @@ public:
   ~Toker();
   void setMode(mode md);
   void setSingleCharTokens(std::string tokChars);
+  void fastScan(bool doFast=true);
   bool attach(const std::string& filename, bool isFile = true);
   std::string getTok();
+  StrView getTokView();
+  bool isTransient(const StrView& tok);
   void returnComments(bool doReturn = true);
   void returnSingleQuotedStringAsToken(bool doCollect=true);
+  void mapInput(bool doMap=true);
+  void lexInParallel(bool doParallel=true, size_t minChunkBytes=1<<20);
   int& lines();
   int  braceLevel();
   bool isFileEnd();
@@ -116,9 +202,27 @@ public:
   enum state { default_state, comment_state, quote_state };
 
 private:
+  friend class ChunkLexer;      // configures and runs worker Tokers
   std::istream* pIn;
+  FileMap* pMap;
+  bool doMapInput;
+  bool doFastScan;
+  bool fromBuffer;         // scanning [pNext, pEnd) instead of pIn
+  bool bufferEof;          // mirrors eof state of stream input
+  const char* pBegin;
+  const char* pNext;
+  const char* pEnd;
+  std::string srcText;     // buffered copy of string sources
+  std::string tokBuf;      // token scanned by last getTok or getTokView
+  ChunkLexer* pChunks;     // stitched tokens of a file lexed in chunks
+  bool doParallelLex;
+  size_t minChunkBytes;
+  int chunkLines;          // lines() of last stitched token returned
+  bool chunkWorker;        // lexing one chunk for a ChunkLexer
+  bool workerBailed;       // chunk ended inside a quote
   char prevprevChar, prevChar, currChar, nextChar;
   std::string scTok;
+  CharClasses classes;
   std::vector<char> putbacks;
   int numLines;
   int braceCount;
@@ -132,17 +236,25 @@ private:
   // private helper functions
   int  get();
   bool getChar();
+  bool inputGood();
+  void attachBuffer(const char* pBegin, const char* pLast);
   bool isSingleCharTok(char ch);
   bool isTokEnd();
+  bool canSkip();
+  void skip(size_t count);
   void stripWhiteSpace();
   bool isIdentifierChar(char ch);
   bool isBeginComment();
   bool isEndComment();
-  std::string eatComment();
+  void eatComment(std::string& tok);
   bool aSingleQuote;
   bool isBeginQuote();
   bool isEndQuote();
-  std::string eatQuote();
+  void eatQuote(std::string& tok);
+  void scanTok(std::string& tok);
+  StrView sourceView(const std::string& tok);
+  void startChunks();
+  StrView chunkTok();
 
   // prohibit copying and assignment
   Toker(const Toker &tkr);
@@ -154,10 +266,32 @@ inline void Toker::returnComments(bool doReturn)
   doReturnComments = doReturn;
 }
 
+inline void Toker::mapInput(bool doMap) { doMapInput = doMap; }
+
+inline void Toker::fastScan(bool doFast) { doFastScan = doFast; }
+
+inline void Toker::lexInParallel(bool doParallel, size_t minChunk)
+{
+  doParallelLex = doParallel;
+  minChunkBytes = minChunk;
+}
+
 inline bool Toker::isFileEnd() { return (nextChar == -1); }
 
+inline unsigned char CharClasses::operator[](char ch) const
+{
+  return table[(unsigned char)ch];
+}
+
+inline bool CharClasses::matchesScanKernel() const { return kernelMatch; }
+
 inline int& Toker::lines() { return numLines; }
 
 inline int Toker::braceLevel() { return braceCount; }
 
+inline bool Toker::isTransient(const StrView& tok)
+{
+  return tok.length() > 0 && tok.data() == tokBuf.data();
+}
+
 #endif
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////
+// TypeRefs.cpp - type references resolved after parsing     //
+// Ver 1.1                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+
+#include "TypeRefs.h"
+#include "GraphSingleton.h"
+
+//----< reference a pass 2 rule would relate through >---------------
+
+TypeRef::TypeRef(const std::string& relationship_, Match match_)
+	: match(match_), relationship(relationship_), toFile(false), throws(false) {}
+
+//----< name of the type ref relates its file to, or 0 >-------------
+
+const std::string* TypeRefs::typeNamed(const TypeRef& ref, SymbolTable& symbols)
+{
+	const std::string* pType = 0;
+	for(size_t i=0; i<ref.names.size(); ++i)
+	{
+		if(symbols.containsType(ref.names[i]))
+			pType = &ref.names[i];
+		else if(ref.match == TypeRef::allTypes)
+			return 0;
+	}
+	return pType;
+}
+//----< add edges of matching references, false if pass 2 would throw >
+/*
+ *  Names are looked up once, before any edge is added, so a false
+ *  return leaves the graph as it was.
+ */
+bool TypeRefs::resolve(SymbolTable& symbols, size_t& matched) const
+{
+	std::vector<const std::string*> types(refs.size());
+	for(size_t i=0; i<refs.size(); ++i)
+	{
+		types[i] = typeNamed(refs[i], symbols);
+		if(types[i] && refs[i].throws)
+			return false;
+	}
+	GraphSingleton* s = GraphSingleton::getInstance();
+	matched = 0;
+	for(size_t i=0; i<refs.size(); ++i)
+	{
+		const std::string* pType = types[i];
+		if(pType == 0 || refs[i].throws)
+			continue;
+		std::string typeFile = symbols.lookUpFile(*pType, "TBD");
+		if(refs[i].toFile)
+			s->addRelationshipToGraph(typeFile, refs[i].file, refs[i].relationship);
+		else
+			s->addRelationshipToGraph(refs[i].file, typeFile, refs[i].relationship);
+		++matched;
+	}
+	return true;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_TYPEREFS
+
+size_t numEdges()
+{
+	graph& g = GraphSingleton::getInstance()->getGraph();
+	size_t n = 0;
+	for(graph::iterator iter = g.begin(); iter != g.end(); ++iter)
+		n += iter->size();
+	return n;
+}
+
+int main()
+{
+	std::cout << "\n  Testing TypeRefs class\n "
+		<< std::string(24,'=') << std::endl;
+
+	SymbolTable symbols;
+	TypeRefs refs;
+	TypeRef var("variable");
+	var.file = "Executive";
+	var.names.push_back("Parser");
+	refs.add(var);
+	TypeRef param("param", TypeRef::lastType);
+	param.file = "Executive";
+	param.names.push_back("Toker");
+	param.names.push_back("count");
+	refs.add(param);
+	TypeRef base("inherits");
+	base.file = "SemiExpression";
+	base.names.push_back("ITokCollection");
+	base.toFile = true;
+	refs.add(base);
+
+	// types are found after the references to them are recorded
+	symbols.Add("Parser", "TBD", "Parser");
+	symbols.Add("Toker", "TBD", "Tokenizer");
+	symbols.Add("ITokCollection", "TBD", "ITokCollection");
+
+	size_t matched = 0;
+	bool resolved = refs.resolve(symbols, matched);
+	std::cout << "\n  " << refs.size() << " references, "
+		<< (resolved ? "resolved" : "not resolvable");
+	std::cout << "\n  " << matched << " edges added\n\n";
+
+	// a reference where pass 2 would have thrown: no edges are added,
+	// and its table's lookups are counted once
+
+	TypeRefs thrown(refs);
+	TypeRef call("param", TypeRef::lastType);
+	call.file = "Executive";
+	call.names.push_back("Toker");
+	call.throws = true;
+	thrown.add(call);
+	symbols.freeze();
+	symbols.resetLookupCounts();
+	size_t before = numEdges();
+	std::cout << "  with a throwing reference: "
+		<< (thrown.resolve(symbols, matched) ? "resolved" : "not resolvable") << ", "
+		<< numEdges() - before << " edges added, "
+		<< symbols.lookupCounts().lookedUp << " lookups of " << thrown.size() << " references\n\n";
+	graph& g = GraphSingleton::getInstance()->getGraph();
+	for(graph::iterator iter = g.begin(); iter != g.end(); ++iter)
+		for(size_t i=0; i<iter->size(); ++i)
+			std::cout << "  " << iter->value().payload << " " << (*iter)[i].second
+				<< " " << g[(*iter)[i].first].value().payload << "\n";
+	std::cout << "\n";
+}
+
+#endif
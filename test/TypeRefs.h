@@ -0,0 +1,105 @@
+#ifndef TYPEREFS_H
+#define TYPEREFS_H
+///////////////////////////////////////////////////////////////
+// TypeRefs.h - type references resolved after parsing       //
+// Ver 1.1                                                   //
+// Language:    Visual C++ 2012                              //
+// Platform:    Dell E6510, Windows 7                        //
+// Application: CSE687 - OOD, Pr#2, Spring 2013              //
+// Author:      Matt Synborski                               //
+//              matthewsynborski@gmail.com                   //
+///////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+Pass 2 rules can't tell whether a name is a type until pass 1 has
+built the whole symbol table, which is why the executive parses
+every file twice.  This module lets one parse do both: where a pass
+2 action would look a name up in the symbol table, its deferred
+version records a TypeRef instead, holding the candidate names, the
+relationship to add and the file being parsed.  Once all files are
+parsed, TypeRefs::resolve() looks the names up in the complete
+symbol table, once each, and adds the same edges, in the same order, that pass 2
+would have added.
+
+A TypeRef matches when all of its names are types, e.g., the name
+a return type rule tests and the one its action reports, or, for
+lastType references, when any is, and then relates the file to the
+type named last, or to the last name that is a type.  inherits
+references relate the type's file to the file, the others the file
+to the type's file.  A reference marked throws matches where pass 2
+would have thrown, leaving the rest of the file unparsed, so resolve()
+can't stand in for pass 2: it then adds no edges, and returns false.
+
+Public Interface:
+=================
+TypeRefs refs;
+TypeRef ref("variable");           // file uses a variable of type
+ref.file = "Executive";            // file's graph name
+ref.names.push_back("Parser");     // candidate type name
+refs.add(ref);                     // in parse order
+size_t matched;
+if(!refs.resolve(symbols, matched))  // add edges of matching refs,
+  runPass2();                        //   unless pass 2 wouldn't finish
+
+Build Process:
+==============
+Required files
+- TypeRefs.h, TypeRefs.cpp, SymbolTable.h, GraphSingleton.h,
+GraphSingleton.cpp, and the files they require
+Build commands (either one)
+- devenv Submission.sln
+- cl /EHsc /DTEST_TYPEREFS TypeRefs.cpp GraphSingleton.cpp \
+GraphXml.cpp Graph.cpp RelKind.cpp XmlReader.cpp XmlWriter.cpp \
+StrView.cpp
+
+Maintenance History:
+====================
+ver 1.1 : 17 Oct 26
+- resolvable() and resolve() are one call, looking each name up once
+ver 1.0 : 17 Oct 26
+- first release
+*/
+
+#include <string>
+#include <vector>
+#include "SymbolTable.h"
+
+///////////////////////////////////////////////////////////////
+// a relationship waiting for the symbol table
+
+struct TypeRef
+{
+	enum Match { allTypes, lastType };
+
+	TypeRef(const std::string& relationship, Match match = allTypes);
+
+	Match match;
+	std::vector<std::string> names;  // candidate type names, in token order
+	std::string relationship;        // e.g., "variable", "inherits"
+	std::string file;                // file's graph name
+	bool toFile;                     // type's file -> file, as inherits is
+	bool throws;                     // pass 2 would throw on a match
+};
+
+///////////////////////////////////////////////////////////////
+// references of all parsed files, in parse order
+
+class TypeRefs
+{
+public:
+	void add(const TypeRef& ref);
+	size_t size() const;
+	bool resolve(SymbolTable& symbols, size_t& matched) const;
+
+private:
+	static const std::string* typeNamed(const TypeRef& ref, SymbolTable& symbols);
+
+	std::vector<TypeRef> refs;
+};
+
+inline void TypeRefs::add(const TypeRef& ref) { refs.push_back(ref); }
+
+inline size_t TypeRefs::size() const { return refs.size(); }
+
+#endif
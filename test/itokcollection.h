@@ -2,7 +2,7 @@
 #define ITOKCOLLECTION_H
 /////////////////////////////////////////////////////////////////////
 //  ITokCollection.h - package for the ITokCollection interface    //
-//  ver 1.1                                                        //
+//  ver 1.4                                                        //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
 //  Application:   Prototype for CSE687 Pr1, Sp09                  //
@@ -18,23 +18,45 @@
   to this interface.  This is illustrated in the test stubs for the
   SemiExpression and XmlElementParts modules.
 
+  Tokens are handed out as StrViews, so a collection may keep them
+  as views into the scanned source rather than as std::strings.
+  Each token also has a TokId from the TokenPool, so rules can search
+  for tokens, e.g., find(tok_lparen), by comparing integers.
+  summary() returns a TokSummary of the collection, the first and last
+  positions of each punctuator and keyword in it, so those lookups take
+  constant time.  A collection rebuilds its summary only after it changes.
+
   Maintenance History:
   ====================
+  ver 1.4 : 17 Oct 26
+  - added summary()
+  ver 1.3 : 16 Oct 26
+  - added id(n) and find(TokId)
+  ver 1.2 : 16 Oct 26
+  - tokens are passed and returned as StrViews, so operator[] is now
+    read-only
   ver 1.1 : 02 Jun 11
   - added merge, remove overload, and default param in get
   ver 1.0 : 17 Jan 09
   - first release
 */
 
+#include "StrView.h"
+#include "TokenPool.h"
+#include "TokSummary.h"
+
 struct ITokCollection
 {
   virtual bool get(bool clear=true)=0;
   virtual size_t length()=0;
-  virtual std::string& operator[](int n)=0;
-  virtual size_t find(const std::string& tok)=0;
-  virtual void push_back(const std::string& tok)=0;
-  virtual bool merge(const std::string& firstTok, const std::string& secondTok)=0;
-  virtual bool remove(const std::string& tok)=0;
+  virtual StrView operator[](int n)=0;
+  virtual TokId id(int n)=0;
+  virtual size_t find(const StrView& tok)=0;
+  virtual size_t find(TokId id)=0;
+  virtual const TokSummary& summary()=0;
+  virtual void push_back(const StrView& tok)=0;
+  virtual bool merge(const StrView& firstTok, const StrView& secondTok)=0;
+  virtual bool remove(const StrView& tok)=0;
   virtual bool remove(size_t i)=0;
   virtual void toLower()=0;
   virtual void trimFront()=0;